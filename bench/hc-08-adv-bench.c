@@ -0,0 +1,144 @@
+/*
+ * Time to discovery and advertising cost of hc-08-adv against fixed intervals.
+ * One simulated day of a peripheral and one central. After each disconnection the central
+ * looks for the module again, half of the time at once (a dropped link, 0~2 s later) and
+ * half of the time later (a user coming back, 1~60 min later); the first search starts 5 s
+ * after the boot. The central scans 30 ms in every 300 ms, an advertising event inside a
+ * scan window is received with a probability of 0.9, and each event is delayed by 0~10 ms
+ * as in BLE. A connection lasts 1~10 min. The module is hc-08-emu, so the interval in use
+ * is the one AT+AINT really wrote. The charge of an advertising event is taken as 10 uC,
+ * only to turn the event count into a current.
+ *
+ * gcc -O2 -I../lib hc-08-adv-bench.c ../lib/hc-08.c ../lib/hc-08-emu.c ../lib/hc-08-adv.c -o hc-08-adv-bench
+ */
+#include "hc-08.h"
+#include "hc-08-emu.h"
+#include "hc-08-adv.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_DAY_MS        (24 * 3600000ULL)
+#define BENCH_PROCESS_MS    100
+#define BENCH_SCAN_WINDOW   30000ULL   // us
+#define BENCH_SCAN_INTERVAL 300000ULL  // us
+#define BENCH_EPISODES      2048
+#define BENCH_EVENT_UC      10.0
+
+static uint64_t now_us;
+static uint32_t seed;
+static hc_08_emu_ST emu;
+static hc_08_ST hc_08;
+
+static uint32_t bench_tick(void){
+  return (uint32_t)(now_us / 1000);
+}
+
+static uint32_t bench_random(uint32_t range){
+  seed = seed * 1664525UL + 1013904223UL;
+  return (uint32_t)(((uint64_t)(seed >> 8) * range) >> 24);
+}
+
+static int bench_compare(const void *a, const void *b){
+  uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+
+  return (x > y) - (x < y);
+}
+
+typedef struct{
+  uint32_t time[BENCH_EPISODES];
+  uint32_t count;
+}bench_discovery;
+
+static void bench_print_discovery(const char *name, bench_discovery *discovery){
+  if(discovery->count == 0){
+    return;
+  }
+  qsort(discovery->time, discovery->count, sizeof(discovery->time[0]), bench_compare);
+  printf("  %-10s %4u, median %6.2f s, p95 %6.2f s, max %6.2f s\n", name, discovery->count,
+         discovery->time[discovery->count / 2] / 1000.0,
+         discovery->time[discovery->count * 95 / 100] / 1000.0,
+         discovery->time[discovery->count - 1] / 1000.0);
+}
+
+/**
+  * @brief  One simulated day
+  * @param  fast, slow intervals of hc-08-adv, equal for a fixed interval
+  */
+static void bench_run(const char *name, uint16_t fast, uint16_t slow){
+  static bench_discovery again, later;
+  hc_08_adv_ST adv;
+  uint64_t event_us = 0, search_us = 5000000, disconnect_us = 0, process_us = 0, scan_phase_us;
+  uint64_t not_connected_us = 0, last_us = 0;
+  uint32_t events = 0;
+  uint8_t immediate = 1;
+
+  seed = 1;
+  now_us = 0;
+  again.count = later.count = 0;
+  hc_08_emu_init(&emu);
+  hc_08_emu_attach(&emu, &hc_08);
+  hc_08_reg_tick_cbfunc(&hc_08, bench_tick);
+  hc_08.status_connect = hc_08_status_not_connected;
+  hc_08_adv_init(&adv, &hc_08, fast, slow);
+  scan_phase_us = bench_random(BENCH_SCAN_INTERVAL);
+
+  while(now_us < BENCH_DAY_MS * 1000){
+    uint8_t connected = hc_08.status_connect == hc_08_status_connected;
+    uint64_t next_us = process_us;
+
+    if(connected && disconnect_us < next_us){
+      next_us = disconnect_us;
+    }else if(!connected && event_us < next_us){
+      next_us = event_us;
+    }
+    if(!connected){
+      not_connected_us += next_us - last_us;
+    }
+    now_us = last_us = next_us;
+
+    if(now_us == process_us){
+      hc_08_adv_process(&adv);
+      process_us += BENCH_PROCESS_MS * 1000;
+    }else if(connected){
+      // disconnection: the central searches again at once or much later
+      hc_08.status_connect = hc_08_status_not_connected;
+      immediate = bench_random(2);
+      search_us = now_us + (immediate ? bench_random(2000) : 60000 + bench_random(3540000)) * 1000ULL;
+      scan_phase_us = bench_random(BENCH_SCAN_INTERVAL);
+      event_us = now_us;
+      hc_08_adv_process(&adv);
+    }else{
+      events++;
+      event_us = now_us + (uint64_t)emu.param.aint * 625 + bench_random(10000);
+      if(now_us >= search_us && (now_us + scan_phase_us) % BENCH_SCAN_INTERVAL < BENCH_SCAN_WINDOW &&
+          bench_random(10) < 9){
+        bench_discovery *discovery = immediate ? &again : &later;
+
+        if(discovery->count < BENCH_EPISODES){
+          discovery->time[discovery->count++] = (uint32_t)((now_us - search_us) / 1000);
+        }
+        hc_08.status_connect = hc_08_status_connected;
+        disconnect_us = now_us + (60000 + bench_random(540000)) * 1000ULL;
+        hc_08_adv_process(&adv);
+      }
+    }
+  }
+
+  printf("%s\n", name);
+  bench_print_discovery("again", &again);
+  bench_print_discovery("later", &later);
+  printf("  advertising %5.1f h, %7u events, %6.1f uA while advertising (%u AT+AINT)\n",
+         not_connected_us / 3.6e9, events, events * BENCH_EVENT_UC / (not_connected_us / 1e6),
+         adv.metrics.writes);
+}
+
+int main(void){
+  char name[64];
+
+  bench_run("fixed 20 ms", 32, 32);
+  bench_run("fixed 1 s", 1600, 1600);
+  snprintf(name, sizeof(name), "hc-08-adv 20 ms -> 1 s (%u s burst, x%u.%02u every %u s)",
+           HC_08_ADV_BURST / 1000, HC_08_ADV_GROWTH / 100, HC_08_ADV_GROWTH % 100, HC_08_ADV_STEP / 1000);
+  bench_run(name, 32, 1600);
+  return 0;
+}
@@ -0,0 +1,64 @@
+/*
+ * Broadcast update rate of hc-08-avda against the emulator. A sensor produces a sample
+ * every millisecond (about a third of them repeat the previous value); the publisher is
+ * processed in the same loop. Time is the virtual clock of the emulator, so the UART and
+ * firmware cost of every AT+AVDA is accounted for. Printed per advertising interval:
+ * samples submitted, updates sent, unchanged and replaced samples and updates per second.
+ *
+ * gcc -O2 -I../lib hc-08-avda-bench.c ../lib/hc-08.c ../lib/hc-08-emu.c ../lib/hc-08-avda.c -o hc-08-avda-bench
+ */
+#include "hc-08.h"
+#include "hc-08-emu.h"
+#include "hc-08-avda.h"
+#include <stdio.h>
+
+#define BENCH_SECONDS   10
+
+static hc_08_emu_ST emu;
+static uint64_t idle_us;
+
+static uint32_t bench_tick(void){
+  return (uint32_t)((emu.time_us + idle_us) / 1000);
+}
+
+int main(void){
+  static const uint16_t aint[] = {32, 48, 80, 160, 320, 800};
+
+  printf("%6s %9s %10s %8s %10s %10s %9s\n", "aint", "aint ms", "submitted", "sent", "unchanged", "replaced", "updates/s");
+  for(uint8_t i = 0; i < sizeof(aint) / sizeof(aint[0]); i++){
+    hc_08_ST hc_08 = {0};
+    hc_08_avda_ST avda;
+    uint8_t sample[4] = {0};
+    uint32_t last_ms = 0;
+
+    hc_08_emu_init(&emu);
+    idle_us = 0;
+    emu.param.baud = hc_08_baud_115200bps;
+    emu.param.aint = aint[i];
+    hc_08_emu_attach(&emu, &hc_08);
+    hc_08_reg_tick_cbfunc(&hc_08, bench_tick);
+    hc_08.status_connect = hc_08_status_not_connected;
+    hc_08.param.aint = aint[i];
+    hc_08_avda_init(&avda, &hc_08);
+    avda.cfg.interval = 0;
+
+    while(bench_tick() < BENCH_SECONDS * 1000){
+      uint32_t now = bench_tick();
+
+      // one sample per millisecond of virtual time, the counter moves two times in three
+      for(; last_ms < now; last_ms++){
+        if(last_ms % 3 != 0){
+          sample[3]++;
+        }
+        hc_08_avda_submit(&avda, sample, sizeof(sample));
+      }
+      hc_08_avda_process(&avda);
+      if(bench_tick() == now){
+        idle_us += 100;
+      }
+    }
+    printf("%6u %9.1f %10u %8u %10u %10u %9u\n", aint[i], aint[i] * 0.625, avda.metrics.submitted,
+           avda.metrics.published, avda.metrics.unchanged, avda.metrics.replaced, avda.metrics.rate);
+  }
+  return 0;
+}
@@ -0,0 +1,126 @@
+/*
+ * Wakeups of a sleeping module (hc_08_mode_level_1) with and without hc-08-batch.
+ * One simulated hour of two traffic patterns: a periodic sensor (12 bytes every 200 ms)
+ * and bursty events (1 to 8 records of 12 bytes every 1 to 20 s). Without batching every
+ * write wakes the module. Printed per threshold and deadline: wakeups per hour, bursts,
+ * average and longest delay of a write.
+ *
+ * gcc -O2 -I../lib hc-08-batch-bench.c ../lib/hc-08.c ../lib/hc-08-emu.c ../lib/hc-08-batch.c -o hc-08-batch-bench
+ */
+#include "hc-08.h"
+#include "hc-08-batch.h"
+#include "hc-08-emu.h"
+#include <stdio.h>
+
+#define BENCH_HOUR_MS   3600000UL
+#define BENCH_RECORD    12
+
+static uint32_t now_ms;
+static uint32_t tx_calls;
+
+static uint32_t bench_tick(void){
+  return now_ms;
+}
+
+static void bench_tx(void *ctx, char *buff, uint16_t size){
+  (void)ctx;
+  (void)buff;
+  (void)size;
+  tx_calls++;
+}
+
+static uint16_t bench_rx(void *ctx, char *buff, uint16_t size){
+  (void)ctx;
+  (void)buff;
+  (void)size;
+  return 0;
+}
+
+static uint32_t bench_random(uint32_t *seed){
+  *seed = *seed * 1103515245UL + 12345;
+  return (*seed >> 16) & 0x7fff;
+}
+
+/**
+  * @brief  Running one hour of a traffic pattern
+  * @param  bursty 0 for the periodic sensor, 1 for the events
+  * @param  threshold flush threshold in bytes, 0 to write straight to the UART
+  * @param  deadline flush deadline in ms
+  */
+static void bench_run(uint8_t bursty, uint16_t threshold, uint32_t deadline){
+  static char storage[0x100];
+  static hc_08_emu_ST emu;
+  hc_08_ST hc_08 = {0};
+  hc_08_batch_ST batch;
+  char record[BENCH_RECORD] = {0};
+  uint32_t seed = 1;
+  uint32_t next_ms = 0;
+  uint32_t writes = 0;
+
+  now_ms = 0;
+  tx_calls = 0;
+  hc_08_reg_tick_cbfunc(&hc_08, bench_tick);
+  hc_08_status_connect_set(&hc_08, hc_08_status_not_connected);
+  // the module is put to sleep through the library, hc_08_batch_init reads the mode back
+  hc_08_emu_init(&emu);
+  hc_08_emu_attach(&emu, &hc_08);
+  hc_08_cmd_set_mode(&hc_08, hc_08_mode_level_1);
+  hc_08_read_answer(&hc_08);
+  hc_08_batch_init(&batch, &hc_08, storage, sizeof(storage));
+  if(!(hc_08.param_valid & (1UL << hc_08_field_mode)) || hc_08.param.mode != hc_08_mode_level_1){
+    printf("the mode was not read back\n");
+    return;
+  }
+  hc_08_reg_uart_cbfunc_ctx(&hc_08, bench_tx, bench_rx, NULL);
+  batch.cfg.threshold = threshold;
+  batch.cfg.deadline = deadline;
+
+  for(; now_ms < BENCH_HOUR_MS; now_ms++){
+    if(now_ms == next_ms){
+      uint32_t count = bursty ? 1 + bench_random(&seed) % 8 : 1;
+
+      for(uint32_t i = 0; i < count; i++){
+        record[0]++;
+        writes++;
+        if(threshold == 0){
+          hc_08_uart_tx(&hc_08, record, sizeof(record));
+        }else{
+          hc_08_batch_write(&batch, record, sizeof(record));
+        }
+      }
+      next_ms += bursty ? 1000 + bench_random(&seed) % 19000 : 200;
+    }
+    if(threshold != 0){
+      hc_08_batch_process(&batch);
+    }
+  }
+
+  if(threshold == 0){
+    printf("%-9s %9s %9s %12u %8u %10.1f %10u\n", bursty ? "events" : "periodic", "-", "-",
+           tx_calls, tx_calls, 0.0, 0);
+    return;
+  }
+  printf("%-9s %9u %9u %12u %8u %10u %10u\n", bursty ? "events" : "periodic", threshold, deadline,
+         hc_08_batch_wakeups_per_hour(&batch), batch.metrics.flushes, batch.metrics.delay_avg,
+         batch.metrics.delay_max);
+  if(batch.metrics.writes != writes || batch.metrics.overflows != 0){
+    printf("  %u of %u writes accepted, %u overflows\n", batch.metrics.writes, writes, batch.metrics.overflows);
+  }
+}
+
+int main(void){
+  static const uint16_t threshold[] = {48, 96, 192};
+  static const uint32_t deadline[] = {500, 1000, 5000};
+
+  printf("%-9s %9s %9s %12s %8s %10s %10s\n", "traffic", "threshold", "deadline", "wakeups/h", "bursts",
+         "delay avg", "delay max");
+  for(uint8_t bursty = 0; bursty < 2; bursty++){
+    bench_run(bursty, 0, 0);
+    for(uint8_t t = 0; t < sizeof(threshold) / sizeof(threshold[0]); t++){
+      for(uint8_t d = 0; d < sizeof(deadline) / sizeof(deadline[0]); d++){
+        bench_run(bursty, threshold[t], deadline[d]);
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * Cost of the numeric decoders used by the parsers compared with sscanf, on the
+ * strings the module actually sends: an address "3C,E4,B0,89,DC,03", a decimal
+ * value "320" and a UUID "FFF0". Cycles are read with rdtsc on x86, elsewhere
+ * only nanoseconds are printed.
+ *
+ * gcc -O2 -I../lib hc-08-decode-bench.c ../lib/hc-08.c -o hc-08-decode-bench
+ * ./hc-08-decode-bench [iterations]
+ */
+#define _POSIX_C_SOURCE 199309L
+#include "hc-08.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_CYCLES() __rdtsc()
+#else
+#define BENCH_CYCLES() 0
+#endif
+
+#define BENCH_SAMPLES   8
+
+static const char *addres_text[BENCH_SAMPLES] = {
+  "3C,E4,B0,89,DC,03", "A4,C1,38,00,00,01", "00,11,22,33,44,55", "FF,EE,DD,CC,BB,AA",
+  "12,34,56,78,9A,BC", "DE,AD,BE,EF,00,01", "01,02,03,04,05,06", "C0,FF,EE,C0,FF,EE"
+};
+static const char *dec_text[BENCH_SAMPLES] = {"320", "6", "12", "200", "1600", "32", "65535", "80"};
+static const char *hex_text[BENCH_SAMPLES] = {"FFF0", "FFE0", "FFE1", "1234", "ABCD", "0000", "00EF", "C0DE"};
+
+static volatile uint32_t sink;
+
+typedef struct{
+  double ns;
+  double cycles;
+}bench_result;
+
+static uint64_t bench_ns(void){
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+#define BENCH_RUN(result, iterations, body)                               \
+  do{                                                                     \
+    uint64_t start_ns = bench_ns();                                       \
+    uint64_t start_cycles = BENCH_CYCLES();                               \
+    for(uint32_t it = 0; it < (iterations); it++){                        \
+      uint32_t i = it % BENCH_SAMPLES;                                    \
+      body                                                                \
+    }                                                                     \
+    (result).cycles = (double)(BENCH_CYCLES() - start_cycles) / (iterations); \
+    (result).ns = (double)(bench_ns() - start_ns) / (iterations);          \
+  }while(0)
+
+static void bench_print(const char *name, bench_result scanf_result, bench_result decode_result){
+  printf("%-8s sscanf %8.1f ns %8.1f cycles   decoder %8.1f ns %8.1f cycles   x%.1f\n", name,
+         scanf_result.ns, scanf_result.cycles, decode_result.ns, decode_result.cycles,
+         decode_result.ns > 0 ? scanf_result.ns / decode_result.ns : 0.0);
+}
+
+int main(int argc, char **argv){
+  uint32_t iterations = argc > 1 ? (uint32_t)atoi(argv[1]) : 2000000;
+  size_t addres_size[BENCH_SAMPLES], dec_size[BENCH_SAMPLES], hex_size[BENCH_SAMPLES];
+  bench_result scanf_result, decode_result;
+
+  for(uint32_t i = 0; i < BENCH_SAMPLES; i++){
+    addres_size[i] = strlen(addres_text[i]);
+    dec_size[i] = strlen(dec_text[i]);
+    hex_size[i] = strlen(hex_text[i]);
+  }
+
+  BENCH_RUN(scanf_result, iterations, {
+    unsigned char a[6];
+    sscanf(addres_text[i], "%2hhx,%2hhx,%2hhx,%2hhx,%2hhx,%2hhx", &a[0], &a[1], &a[2], &a[3], &a[4], &a[5]);
+    sink += a[0] + a[5];
+  });
+  BENCH_RUN(decode_result, iterations, {
+    uint8_t a[6];
+    hc_08_decode_addres(addres_text[i], (uint16_t)addres_size[i], a);
+    sink += a[0] + a[5];
+  });
+  bench_print("address", scanf_result, decode_result);
+
+  BENCH_RUN(scanf_result, iterations, {
+    unsigned short v;
+    sscanf(dec_text[i], "%hu", &v);
+    sink += v;
+  });
+  BENCH_RUN(decode_result, iterations, {
+    uint16_t v;
+    hc_08_decode_dec(dec_text[i], (uint16_t)dec_size[i], &v);
+    sink += v;
+  });
+  bench_print("decimal", scanf_result, decode_result);
+
+  BENCH_RUN(scanf_result, iterations, {
+    unsigned short v;
+    sscanf(hex_text[i], "%hx", &v);
+    sink += v;
+  });
+  BENCH_RUN(decode_result, iterations, {
+    uint16_t v;
+    hc_08_decode_hex(hex_text[i], (uint16_t)hex_size[i], &v);
+    sink += v;
+  });
+  bench_print("hex", scanf_result, decode_result);
+
+  return 0;
+}
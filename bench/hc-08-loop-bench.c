@@ -0,0 +1,208 @@
+/*
+ * Scaling of the epoll event loop from 1 to 512 emulated modules.
+ * Every module is a socketpair: one end is served by an emulator thread, the other end
+ * is driven by hc-08-loop, which keeps one AT+CINT=? query in flight per module.
+ * Reports loop CPU time per module and answer latency percentiles. An answer ends after
+ * loop.rx_idle of silence, set to 1 ms here, which is included in the latency.
+ *
+ * gcc -O2 -I../lib hc-08-loop-bench.c ../lib/hc-08.c ../lib/hc-08-emu.c ../lib/hc-08-loop.c -lpthread -o hc-08-loop-bench
+ * ./hc-08-loop-bench [seconds per step] [shards]
+ */
+#define _GNU_SOURCE
+#include "hc-08.h"
+#include "hc-08-emu.h"
+#include "hc-08-loop.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+
+#define BENCH_MAX_MODULES   512
+#define BENCH_MAX_SHARDS    16
+#define BENCH_MAX_SAMPLES   (1 << 22)
+
+typedef struct{
+  hc_08_ST hc_08;
+  hc_08_loop_node_ST node;
+  hc_08_emu_ST emu;
+  int fd[2];
+  uint64_t sent_ns;
+  struct bench_shard *shard;
+}bench_module;
+
+typedef struct bench_shard{
+  hc_08_loop_ST loop;
+  pthread_t thread;
+  uint64_t cpu_ns;
+  uint32_t *latency_us;
+  uint32_t samples;
+  volatile int *stop;
+}bench_shard;
+
+static bench_module modules[BENCH_MAX_MODULES];
+static volatile int emu_stop;
+
+static uint64_t bench_ns(clockid_t clock){
+  struct timespec ts;
+
+  clock_gettime(clock, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void bench_tx(void *ctx, char *buff, uint16_t size){
+  if(write(*(int *)ctx, buff, size) != size){
+    perror("write");
+  }
+}
+
+static uint16_t bench_rx(void *ctx, char *buff, uint16_t size){
+  (void)ctx; (void)buff; (void)size;
+  return 0;
+}
+
+static void bench_send(bench_module *m){
+  m->sent_ns = bench_ns(CLOCK_MONOTONIC);
+  hc_08_cmd_ask_cint_min_max(&m->hc_08);
+  hc_08_loop_expect(&m->shard->loop, &m->node, hc_08_parse_cint, 1000);
+}
+
+static void bench_callback(hc_08_loop_node_ST *node, hc_08_loop_event event, hc_08_status status, void *ctx){
+  bench_module *m = (bench_module *)ctx;
+  bench_shard *shard = m->shard;
+
+  (void)node;
+  if(event == hc_08_loop_event_answer && status == hc_08_status_ok && shard->samples < BENCH_MAX_SAMPLES){
+    shard->latency_us[shard->samples++] = (uint32_t)((bench_ns(CLOCK_MONOTONIC) - m->sent_ns) / 1000);
+  }
+  if(event != hc_08_loop_event_closed && !*shard->stop){
+    bench_send(m);
+  }
+}
+
+/* emulated modules: read a command, answer it */
+static void *bench_emu_thread(void *arg){
+  int count = *(int *)arg;
+  int epfd = epoll_create1(0);
+  struct epoll_event events[64];
+
+  for(int i = 0; i < count; i++){
+    struct epoll_event ev = {.events = EPOLLIN, .data.ptr = &modules[i]};
+    epoll_ctl(epfd, EPOLL_CTL_ADD, modules[i].fd[1], &ev);
+  }
+  while(!emu_stop){
+    int n = epoll_wait(epfd, events, 64, 50);
+    for(int i = 0; i < n; i++){
+      bench_module *m = events[i].data.ptr;
+      char buff[HC_08_EMU_REPLY_SIZE];
+      ssize_t size = read(m->fd[1], buff, sizeof(buff));
+
+      if(size > 0){
+        hc_08_emu_tx(&m->emu, buff, (uint16_t)size);
+        size = hc_08_emu_rx(&m->emu, buff, sizeof(buff));
+        if(write(m->fd[1], buff, size) != size){
+          perror("write");
+        }
+      }
+    }
+  }
+  close(epfd);
+  return NULL;
+}
+
+static void *bench_shard_thread(void *arg){
+  bench_shard *shard = arg;
+  uint64_t start = bench_ns(CLOCK_THREAD_CPUTIME_ID);
+
+  while(!*shard->stop){
+    hc_08_loop_run_once(&shard->loop, 10);
+  }
+  shard->cpu_ns = bench_ns(CLOCK_THREAD_CPUTIME_ID) - start;
+  return NULL;
+}
+
+static int bench_cmp(const void *a, const void *b){
+  uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+int main(int argc, char **argv){
+  double seconds = argc > 1 ? atof(argv[1]) : 1.0;
+  int shards = argc > 2 ? atoi(argv[2]) : 1;
+  static bench_shard shard[BENCH_MAX_SHARDS];
+  uint32_t *all;
+
+  if(shards < 1 || shards > BENCH_MAX_SHARDS){
+    shards = 1;
+  }
+  all = malloc(sizeof(uint32_t) * BENCH_MAX_SAMPLES * shards);   // every shard keeps up to BENCH_MAX_SAMPLES
+  printf("%8s %12s %14s %10s %10s %10s %10s\n", "modules", "answers/s", "cpu us/module", "p50 us", "p99 us", "p99.9 us", "max us");
+
+  for(int count = 1; count <= BENCH_MAX_MODULES; count *= 2){
+    volatile int stop = 0;
+    pthread_t emu_thread;
+    uint32_t total = 0;
+    uint64_t cpu_ns = 0;
+
+    for(int s = 0; s < shards; s++){
+      hc_08_loop_init(&shard[s].loop, BENCH_MAX_MODULES);
+      shard[s].loop.rx_idle = 1;    // the emulator writes each answer whole
+      shard[s].latency_us = malloc(sizeof(uint32_t) * BENCH_MAX_SAMPLES);
+      shard[s].samples = 0;
+      shard[s].stop = &stop;
+    }
+    for(int i = 0; i < count; i++){
+      bench_module *m = &modules[i];
+
+      memset(&m->hc_08, 0, sizeof(m->hc_08));
+      socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, m->fd);
+      hc_08_emu_init(&m->emu);
+      hc_08_reg_uart_cbfunc_ctx(&m->hc_08, bench_tx, bench_rx, &m->fd[0]);
+      m->shard = &shard[i % shards];
+      hc_08_loop_add(&m->shard->loop, &m->node, &m->hc_08, m->fd[0], bench_callback, m);
+    }
+
+    emu_stop = 0;
+    pthread_create(&emu_thread, NULL, bench_emu_thread, &count);
+    for(int i = 0; i < count; i++){
+      bench_send(&modules[i]);
+    }
+    for(int s = 0; s < shards; s++){
+      pthread_create(&shard[s].thread, NULL, bench_shard_thread, &shard[s]);
+    }
+    usleep((useconds_t)(seconds * 1e6));
+    stop = 1;
+    for(int s = 0; s < shards; s++){
+      pthread_join(shard[s].thread, NULL);
+    }
+    emu_stop = 1;
+    pthread_join(emu_thread, NULL);
+
+    for(int s = 0; s < shards; s++){
+      memcpy(all + total, shard[s].latency_us, sizeof(uint32_t) * shard[s].samples);
+      total += shard[s].samples;
+      cpu_ns += shard[s].cpu_ns;
+      hc_08_loop_deinit(&shard[s].loop);
+      free(shard[s].latency_us);
+    }
+    qsort(all, total, sizeof(uint32_t), bench_cmp);
+    if(total == 0){
+      total = 1;
+      all[0] = 0;
+    }
+    printf("%8d %12.0f %14.1f %10u %10u %10u %10u\n", count, total / seconds,
+           cpu_ns / 1000.0 / count / seconds, all[total / 2], all[(uint32_t)(total * 0.99)],
+           all[(uint32_t)(total * 0.999)], all[total - 1]);
+
+    for(int i = 0; i < count; i++){
+      close(modules[i].fd[0]);
+      close(modules[i].fd[1]);
+    }
+  }
+  free(all);
+  return 0;
+}
@@ -0,0 +1,296 @@
+/*
+ * Records per second of hc-08-merge, and of one buffer under a global lock sorted in
+ * batches. 256 modules, one record queue of 1024 records each.
+ * merge only: the queues are filled, then merged, from one thread (the heap alone); every
+ * record pushed must come out, or the bench fails.
+ * threads: 4 producer threads (64 modules each) push records stamped with the monotonic
+ * clock while one thread merges them; the locked buffer gets the same records, stamped
+ * under the lock, and its consumer sorts every batch it takes out.
+ * faults: the threads run again, one module only moves its watermark, and one stops for
+ * 2 s in the middle and then sends the readings it kept, stamped from the start of the
+ * stop: the merge waits 0.5 s for it, and those readings are late.
+ * Both check that the output is in time order and count the records out of order.
+ *
+ * gcc -O2 -I../lib hc-08-merge-bench.c ../lib/hc-08.c ../lib/hc-08-merge.c -lpthread -o hc-08-merge-bench
+ * ./hc-08-merge-bench [records per module]
+ */
+#define _POSIX_C_SOURCE 199309L
+#include "hc-08.h"
+#include "hc-08-merge.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+
+#define BENCH_MODULES     256
+#define BENCH_QUEUE       1024
+#define BENCH_PRODUCERS   4
+#define BENCH_BATCH       65536
+#define BENCH_SILENT      7        // module that only moves its watermark
+#define BENCH_STALLED     11       // module that stops for BENCH_STALL_US
+#define BENCH_STALL_US    2000000
+
+static hc_08_merge_queue_ST queues[BENCH_MODULES];
+static hc_08_merge_record_ST *records;
+static uint32_t per_module = 20000;
+static uint8_t faults;
+
+static struct{
+  uint64_t count;
+  uint64_t disorder;
+  uint64_t last;
+  uint64_t late;
+}out;
+
+static uint64_t bench_now_us(void){
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void bench_output(void *ctx, const hc_08_merge_record_ST *record){
+  (void)ctx;
+  out.disorder += record->timestamp_us < out.last;
+  out.last = record->timestamp_us;
+  out.count++;
+}
+
+static void bench_late(void *ctx, const hc_08_merge_record_ST *record){
+  (void)ctx;
+  (void)record;
+  out.late++;
+}
+
+static void bench_queues(hc_08_merge_ST *merge){
+  for(uint32_t i = 0; i < BENCH_MODULES; i++){
+    hc_08_merge_queue_init(&queues[i], &records[i * BENCH_QUEUE], BENCH_QUEUE);
+    hc_08_merge_add(merge, &queues[i]);
+  }
+}
+
+/**
+  * @brief  The heap alone: full queues with interleaved timestamps, merged from one thread
+  * @retval 0 if every record pushed came out, 1 if not
+  */
+static int bench_merge_only(void){
+  hc_08_merge_ST merge;
+  uint64_t total = 0, pushed = 0, ts = 0;
+  uint32_t seed = 1;
+  double seconds = 0;
+
+  memset(&out, 0, sizeof(out));
+  hc_08_merge_init(&merge, BENCH_MODULES, bench_output, bench_late, NULL);
+  bench_queues(&merge);
+  // half a queue per round, the last round takes the rest, the merge leaves a few records in each
+  for(uint32_t left = per_module; left > 0;){
+    uint32_t round = left < BENCH_QUEUE / 2 ? left : BENCH_QUEUE / 2;
+    uint64_t start;
+
+    for(uint32_t n = 0; n < round; n++){
+      for(uint32_t i = 0; i < BENCH_MODULES; i++){
+        seed = seed * 1664525UL + 1013904223UL;
+        if(hc_08_merge_push(&queues[i], ts + (seed >> 24), "reading", 8) != hc_08_status_ok){
+          fprintf(stderr, "merge only: queue %u full\n", i);
+          hc_08_merge_deinit(&merge);
+          return 1;
+        }
+        pushed++;
+      }
+      ts += 256;
+    }
+    left -= round;
+    start = bench_now_us();
+    total += hc_08_merge_process(&merge, ts, 0);
+    seconds += (bench_now_us() - start) / 1e6;
+  }
+  total += hc_08_merge_flush(&merge);
+  printf("merge only   %10.0f records/s  %9llu records, %llu out of order\n", total / seconds,
+         (unsigned long long)out.count, (unsigned long long)out.disorder);
+  hc_08_merge_deinit(&merge);
+  if(out.count != pushed || total != pushed){
+    fprintf(stderr, "merge only: %llu records in, %llu out\n", (unsigned long long)pushed,
+            (unsigned long long)out.count);
+    return 1;
+  }
+  return 0;
+}
+
+static void *bench_producer(void *arg){
+  uint32_t first = (uint32_t)(uintptr_t)arg * (BENCH_MODULES / BENCH_PRODUCERS);
+  uint32_t sent[BENCH_MODULES / BENCH_PRODUCERS] = {0};
+  uint32_t done = 0;
+  uint64_t stall_end = 0, backlog = 0;
+
+  while(done < BENCH_MODULES / BENCH_PRODUCERS){
+    uint64_t now = bench_now_us();
+
+    done = 0;
+    for(uint32_t i = 0; i < BENCH_MODULES / BENCH_PRODUCERS; i++){
+      uint32_t module = first + i;
+      uint64_t timestamp = now;
+
+      if((faults && module == BENCH_SILENT) || sent[i] >= per_module){
+        hc_08_merge_idle(&queues[module], now);
+        done++;
+        continue;
+      }
+      if(faults && module == BENCH_STALLED){
+        // stops, then sends the readings it kept, stamped from the start of the stop
+        if(sent[i] == per_module / 2 && stall_end == 0){
+          stall_end = now + BENCH_STALL_US;
+          backlog = now;
+        }
+        if(now < stall_end){
+          continue;
+        }
+        if(backlog != 0 && backlog < now){
+          timestamp = backlog;
+          backlog += 1000;
+        }
+      }
+      // the queue may be full, the record is sent again later
+      sent[i] += hc_08_merge_push(&queues[module], timestamp, "reading", 8) == hc_08_status_ok;
+    }
+  }
+  return NULL;
+}
+
+/**
+  * @brief  Producer threads and one merging thread (this one)
+  * @param  with_faults 1 for the silent and the stalled module
+  */
+static void bench_threads(uint8_t with_faults){
+  pthread_t threads[BENCH_PRODUCERS];
+  hc_08_merge_ST merge;
+  uint64_t start, total = 0;
+  uint64_t expected = (uint64_t)(BENCH_MODULES - with_faults) * per_module;
+
+  memset(&out, 0, sizeof(out));
+  faults = with_faults;
+  hc_08_merge_init(&merge, BENCH_MODULES, bench_output, bench_late, NULL);
+  bench_queues(&merge);
+  start = bench_now_us();
+  for(uintptr_t i = 0; i < BENCH_PRODUCERS; i++){
+    pthread_create(&threads[i], NULL, bench_producer, (void *)i);
+  }
+  while(total < expected){
+    uint32_t count = hc_08_merge_process(&merge, bench_now_us(), 0);
+
+    if(count == 0){
+      sched_yield();
+    }
+    total += count;
+  }
+  for(uint32_t i = 0; i < BENCH_PRODUCERS; i++){
+    pthread_join(threads[i], NULL);
+  }
+  printf("%s %10.0f records/s  %9llu records, %llu out of order, %llu late, %u waits, %u skips\n",
+         with_faults ? "faults      " : "threads     ", total / ((bench_now_us() - start) / 1e6),
+         (unsigned long long)out.count, (unsigned long long)out.disorder, (unsigned long long)out.late, merge.metrics.waits, merge.metrics.skips);
+  hc_08_merge_deinit(&merge);
+}
+
+static pthread_mutex_t locked_mutex = PTHREAD_MUTEX_INITIALIZER;
+static hc_08_merge_record_ST *locked_buff;
+static uint32_t locked_size;
+
+static void *bench_locked_producer(void *arg){
+  uint32_t first = (uint32_t)(uintptr_t)arg * (BENCH_MODULES / BENCH_PRODUCERS);
+
+  for(uint32_t n = 0; n < per_module; n++){
+    for(uint32_t i = 0; i < BENCH_MODULES / BENCH_PRODUCERS; i++){
+      uint32_t module = first + i;
+      uint8_t queued = 0;
+
+      while(!queued){
+        pthread_mutex_lock(&locked_mutex);
+        if(locked_size < BENCH_MODULES * BENCH_QUEUE){
+          hc_08_merge_record_ST *record = &locked_buff[locked_size++];
+
+          record->timestamp_us = bench_now_us();
+          record->source = (uint16_t)module;
+          record->size = 8;
+          memcpy(record->data, "reading", 8);
+          queued = 1;
+        }
+        pthread_mutex_unlock(&locked_mutex);
+      }
+    }
+  }
+  return NULL;
+}
+
+static int bench_compare(const void *a, const void *b){
+  uint64_t x = ((const hc_08_merge_record_ST *)a)->timestamp_us;
+  uint64_t y = ((const hc_08_merge_record_ST *)b)->timestamp_us;
+
+  return (x > y) - (x < y);
+}
+
+/**
+  * @brief  Producer threads appending to one buffer under a lock, the consumer sorting each batch
+  */
+static void bench_locked(void){
+  pthread_t threads[BENCH_PRODUCERS];
+  hc_08_merge_record_ST *batch = malloc(sizeof(*batch) * BENCH_MODULES * BENCH_QUEUE);
+  uint64_t start, total = 0;
+  uint64_t expected = (uint64_t)BENCH_MODULES * per_module;
+
+  memset(&out, 0, sizeof(out));
+  locked_buff = malloc(sizeof(*locked_buff) * BENCH_MODULES * BENCH_QUEUE);
+  locked_size = 0;
+  start = bench_now_us();
+  for(uintptr_t i = 0; i < BENCH_PRODUCERS; i++){
+    pthread_create(&threads[i], NULL, bench_locked_producer, (void *)i);
+  }
+  while(total < expected){
+    uint32_t size;
+
+    pthread_mutex_lock(&locked_mutex);
+    size = locked_size < BENCH_BATCH ? locked_size : BENCH_BATCH;
+    memcpy(batch, locked_buff, sizeof(*batch) * size);
+    memmove(locked_buff, locked_buff + size, sizeof(*batch) * (locked_size - size));
+    locked_size -= size;
+    pthread_mutex_unlock(&locked_mutex);
+    if(size == 0){
+      sched_yield();
+      continue;
+    }
+
+    qsort(batch, size, sizeof(*batch), bench_compare);
+    for(uint32_t i = 0; i < size; i++){
+      bench_output(NULL, &batch[i]);
+    }
+    total += size;
+  }
+  for(uint32_t i = 0; i < BENCH_PRODUCERS; i++){
+    pthread_join(threads[i], NULL);
+  }
+  printf("lock + sort  %10.0f records/s  %9llu records, %llu out of order\n",
+         total / ((bench_now_us() - start) / 1e6), (unsigned long long)out.count, (unsigned long long)out.disorder);
+  free(locked_buff);
+  free(batch);
+}
+
+int main(int argc, char **argv){
+  if(argc > 1){
+    per_module = (uint32_t)atoi(argv[1]);
+  }
+  records = malloc(sizeof(*records) * BENCH_MODULES * BENCH_QUEUE);
+  if(records == NULL){
+    return 1;
+  }
+  printf("%u modules, %u records each, queues of %u records\n", BENCH_MODULES, per_module, BENCH_QUEUE);
+  if(bench_merge_only() != 0){
+    free(records);
+    return 1;
+  }
+  bench_threads(0);
+  bench_locked();
+  bench_threads(1);
+  free(records);
+  return 0;
+}
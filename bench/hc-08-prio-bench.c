@@ -0,0 +1,210 @@
+/*
+ * Wait of realtime data and AT commands behind bulk transfers, with hc-08-prio and with a
+ * single first-in first-out queue (every write whole, in the order it was queued).
+ * One simulated minute at 9600 bps: a 16-byte realtime frame every 100 ms, a 2 KB bulk
+ * transfer every 4 s and an AT command (AT+LED, answered by hc-08-emu) every 5 s. The
+ * module is disconnected from 20 to 22 s and from 40 to 42 s, where only AT commands can
+ * be sent. The release callback ends the connection for BENCH_RELEASE_MS when an AT command
+ * has waited past its deadline. Realtime frames that waited across a disconnection are left
+ * out of the realtime figures. The bound of hc-08-prio, two bulk chunks on the UART, is for
+ * the head of the realtime queue, measured from the write of the previous frame; frames
+ * queued behind others wait for those as well.
+ *
+ * gcc -O2 -I../lib hc-08-prio-bench.c ../lib/hc-08.c ../lib/hc-08-emu.c ../lib/hc-08-prio.c -o hc-08-prio-bench
+ */
+#include "hc-08.h"
+#include "hc-08-emu.h"
+#include "hc-08-prio.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_TIME_MS       60000UL
+#define BENCH_DRAIN_MS      30000UL
+#define BENCH_REALTIME      16
+#define BENCH_REALTIME_MS   100
+#define BENCH_BULK          2048
+#define BENCH_BULK_MS       4000
+#define BENCH_CONTROL_MS    5000
+#define BENCH_RELEASE_MS    500     // disconnection, AT command and reconnection
+
+static uint64_t now_us;
+static hc_08_emu_ST emu;
+static hc_08_ST hc_08;
+
+static hc_08_prio_item_ST realtime_items[BENCH_TIME_MS / BENCH_REALTIME_MS];
+static hc_08_prio_item_ST bulk_items[BENCH_TIME_MS / BENCH_BULK_MS];
+static hc_08_prio_item_ST control_items[BENCH_TIME_MS / BENCH_CONTROL_MS];
+static char realtime_data[BENCH_REALTIME];
+static char bulk_data[BENCH_BULK];
+
+static uint32_t bench_tick(void){
+  return (uint32_t)(now_us / 1000);
+}
+
+/**
+  * @brief  AT commands go to the emulator and take its time; data only takes UART time,
+  *         which hc-08-prio accounts for itself
+  */
+static void bench_tx(void *ctx, char *buff, uint16_t size){
+  (void)ctx;
+  if(hc_08.status_connect != hc_08_status_connected){
+    emu.time_us = now_us;
+    hc_08_emu_tx(&emu, buff, size);
+    now_us = emu.time_us;
+  }
+}
+
+static uint16_t bench_rx(void *ctx, char *buff, uint16_t size){
+  uint16_t count;
+
+  (void)ctx;
+  emu.time_us = now_us;
+  count = hc_08_emu_rx(&emu, buff, size);
+  now_us = emu.time_us;
+  return count;
+}
+
+static void bench_led(hc_08_ST *hc_08, void *ctx){
+  hc_08_cmd_set_led(hc_08, (hc_08_led)((uintptr_t)ctx & 1));
+}
+
+static const uint32_t disconnected[][2] = {{20000, 22000}, {40000, 42000}};
+static uint32_t released[64][2];     // a single queue may release several times per AT command
+static uint8_t releases;
+
+/**
+  * @brief  Ends the connection for BENCH_RELEASE_MS from now
+  */
+static void bench_release(void *ctx){
+  (void)ctx;
+  if(releases < sizeof(released) / sizeof(released[0])){
+    released[releases][0] = bench_tick();
+    released[releases][1] = bench_tick() + BENCH_RELEASE_MS;
+    releases++;
+  }
+}
+
+static uint8_t bench_crosses_disconnection(uint32_t start, uint32_t end){
+  for(uint8_t i = 0; i < sizeof(disconnected) / sizeof(disconnected[0]); i++){
+    if(start < disconnected[i][1] && end >= disconnected[i][0]){
+      return 1;
+    }
+  }
+  for(uint8_t i = 0; i < releases; i++){
+    if(start < released[i][1] && end >= released[i][0]){
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static uint8_t bench_connected(uint32_t ms){
+  return !bench_crosses_disconnection(ms, ms);
+}
+
+static struct{
+  uint32_t count;
+  uint32_t max;
+  uint32_t misses;
+  uint64_t sum;
+}realtime_wait, realtime_head, bulk_time;
+static uint32_t realtime_last;
+
+/**
+  * @brief  A realtime frame is written whole, so done runs when it starts; a bulk transfer
+  *         is done when its last chunk is written
+  */
+static void bench_done(hc_08_ST *hc_08, hc_08_prio_item_ST *item){
+  uint32_t now = hc_08_get_tick(hc_08);
+  uint32_t elapsed = now - item->tick;
+  uint32_t head;
+
+  if(item->size == BENCH_REALTIME){
+    // at the head of the queue since it was queued or since the previous frame was written
+    head = now - (item->tick > realtime_last ? item->tick : realtime_last);
+    realtime_last = now;
+    if(bench_crosses_disconnection(item->tick, now)){
+      return;
+    }
+    realtime_wait.count++;
+    realtime_wait.sum += elapsed;
+    realtime_wait.max = elapsed > realtime_wait.max ? elapsed : realtime_wait.max;
+    realtime_wait.misses += elapsed > HC_08_PRIO_DEADLINE_REALTIME;
+    realtime_head.max = head > realtime_head.max ? head : realtime_head.max;
+  }else{
+    bulk_time.count++;
+    bulk_time.sum += elapsed;
+    bulk_time.max = elapsed > bulk_time.max ? elapsed : bulk_time.max;
+  }
+}
+
+
+/**
+  * @brief  One simulated minute
+  * @param  fifo 1 for one queue without chunks, 0 for the priority classes
+  */
+static void bench_run(uint8_t fifo){
+  hc_08_prio_ST prio;
+  hc_08_prio_class realtime = fifo ? hc_08_prio_bulk : hc_08_prio_realtime;
+
+  now_us = 0;
+  memset(&realtime_wait, 0, sizeof(realtime_wait));
+  memset(&realtime_head, 0, sizeof(realtime_head));
+  realtime_last = 0;
+  releases = 0;
+  memset(&bulk_time, 0, sizeof(bulk_time));
+  hc_08_emu_init(&emu);
+  hc_08_reg_uart_cbfunc_ctx(&hc_08, bench_tx, bench_rx, NULL);
+  hc_08_reg_tick_cbfunc(&hc_08, bench_tick);
+  hc_08.param.baud = hc_08_baud_9600bps;
+  hc_08.param.parity = hc_08_parity_bit_no_parity;
+  hc_08_prio_init(&prio, &hc_08, bench_release, NULL);
+  if(fifo){
+    prio.cfg.chunk = 0xFFFF;
+    prio.cfg.deadline[hc_08_prio_bulk] = UINT32_MAX;
+  }
+
+  for(uint32_t ms = 0; ms < BENCH_TIME_MS + BENCH_DRAIN_MS; ms++){
+    if(now_us < (uint64_t)ms * 1000){
+      now_us = (uint64_t)ms * 1000;
+    }
+    hc_08.status_connect = bench_connected(ms) ? hc_08_status_connected : hc_08_status_not_connected;
+    if(ms < BENCH_TIME_MS){
+      if(ms % BENCH_REALTIME_MS == 0){
+        hc_08_prio_data(&prio, &realtime_items[ms / BENCH_REALTIME_MS], realtime,
+                        realtime_data, BENCH_REALTIME, bench_done, NULL);
+      }
+      if(ms % BENCH_BULK_MS == 0){
+        hc_08_prio_data(&prio, &bulk_items[ms / BENCH_BULK_MS], hc_08_prio_bulk,
+                        bulk_data, BENCH_BULK, bench_done, NULL);
+      }
+      if(ms % BENCH_CONTROL_MS == 0){
+        hc_08_prio_command(&prio, &control_items[ms / BENCH_CONTROL_MS], bench_led, NULL,
+                           (void *)(uintptr_t)(ms / BENCH_CONTROL_MS));
+      }
+    }
+    hc_08_prio_process(&prio);
+  }
+
+  printf("%s\n", fifo ? "single queue, whole writes" : "hc-08-prio");
+  if(!fifo){
+    printf("  realtime bound  %u ms at the head of the queue, measured max %u ms\n",
+           (uint32_t)(2 * prio.cfg.chunk * hc_08_prio_byte_time_us(&hc_08) / 1000 + 2), realtime_head.max);
+  }
+  printf("  realtime wait   %4u frames, avg %5.1f ms, max %5u ms, over %u ms: %u\n", realtime_wait.count,
+         realtime_wait.count ? (double)realtime_wait.sum / realtime_wait.count : 0.0, realtime_wait.max,
+         HC_08_PRIO_DEADLINE_REALTIME, realtime_wait.misses);
+  printf("  bulk transfer   %4u items,  avg %5.0f ms, max %5u ms\n", bulk_time.count,
+         bulk_time.count ? (double)bulk_time.sum / bulk_time.count : 0.0, bulk_time.max);
+  printf("  AT command wait %4u items,  avg %5u ms, max %5u ms, releases %u\n", prio.metrics.items[hc_08_prio_control],
+         prio.metrics.wait_avg[hc_08_prio_control], prio.metrics.wait_max[hc_08_prio_control],
+         prio.metrics.releases);
+}
+
+int main(void){
+  memset(bulk_data, 'B', sizeof(bulk_data));
+  memset(realtime_data, 'R', sizeof(realtime_data));
+  bench_run(1);
+  bench_run(0);
+  return 0;
+}
@@ -0,0 +1,41 @@
+/*
+ * Applies every predefined profile to an emulated module and reports the
+ * expected round-trip time and throughput of each one.
+ *
+ * gcc -O2 -I../lib hc-08-profile-bench.c ../lib/hc-08.c ../lib/hc-08-emu.c ../lib/hc-08-profile.c -o hc-08-profile-bench
+ */
+#include "hc-08.h"
+#include "hc-08-emu.h"
+#include "hc-08-profile.h"
+#include <stdio.h>
+
+int main(void){
+  printf("%-16s %10s %10s %12s %12s %12s\n", "profile", "apply", "verify", "rtt 20B", "rtt 200B", "throughput");
+
+  for(int i = 0; i < HC_08_PROFILE_SIZE; i++){
+    const hc_08_profile_ST *profile = hc_08_profile_get((hc_08_profile)i);
+    hc_08_ST hc_08 = {0};
+    hc_08_emu_ST emu;
+    uint64_t start;
+    uint32_t apply_us;
+    hc_08_status status;
+
+    hc_08_emu_init(&emu);
+    emu.param.baud = hc_08_baud_115200bps;
+    hc_08_emu_attach(&emu, &hc_08);
+
+    start = emu.time_us;
+    status = hc_08_profile_apply(&hc_08, profile);
+    apply_us = (uint32_t)(emu.time_us - start);
+    if(status == hc_08_status_ok){
+      status = hc_08_profile_verify(&hc_08, profile);
+    }
+
+    printf("%-16s %8.1fms %10s %10.1fms %10.1fms %9u B/s\n", hc_08_profile_c[i],
+           apply_us / 1000.0, status == hc_08_status_ok ? "ok" : "FAILED",
+           hc_08_emu_data_rtt_us(&emu, 20) / 1000.0,
+           hc_08_emu_data_rtt_us(&emu, 200) / 1000.0,
+           (unsigned int)hc_08_emu_throughput(&emu));
+  }
+  return 0;
+}
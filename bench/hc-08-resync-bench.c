@@ -0,0 +1,143 @@
+/*
+ * Desync detection and recovery of hc-08-resync on an emulated module, through the UART
+ * functions with a context (the size of every answer is known) and through the legacy ones
+ * of hc_08_reg_uart_cbfunc (the answer ends at the first NUL). The same workload runs on
+ * both: 100000 AT+ROLE=? queries, each checked with hc_08_resync_check(...) and sent again
+ * after a recovery. One answer in 200 gets a framing error (a byte becomes 0xFF), and every
+ * 5000 queries the module moves to another baud rate behind the host, so until the host
+ * follows every byte arrives garbled. Printed per transport: desyncs, false alarms (a valid
+ * answer rejected), how they were recovered, AT probes and the longest recovery in
+ * emulated time.
+ *
+ * gcc -O2 -I../lib hc-08-resync-bench.c ../lib/hc-08.c ../lib/hc-08-emu.c ../lib/hc-08-resync.c -o hc-08-resync-bench
+ */
+#include "hc-08.h"
+#include "hc-08-emu.h"
+#include "hc-08-resync.h"
+#include <stdio.h>
+
+#define BENCH_QUERIES       100000UL
+#define BENCH_NOISE_EVERY   200      // answers per framing error
+#define BENCH_BAUD_EVERY    5000     // queries per baud change of the module
+#define BENCH_RESENDS       3
+
+static hc_08_emu_ST emu;
+static hc_08_baud host_baud;
+static hc_08_parity_bit host_parity;
+static uint32_t seed;
+static uint32_t answers;
+static uint32_t damaged;     // answers garbled by noise or by the line settings
+
+static uint32_t bench_random(void){
+  seed = seed * 1103515245UL + 12345;
+  return (seed >> 16) & 0x7fff;
+}
+
+static uint32_t bench_tick(void){
+  return (uint32_t)(emu.time_us / 1000);
+}
+
+static hc_08_status bench_set_line(void *ctx, hc_08_baud baud, hc_08_parity_bit parity){
+  (void)ctx;
+  host_baud = baud;
+  host_parity = parity;
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Answer of the emulator as the host UART sees it: garbled when the line settings
+  *         differ, and one answer in BENCH_NOISE_EVERY with a framing error
+  */
+static uint16_t bench_line(char *buff, uint16_t size){
+  uint16_t count = hc_08_emu_rx(&emu, buff, size);
+
+  if(count == 0){
+    return 0;
+  }
+  answers++;
+  if(host_baud != emu.param.baud || host_parity != emu.param.parity){
+    for(uint16_t i = 0; i < count; i++){
+      buff[i] = (char)(buff[i] | 0x80);
+    }
+    damaged++;
+  }else if(bench_random() % BENCH_NOISE_EVERY == 0){
+    buff[bench_random() % count] = (char)0xFF;
+    damaged++;
+  }
+  return count;
+}
+
+static void bench_tx(void *ctx, char *buff, uint16_t size){
+  (void)ctx;
+  hc_08_emu_tx(&emu, buff, size);
+}
+
+static uint16_t bench_rx(void *ctx, char *buff, uint16_t size){
+  (void)ctx;
+  return bench_line(buff, size);
+}
+
+static void bench_tx_legacy(char *buff, uint16_t size){
+  hc_08_emu_tx(&emu, buff, size);
+}
+
+static void bench_rx_legacy(char *buff, uint16_t size){
+  bench_line(buff, size);
+}
+
+static void bench_run(uint8_t legacy){
+  static hc_08_ST hc_08;
+  static hc_08_resync_ST resync;
+  uint32_t parsed = 0;
+  uint32_t desyncs_damaged = 0;
+
+  hc_08_emu_init(&emu);
+  seed = 1;
+  answers = 0;
+  damaged = 0;
+  host_baud = emu.param.baud;
+  host_parity = emu.param.parity;
+  if(legacy){
+    hc_08_reg_uart_cbfunc(&hc_08, bench_tx_legacy, bench_rx_legacy);
+  }else{
+    hc_08_reg_uart_cbfunc_ctx(&hc_08, bench_tx, bench_rx, NULL);
+  }
+  hc_08_reg_tick_cbfunc(&hc_08, bench_tick);
+  hc_08.param.baud = host_baud;
+  hc_08.param.parity = host_parity;
+  hc_08_resync_init(&resync, &hc_08, bench_set_line, NULL);
+
+  for(uint32_t query = 0; query < BENCH_QUERIES; query++){
+    if(query % BENCH_BAUD_EVERY == BENCH_BAUD_EVERY - 1){
+      emu.param.baud = (hc_08_baud)(bench_random() % HC_08_BAUD_SIZE);
+    }
+    for(uint8_t send = 0; send < BENCH_RESENDS; send++){
+      uint32_t before = damaged;
+      uint8_t garbled;
+
+      hc_08_cmd_ask_role(&hc_08);
+      hc_08_read_answer(&hc_08);
+      garbled = damaged != before;
+      if(hc_08_resync_check(&resync) == hc_08_resync_result_ok){
+        parsed += hc_08_parse_role(&hc_08, hc_08.uart.rx_size) == hc_08_status_ok;
+        break;
+      }
+      desyncs_damaged += garbled;
+    }
+  }
+
+  printf("%-8s %9u %8u %8u %8u %6u %6u %8u %10u\n", legacy ? "legacy" : "ctx", resync.metrics.checks, parsed,
+         resync.metrics.desyncs, resync.metrics.desyncs - desyncs_damaged, resync.metrics.flushed,
+         resync.metrics.baud, resync.metrics.probes, resync.metrics.recovery_max);
+  if(resync.metrics.failed != 0){
+    printf("  %u recoveries failed\n", resync.metrics.failed);
+  }
+}
+
+int main(void){
+  printf("%-8s %9s %8s %8s %8s %6s %6s %8s %10s\n", "uart", "checks", "parsed", "desyncs", "false", "flush",
+         "baud", "probes", "max ms");
+  bench_run(0);
+  bench_run(1);
+  return 0;
+}
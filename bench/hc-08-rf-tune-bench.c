@@ -0,0 +1,168 @@
+/*
+ * RF power chosen by hc-08-rf-tune against a fixed 4 dBm, on a simulated channel.
+ * One simulated day in three placements of the peer: 2 m (8 h), 15 m (8 h) and 4 m with
+ * interference bursts (8 h). The channel: indoor path loss 40 + 25 log10(d) dB, -85 dBm
+ * sensitivity, slow fading of +-4 dB per 10 s, a frame error rate of 0.3 exp(-margin / 2.5),
+ * and a lost connection below -3 dB of margin (a new attempt to connect every 5 s). The application sends
+ * 10 frames per second, reports its retransmits and one heartbeat RTT per second, and
+ * releases the connection when the tuner has a new level. The module is hc-08-emu, so the
+ * level in use is the one AT+RFPM really wrote. Printed per placement: time at each level,
+ * average radiated power, retransmits and disconnections.
+ *
+ * gcc -O2 -I../lib hc-08-rf-tune-bench.c ../lib/hc-08.c ../lib/hc-08-emu.c ../lib/hc-08-rf-tune.c -lm -o hc-08-rf-tune-bench
+ */
+#include "hc-08.h"
+#include "hc-08-emu.h"
+#include "hc-08-rf-tune.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#define BENCH_PHASE_S       (8 * 3600UL)
+#define BENCH_FRAMES_S      10
+#define BENCH_RECONNECT_S   5
+#define BENCH_RELEASE_S     1
+#define BENCH_LINK_MARGIN   -3
+#define BENCH_HISTORY       64
+
+static const double bench_dbm[HC_08_RFPM_SIZE] = {4, 0, -6, -23};
+static const char * const bench_phase_c[] = {"2 m", "15 m", "4 m, bursts"};
+static const double bench_distance[] = {2, 15, 4};
+
+static uint32_t now_ms;
+static uint32_t seed = 1;
+static hc_08_emu_ST emu;
+static hc_08_ST hc_08;
+static uint32_t down_s;      // seconds left without connection
+
+static uint32_t bench_tick(void){
+  return now_ms;
+}
+
+static double bench_random(void){
+  seed = seed * 1664525UL + 1013904223UL;
+  return (seed >> 8) / 16777216.0;
+}
+
+static void bench_release(void *ctx){
+  (void)ctx;
+  hc_08.status_connect = hc_08_status_not_connected;
+  down_s = BENCH_RELEASE_S;
+}
+
+typedef struct{
+  double seconds[HC_08_RFPM_SIZE];
+  double mw_seconds;
+  uint32_t frames;
+  uint32_t retransmits;
+  uint32_t disconnects;
+}bench_result;
+
+static double bench_margin(hc_08_rfpm rfpm, double distance, double fade){
+  return bench_dbm[rfpm] - (40 + 25 * log10(distance)) + 85 + fade;
+}
+
+/**
+  * @brief  One second of traffic on the channel at a power
+  * @retval 1 if the connection is lost
+  */
+static uint8_t bench_second(bench_result *result, hc_08_rfpm rfpm, double distance, double fade,
+                            uint32_t *retransmits, uint32_t *rtt){
+  double margin = bench_margin(rfpm, distance, fade);
+  double fer = 0.3 * exp(-margin / 2.5);
+
+  result->seconds[rfpm]++;
+  result->mw_seconds += pow(10, bench_dbm[rfpm] / 10);
+  if(margin < BENCH_LINK_MARGIN){
+    result->disconnects++;
+    return 1;
+  }
+  if(fer > 0.9){
+    fer = 0.9;
+  }
+  *retransmits = 0;
+  for(uint8_t i = 0; i < BENCH_FRAMES_S; i++){
+    while(bench_random() < fer){
+      (*retransmits)++;
+    }
+  }
+  *rtt = 30 + 30 * *retransmits / BENCH_FRAMES_S;
+  result->frames += BENCH_FRAMES_S;
+  result->retransmits += *retransmits;
+  return 0;
+}
+
+static void bench_print(const char *name, const bench_result *result){
+  double total = 0;
+
+  for(uint8_t i = 0; i < HC_08_RFPM_SIZE; i++){
+    total += result->seconds[i];
+  }
+  printf("  %-9s", name);
+  for(uint8_t i = 0; i < HC_08_RFPM_SIZE; i++){
+    printf(" %6s %5.1f%%", hc_08_rfpm_c[i], 100 * result->seconds[i] / total);
+  }
+  printf("  %7.3f mW  retx %5.1f/1000  disconnects %u\n", result->mw_seconds / total,
+         result->frames ? 1000.0 * result->retransmits / result->frames : 0.0, result->disconnects);
+}
+
+int main(void){
+  static hc_08_rf_tune_record_ST history[BENCH_HISTORY];
+  hc_08_rf_tune_ST tune;
+  double fade = 0;
+
+  hc_08_emu_init(&emu);
+  hc_08_emu_attach(&emu, &hc_08);
+  hc_08_reg_tick_cbfunc(&hc_08, bench_tick);
+  hc_08.status_connect = hc_08_status_connected;
+  hc_08_rf_tune_init(&tune, &hc_08, bench_release, NULL, history, BENCH_HISTORY);
+
+  for(uint8_t phase = 0; phase < 3; phase++){
+    bench_result tuned = {0}, fixed = {0};
+    uint32_t ups = tune.metrics.ups, downs = tune.metrics.downs;
+
+    for(uint32_t s = 0; s < BENCH_PHASE_S; s++){
+      uint32_t retransmits = 0, rtt = 0, unused_retx, unused_rtt;
+
+      now_ms += 1000;
+      if(s % 10 == 0){
+        fade = (bench_random() - 0.5) * 8;
+        // interference: 1 window in 50 loses 12 dB
+        if(phase == 2 && bench_random() < 0.02){
+          fade -= 12;
+        }
+      }
+      bench_second(&fixed, hc_08_rfpm_4dBm, bench_distance[phase], fade, &unused_retx, &unused_rtt);
+      // the main loop runs on connection changes as well as once per second
+      if(down_s > 0 && --down_s == 0){
+        hc_08_rf_tune_process(&tune);
+        if(bench_margin(emu.param.rfpm, bench_distance[phase], fade) < BENCH_LINK_MARGIN){
+          down_s = BENCH_RECONNECT_S;
+        }else{
+          hc_08.status_connect = hc_08_status_connected;
+        }
+      }
+      if(down_s == 0){
+        if(bench_second(&tuned, emu.param.rfpm, bench_distance[phase], fade, &retransmits, &rtt)){
+          hc_08.status_connect = hc_08_status_not_connected;
+          down_s = BENCH_RECONNECT_S;
+        }else{
+          hc_08_rf_tune_report(&tune, BENCH_FRAMES_S, retransmits, rtt);
+        }
+      }
+      hc_08_rf_tune_process(&tune);
+    }
+    printf("%s (%u steps up, %u down)\n", bench_phase_c[phase], tune.metrics.ups - ups, tune.metrics.downs - downs);
+    bench_print("4 dBm", &fixed);
+    bench_print("tuned", &tuned);
+  }
+
+  printf("last windows:\n");
+  for(uint32_t age = 4; age-- > 0;){
+    char line[96];
+
+    hc_08_rf_tune_format(hc_08_rf_tune_record(&tune, age), line, sizeof(line));
+    printf("  %s\n", line);
+  }
+  return 0;
+}
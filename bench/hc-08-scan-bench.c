@@ -0,0 +1,224 @@
+/*
+ * Marker scanning speed of hc-08-scan per kernel, against a search of each marker in turn
+ * with hc_08_view_search (memchr and memcmp, as the parsers do). 64 MB of random bytes
+ * with a marker every 4 KB on average (hc-08-link frame magic and four status strings) are
+ * received by 256 streams in 4 KB chunks, one chunk per stream in turn, as a gateway
+ * reading many modules would. Each kernel must give the same spans and markers as the
+ * scalar one, and the same when the stream is cut into chunks of 1~100 bytes.
+ * The per-marker search handles each chunk alone and misses markers cut by a chunk end.
+ *
+ * gcc -O2 -I../lib hc-08-scan-bench.c ../lib/hc-08.c ../lib/hc-08-scan.c -o hc-08-scan-bench
+ * ./hc-08-scan-bench [MB]
+ */
+#define _POSIX_C_SOURCE 199309L
+#include "hc-08.h"
+#include "hc-08-scan.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_STREAMS   256
+#define BENCH_CHUNK     4096
+#define BENCH_GAP       4096
+#define BENCH_RUNS      3
+
+static const char * const bench_marker[] = {
+  "\xA5\x5A", "OK+CONN", "OK+LOST", "OK+WAKE", "ERROR"
+};
+#define BENCH_MARKERS (sizeof(bench_marker) / sizeof(bench_marker[0]))
+
+typedef struct{
+  uint64_t bytes;
+  uint64_t markers;
+  uint64_t hash;                     // spans and markers
+  uint64_t ids;                      // markers only, the same for any chunking
+}bench_stream;
+
+static bench_stream streams[BENCH_STREAMS];
+static uint32_t seed = 1;
+
+static uint32_t bench_random(void){
+  seed = seed * 1664525UL + 1013904223UL;
+  return seed >> 8;
+}
+
+static double bench_now(void){
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void bench_span(void *ctx, const char *data, uint32_t size){
+  bench_stream *stream = ctx;
+
+  stream->bytes += size;
+  stream->hash = stream->hash * 31 + size + (uint8_t)data[0];
+}
+
+static void bench_found(void *ctx, uint8_t id){
+  bench_stream *stream = ctx;
+
+  stream->markers++;
+  stream->hash = stream->hash * 31 + 0x100 + id;
+  stream->ids = stream->ids * 31 + id + 1;
+}
+
+static void bench_total(bench_stream *total){
+  memset(total, 0, sizeof(*total));
+  for(uint32_t i = 0; i < BENCH_STREAMS; i++){
+    total->bytes += streams[i].bytes;
+    total->markers += streams[i].markers;
+    total->hash = total->hash * 7 + streams[i].hash;
+  }
+}
+
+/**
+  * @brief  The earliest marker in a chunk, each marker searched for over the whole rest
+  */
+static void bench_search(bench_stream *stream, const char *data, uint32_t size){
+  hc_08_view rest = {data, (uint16_t)size};
+
+  while(rest.size > 0){
+    const char *best = NULL;
+    uint8_t best_id = 0;
+
+    for(uint8_t i = 0; i < BENCH_MARKERS; i++){
+      const char *pos = hc_08_view_search(&rest, bench_marker[i]);
+
+      if(pos != NULL && (best == NULL || pos < best)){
+        best = pos;
+        best_id = i;
+      }
+    }
+    if(best == NULL){
+      bench_span(stream, rest.data, rest.size);
+      break;
+    }
+    if(best > rest.data){
+      bench_span(stream, rest.data, (uint32_t)(best - rest.data));
+    }
+    bench_found(stream, best_id);
+    best += strlen(bench_marker[best_id]);
+    rest.size -= (uint16_t)(best - rest.data);
+    rest.data = best;
+  }
+}
+
+static void bench_add(hc_08_scan_ST *scan){
+  for(uint8_t i = 0; i < BENCH_MARKERS; i++){
+    hc_08_scan_add(scan, bench_marker[i], (uint8_t)strlen(bench_marker[i]), i);
+  }
+}
+
+/**
+  * @brief  One pass over the data with a kernel, or with the per-marker search (kernel < 0)
+  * @retval seconds
+  */
+static double bench_pass(const char *data, size_t size, int kernel){
+  static hc_08_scan_ST scan[BENCH_STREAMS];
+  double start;
+
+  memset(streams, 0, sizeof(streams));
+  for(uint32_t i = 0; i < BENCH_STREAMS && kernel >= 0; i++){
+    hc_08_scan_init(&scan[i], bench_span, bench_found, &streams[i]);
+    hc_08_scan_set_kernel(&scan[i], (hc_08_scan_kernel)kernel);
+    bench_add(&scan[i]);
+  }
+  start = bench_now();
+  for(size_t pos = 0, chunk = 0; pos < size; pos += BENCH_CHUNK, chunk++){
+    uint32_t n = size - pos < BENCH_CHUNK ? (uint32_t)(size - pos) : BENCH_CHUNK;
+
+    if(kernel >= 0){
+      hc_08_scan_feed(&scan[chunk % BENCH_STREAMS], data + pos, n);
+    }else{
+      bench_search(&streams[chunk % BENCH_STREAMS], data + pos, n);
+    }
+  }
+  for(uint32_t i = 0; i < BENCH_STREAMS && kernel >= 0; i++){
+    hc_08_scan_flush(&scan[i]);
+  }
+  return bench_now() - start;
+}
+
+/**
+  * @brief  The first MB of the data as one stream, whole and in chunks of 1~100 bytes
+  * @retval 1 if both give the same result
+  */
+static uint8_t bench_chunking(const char *data, size_t size, hc_08_scan_kernel kernel){
+  hc_08_scan_ST scan;
+  uint64_t hash[2];
+
+  size = size < (1 << 20) ? size : (1 << 20);
+  for(uint8_t pass = 0; pass < 2; pass++){
+    memset(&streams[0], 0, sizeof(streams[0]));
+    hc_08_scan_init(&scan, bench_span, bench_found, &streams[0]);
+    hc_08_scan_set_kernel(&scan, kernel);
+    bench_add(&scan);
+    for(size_t pos = 0; pos < size;){
+      uint32_t n = pass == 0 ? (uint32_t)size : 1 + bench_random() % 100;
+
+      n = size - pos < n ? (uint32_t)(size - pos) : n;
+      hc_08_scan_feed(&scan, data + pos, n);
+      pos += n;
+    }
+    hc_08_scan_flush(&scan);
+    hash[pass] = streams[0].ids * 1000003 + streams[0].bytes;
+  }
+  return hash[0] == hash[1];
+}
+
+int main(int argc, char **argv){
+  size_t size = (size_t)(argc > 1 ? atoi(argv[1]) : 64) << 20;
+  char *data = malloc(size);
+  bench_stream reference = {0};
+  uint32_t inserted = 0;
+
+  if(data == NULL){
+    return 1;
+  }
+  for(size_t i = 0; i < size; i++){
+    data[i] = (char)bench_random();
+  }
+  for(size_t pos = bench_random() % (2 * BENCH_GAP); pos + HC_08_SCAN_MARKER_MAX < size;
+      pos += 1 + bench_random() % (2 * BENCH_GAP)){
+    const char *marker = bench_marker[bench_random() % BENCH_MARKERS];
+
+    memcpy(data + pos, marker, strlen(marker));
+    inserted++;
+  }
+  printf("%zu MB, %u markers inserted, %u streams, %u B chunks\n", size >> 20, inserted, BENCH_STREAMS, BENCH_CHUNK);
+
+  for(int kernel = -1; kernel < HC_08_SCAN_KERNEL_SIZE; kernel++){
+    hc_08_scan_ST probe;
+    bench_stream total;
+    double best = 0;
+
+    hc_08_scan_init(&probe, bench_span, bench_found, NULL);
+    if(kernel >= 0 && hc_08_scan_set_kernel(&probe, (hc_08_scan_kernel)kernel) != hc_08_status_ok){
+      printf("%-16s not available\n", hc_08_scan_kernel_c[kernel]);
+      continue;
+    }
+    for(uint8_t run = 0; run < BENCH_RUNS; run++){
+      double seconds = bench_pass(data, size, kernel);
+
+      best = (run == 0 || seconds < best) ? seconds : best;
+    }
+    bench_total(&total);
+    if(kernel == hc_08_scan_kernel_scalar){
+      reference = total;
+    }
+    printf("%-16s %6.2f GB/s  %8llu markers", kernel < 0 ? "per-marker search" : hc_08_scan_kernel_c[kernel],
+           size / best / 1e9, (unsigned long long)total.markers);
+    if(kernel > hc_08_scan_kernel_scalar){
+      printf("  %s", total.hash == reference.hash && total.bytes == reference.bytes ? "same as scalar" : "MISMATCH");
+    }
+    if(kernel >= 0){
+      printf("  chunking %s", bench_chunking(data, size, (hc_08_scan_kernel)kernel) ? "ok" : "MISMATCH");
+    }
+    printf("\n");
+  }
+  free(data);
+  return 0;
+}
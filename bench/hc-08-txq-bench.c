@@ -0,0 +1,167 @@
+/*
+ * Several producer threads sending 20-byte messages through one module, written to
+ * /dev/null so that every hc_08_uart_tx call is a real write() syscall.
+ *   mutex: each producer locks a mutex around hc_08_uart_tx (one syscall per message)
+ *   txq:   producers push to hc-08-txq, one I/O thread drains batches
+ * Printed per number of producers: messages per second, write() calls, messages per call,
+ * pushes refused because the queue was full (the producer yields and retries) and the
+ * slowest send or push seen by a producer.
+ *
+ * gcc -O2 -I../lib hc-08-txq-bench.c ../lib/hc-08.c ../lib/hc-08-txq.c -lpthread -o hc-08-txq-bench
+ * ./hc-08-txq-bench [messages per producer]
+ */
+#define _GNU_SOURCE
+#include "hc-08.h"
+#include "hc-08-txq.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_MESSAGE     20
+#define BENCH_SLOTS       1024
+#define BENCH_PRODUCERS   8
+
+typedef struct{
+  hc_08_ST hc_08;
+  hc_08_txq_ST txq;
+  pthread_mutex_t lock;
+  uint8_t use_txq;
+  uint32_t messages;
+  atomic_uint running;
+  uint32_t writes;
+}bench_ST;
+
+typedef struct{
+  bench_ST *bench;
+  pthread_t thread;
+  uint64_t worst_ns;
+}bench_producer_ST;
+
+static int null_fd;
+static hc_08_txq_slot_ST slots[BENCH_SLOTS];
+
+static uint64_t bench_ns(void){
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void bench_tx(void *ctx, char *buff, uint16_t size){
+  bench_ST *bench = (bench_ST *)ctx;
+
+  bench->writes++;
+  if(write(null_fd, buff, size) < 0){
+    perror("write");
+  }
+}
+
+static uint16_t bench_rx(void *ctx, char *buff, uint16_t size){
+  (void)ctx;
+  (void)buff;
+  (void)size;
+  return 0;
+}
+
+static void *bench_producer(void *arg){
+  bench_producer_ST *producer = (bench_producer_ST *)arg;
+  bench_ST *bench = producer->bench;
+  char message[BENCH_MESSAGE] = "0123456789abcdefghi";
+
+  for(uint32_t i = 0; i < bench->messages; i++){
+    uint64_t start = (i & 63) == 0 ? bench_ns() : 0;
+
+    if(bench->use_txq){
+      while(hc_08_txq_push(&bench->txq, message, sizeof(message)) != hc_08_status_ok){
+        sched_yield();
+      }
+    }else{
+      pthread_mutex_lock(&bench->lock);
+      hc_08_uart_tx(&bench->hc_08, message, sizeof(message));
+      pthread_mutex_unlock(&bench->lock);
+    }
+    if(start != 0 && bench_ns() - start > producer->worst_ns){
+      producer->worst_ns = bench_ns() - start;
+    }
+  }
+  return NULL;
+}
+
+static void *bench_io(void *arg){
+  bench_ST *bench = (bench_ST *)arg;
+  static char batch[0x4000];
+
+  while(atomic_load(&bench->running) || hc_08_txq_pending(&bench->txq) > 0){
+    if(hc_08_txq_drain(&bench->txq, batch, sizeof(batch)) == 0){
+      sched_yield();
+    }
+  }
+  return NULL;
+}
+
+static void bench_run(uint8_t use_txq, uint32_t producers, uint32_t messages){
+  static bench_ST bench;
+  bench_producer_ST producer[BENCH_PRODUCERS] = {0};
+  pthread_t io;
+  uint64_t start, worst = 0;
+  double seconds;
+  uint32_t total = producers * messages;
+
+  bench = (bench_ST){0};
+  bench.use_txq = use_txq;
+  bench.messages = messages;
+  pthread_mutex_init(&bench.lock, NULL);
+  hc_08_reg_uart_cbfunc_ctx(&bench.hc_08, bench_tx, bench_rx, &bench);
+  hc_08_txq_init(&bench.txq, &bench.hc_08, slots, BENCH_SLOTS);
+  atomic_store(&bench.running, 1);
+
+  start = bench_ns();
+  if(use_txq){
+    pthread_create(&io, NULL, bench_io, &bench);
+  }
+  for(uint32_t p = 0; p < producers; p++){
+    producer[p].bench = &bench;
+    pthread_create(&producer[p].thread, NULL, bench_producer, &producer[p]);
+  }
+  for(uint32_t p = 0; p < producers; p++){
+    pthread_join(producer[p].thread, NULL);
+    if(producer[p].worst_ns > worst){
+      worst = producer[p].worst_ns;
+    }
+  }
+  atomic_store(&bench.running, 0);
+  if(use_txq){
+    pthread_join(io, NULL);
+  }
+  seconds = (bench_ns() - start) / 1e9;
+
+  if(bench.hc_08.stats.tx_bytes != (uint32_t)total * BENCH_MESSAGE){
+    printf("lost data: %u of %u bytes\n", bench.hc_08.stats.tx_bytes, total * BENCH_MESSAGE);
+  }
+  printf("%-6s %9u %14.0f %10u %10.1f %10u %12.1f\n", use_txq ? "txq" : "mutex", producers, total / seconds,
+         bench.writes, (double)total / bench.writes, use_txq ? (uint32_t)atomic_load(&bench.txq.full) : 0,
+         worst / 1000.0);
+  pthread_mutex_destroy(&bench.lock);
+}
+
+int main(int argc, char **argv){
+  uint32_t messages = argc > 1 ? (uint32_t)atoi(argv[1]) : 200000;
+
+  null_fd = open("/dev/null", O_WRONLY);
+  if(null_fd < 0){
+    perror("/dev/null");
+    return 1;
+  }
+  printf("%-6s %9s %14s %10s %10s %10s %12s\n", "queue", "producers", "messages/s", "writes", "msg/write",
+         "full", "worst us");
+  for(uint32_t producers = 1; producers <= BENCH_PRODUCERS; producers *= 2){
+    bench_run(0, producers, messages);
+    bench_run(1, producers, messages);
+  }
+  close(null_fd);
+  return 0;
+}
@@ -0,0 +1,147 @@
+#include "hc-08-adv.h"
+#include <string.h>
+
+/**
+  * @brief  Starting a burst at the fast interval
+  * @param  *adv pointer to the scheduler structure
+  * @param  now current tick
+  */
+static void hc_08_adv_start(hc_08_adv_ST *adv, uint32_t now){
+  adv->start_tick = now;
+  adv->discovering = 1;
+  adv->metrics.bursts++;
+}
+
+/**
+  * @brief  Sending the interval to the module and checking the answer
+  * @param  *adv pointer to the scheduler structure
+  * @param  aint interval, 0.625 ms units
+  * @param  now current tick
+  */
+static void hc_08_adv_apply(hc_08_adv_ST *adv, uint16_t aint, uint32_t now){
+  adv->write_tick = now;
+  if(hc_08_cmd_set_aint(adv->hc_08, aint) == hc_08_status_ok){
+    hc_08_read_answer(adv->hc_08);
+    if(hc_08_check_set(adv->hc_08) == hc_08_status_ok){
+      adv->aint = aint;
+      adv->hc_08->param.aint = aint;
+      adv->failed = 0;
+      adv->metrics.writes++;
+      return;
+    }
+  }
+  adv->failed = 1;
+  adv->metrics.rejected++;
+}
+
+/**
+  * @brief  Initialization of the advertising interval scheduler. A burst starts at once,
+  *         as after a boot
+  * @param  *adv pointer to the scheduler structure
+  * @param  *hc_08 pointer to the HC-08 module structure. A tick source must be registered
+  *           with hc_08_reg_tick_cbfunc(...)
+  * @param  fast advertising interval of a burst, 32~16000 (0.625 ms units)
+  * @param  slow advertising interval at the end of the curve, 32~16000
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if an interval is out of range or fast is slower than slow
+  */
+hc_08_status hc_08_adv_init(hc_08_adv_ST *adv, hc_08_ST *hc_08, uint16_t fast, uint16_t slow){
+  if(fast < HC_08_AINT_MIN || slow > HC_08_AINT_MAX || fast > slow){
+    return hc_08_status_error;
+  }
+
+  memset(adv, 0, sizeof(*adv));
+  adv->hc_08 = hc_08;
+
+  adv->cfg.fast = fast;
+  adv->cfg.slow = slow;
+  adv->cfg.burst = HC_08_ADV_BURST;
+  adv->cfg.step = HC_08_ADV_STEP;
+  adv->cfg.growth = HC_08_ADV_GROWTH;
+  adv->cfg.increment = HC_08_ADV_INCREMENT;
+  adv->cfg.retry = HC_08_ADV_RETRY;
+
+  adv->process_tick = hc_08_get_tick(hc_08);
+  adv->last_connect = hc_08->status_connect;
+  hc_08_adv_start(adv, adv->process_tick);
+
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Starting a burst on request of the application (e.g. a button press)
+  * @param  *adv pointer to the scheduler structure
+  */
+void hc_08_adv_trigger(hc_08_adv_ST *adv){
+  hc_08_adv_start(adv, hc_08_get_tick(adv->hc_08));
+}
+
+/**
+  * @brief  Advertising interval of the curve at a time after the start of a burst
+  * @param  *adv pointer to the scheduler structure
+  * @param  elapsed ms since the start of the burst
+  * @retval interval, 0.625 ms units
+  */
+uint16_t hc_08_adv_interval(const hc_08_adv_ST *adv, uint32_t elapsed){
+  uint32_t aint = adv->cfg.fast;
+  uint32_t steps;
+
+  if(elapsed < adv->cfg.burst){
+    return adv->cfg.fast;
+  }
+  steps = adv->cfg.step ? (elapsed - adv->cfg.burst) / adv->cfg.step + 1 : UINT32_MAX;
+  for(uint32_t i = 0; i < steps && aint < adv->cfg.slow; i++){
+    uint32_t next = aint * adv->cfg.growth / 100 + adv->cfg.increment;
+
+    if(next <= aint){
+      break;
+    }
+    aint = next;
+  }
+  return (uint16_t)(aint < adv->cfg.slow ? aint : adv->cfg.slow);
+}
+
+/**
+  * @brief  Scheduler step. Must be called periodically from the main loop, and is best
+  *         called soon after hc_08->status_connect changes. A disconnection starts a burst.
+  *         Blocks only to write AT+AINT
+  * @param  *adv pointer to the scheduler structure
+  */
+void hc_08_adv_process(hc_08_adv_ST *adv){
+  uint32_t now = hc_08_get_tick(adv->hc_08);
+  hc_08_status_connect connect = adv->hc_08->status_connect;
+  uint16_t aint;
+
+  if(adv->last_connect != hc_08_status_connected && adv->aint != 0){
+    uint64_t us = adv->event_us + (uint64_t)(now - adv->process_tick) * 1000;
+
+    adv->metrics.adv_time += now - adv->process_tick;
+    adv->metrics.adv_events += (uint32_t)(us / ((uint32_t)adv->aint * 625));
+    adv->event_us = (uint32_t)(us % ((uint32_t)adv->aint * 625));
+  }
+  adv->process_tick = now;
+
+  if(connect == hc_08_status_connected && adv->last_connect != hc_08_status_connected && adv->discovering){
+    uint32_t discovery = now - adv->start_tick;
+
+    adv->discovering = 0;
+    adv->metrics.connects++;
+    adv->metrics.discovery_last = discovery;
+    adv->metrics.discovery_sum += discovery;
+    if(discovery > adv->metrics.discovery_max){
+      adv->metrics.discovery_max = discovery;
+    }
+  }else if(connect != hc_08_status_connected && adv->last_connect == hc_08_status_connected){
+    hc_08_adv_start(adv, now);
+  }
+  adv->last_connect = connect;
+
+  if(connect == hc_08_status_connected){
+    return;
+  }
+  aint = hc_08_adv_interval(adv, now - adv->start_tick);
+  if(aint != adv->aint && (!adv->failed || now - adv->write_tick >= adv->cfg.retry)){
+    hc_08_adv_apply(adv, aint, now);
+  }
+}
@@ -0,0 +1,62 @@
+#ifndef HC_08_ADV_H
+#define HC_08_ADV_H
+
+#include "hc-08.h"
+
+#define HC_08_ADV_BURST       30000  // ms at the fast interval after a boot, a disconnection or a trigger
+#define HC_08_ADV_STEP        10000  // ms between two steps toward the slow interval
+#define HC_08_ADV_GROWTH      200    // %, each step multiplies the interval...
+#define HC_08_ADV_INCREMENT   0      // ...and adds this (0.625 ms units)
+#define HC_08_ADV_RETRY       1000   // ms before a rejected AT+AINT is sent again
+
+/*
+ * Advertising interval scheduler: the fast interval for cfg.burst after the boot, after a
+ * disconnection and after hc_08_adv_trigger(...), then one step every cfg.step along
+ * aint = aint * cfg.growth / 100 + cfg.increment (growth 100 gives a straight line) until
+ * the slow interval. The interval is written with AT+AINT while not connected, the only
+ * time the module advertises and accepts AT commands. metrics has the time from the start
+ * of a burst to the connection (time to discovery) and the advertising events while not
+ * connected, the main part of the idle power.
+ * Needs a tick source (hc_08_reg_tick_cbfunc).
+ */
+typedef struct{
+  hc_08_ST *hc_08;
+
+  struct{
+    uint16_t fast;                   // 0.625 ms units, 32~16000
+    uint16_t slow;
+    uint32_t burst;
+    uint32_t step;
+    uint16_t growth;
+    uint16_t increment;
+    uint32_t retry;
+  }cfg;
+
+  uint16_t aint;                     // written to the module, 0 before the first write
+  uint32_t start_tick;               // start of the burst
+  uint32_t process_tick;
+  uint32_t write_tick;
+  uint32_t event_us;                 // advertising time not yet counted as an event
+  uint8_t failed;                    // the last AT+AINT was rejected
+  uint8_t discovering;               // the time to discovery is being measured
+  hc_08_status_connect last_connect;
+
+  struct{
+    uint32_t bursts;
+    uint32_t connects;
+    uint32_t discovery_last;         // ms from the start of the burst to the connection
+    uint32_t discovery_max;
+    uint64_t discovery_sum;
+    uint32_t adv_time;               // ms not connected
+    uint32_t adv_events;             // advertising events sent in that time
+    uint32_t writes;
+    uint32_t rejected;
+  }metrics;
+}hc_08_adv_ST;
+
+hc_08_status hc_08_adv_init(hc_08_adv_ST *adv, hc_08_ST *hc_08, uint16_t fast, uint16_t slow);
+void hc_08_adv_trigger(hc_08_adv_ST *adv);
+void hc_08_adv_process(hc_08_adv_ST *adv);
+uint16_t hc_08_adv_interval(const hc_08_adv_ST *adv, uint32_t elapsed);
+
+#endif /* HC_08_ADV_H */
@@ -0,0 +1,174 @@
+#include "hc-08-avda.h"
+#include <string.h>
+
+static const char hc_08_avda_alphabet[64] =
+  "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+/**
+  * @brief  Value of one character of the alphabet
+  * @retval 0..63, 0xff for other characters
+  */
+static uint8_t hc_08_avda_value(char c){
+  if(c >= 'A' && c <= 'Z'){
+    return c - 'A';
+  }
+  if(c >= 'a' && c <= 'z'){
+    return c - 'a' + 26;
+  }
+  if(c >= '0' && c <= '9'){
+    return c - '0' + 52;
+  }
+  if(c == '-'){
+    return 62;
+  }
+  if(c == '_'){
+    return 63;
+  }
+  return 0xff;
+}
+
+/**
+  * @brief  Encoding binary data into advertising data characters, 6 bits per character
+  * @param  *data binary data
+  * @param  size 1 to HC_08_AVDA_DATA_SIZE bytes
+  * @param  *text buffer of at least HC_08_AVDA_MAX_LENGHT + 1 characters, NUL terminated
+  * @retval number of characters, 0 if size is out of range
+  */
+uint8_t hc_08_avda_encode(const uint8_t *data, uint8_t size, char *text){
+  uint32_t bits = 0;
+  uint8_t count = 0;
+  uint8_t length = 0;
+
+  if(size == 0 || size > HC_08_AVDA_DATA_SIZE){
+    return 0;
+  }
+  for(uint8_t i = 0; i < size; i++){
+    bits = (bits << 8) | data[i];
+    count += 8;
+    while(count >= 6){
+      count -= 6;
+      text[length++] = hc_08_avda_alphabet[(bits >> count) & 0x3f];
+    }
+  }
+  if(count > 0){
+    text[length++] = hc_08_avda_alphabet[(bits << (6 - count)) & 0x3f];
+  }
+  text[length] = '\0';
+  return length;
+}
+
+/**
+  * @brief  Decoding advertising data written by hc_08_avda_encode(...), e.g. on the scanner
+  * @param  *text advertising data characters
+  * @param  length number of characters
+  * @param  *data buffer of at least HC_08_AVDA_DATA_SIZE bytes
+  * @retval number of bytes, 0 if the text has other characters or is too long
+  */
+uint8_t hc_08_avda_decode(const char *text, uint8_t length, uint8_t *data){
+  uint32_t bits = 0;
+  uint8_t count = 0;
+  uint8_t size = 0;
+
+  if(length == 0 || length > HC_08_AVDA_MAX_LENGHT){
+    return 0;
+  }
+  for(uint8_t i = 0; i < length; i++){
+    uint8_t value = hc_08_avda_value(text[i]);
+
+    if(value == 0xff){
+      return 0;
+    }
+    bits = (bits << 6) | value;
+    count += 6;
+    if(count >= 8){
+      count -= 8;
+      data[size++] = (uint8_t)(bits >> count);
+    }
+  }
+  return size;
+}
+
+/**
+  * @brief  Initialization of the publisher
+  * @param  *avda pointer to the publisher structure
+  * @param  *hc_08 pointer to the HC-08 module structure. A tick source must be registered
+  *           with hc_08_reg_tick_cbfunc(...)
+  */
+void hc_08_avda_init(hc_08_avda_ST *avda, hc_08_ST *hc_08){
+  memset(avda, 0, sizeof(*avda));
+  avda->hc_08 = hc_08;
+  avda->cfg.interval = HC_08_AVDA_INTERVAL;
+  avda->window_tick = hc_08_get_tick(hc_08);
+}
+
+/**
+  * @brief  Handing over the newest sample. Never blocks; the sample is sent by
+  *         hc_08_avda_process(...) unless a newer one replaces it first
+  * @param  *avda pointer to the publisher structure
+  * @param  *data binary sample
+  * @param  size 1 to HC_08_AVDA_DATA_SIZE bytes
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if size is out of range
+  */
+hc_08_status hc_08_avda_submit(hc_08_avda_ST *avda, const uint8_t *data, uint8_t size){
+  char text[HC_08_AVDA_MAX_LENGHT + 1];
+
+  if(hc_08_avda_encode(data, size, text) == 0){
+    return hc_08_status_error;
+  }
+  avda->metrics.submitted++;
+  if(avda->has_pending){
+    avda->metrics.replaced++;
+  }
+  if(strcmp(text, avda->published) == 0){
+    avda->has_pending = 0;
+    avda->metrics.unchanged++;
+    return hc_08_status_ok;
+  }
+  strcpy(avda->pending, text);
+  avda->has_pending = 1;
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Processing of the publisher, called from the main loop. Sends the pending sample
+  *         (one AT exchange) when the rate limit allows it
+  * @param  *avda pointer to the publisher structure
+  */
+void hc_08_avda_process(hc_08_avda_ST *avda){
+  hc_08_ST *hc_08 = avda->hc_08;
+  uint32_t now = hc_08_get_tick(hc_08);
+  uint32_t interval = avda->cfg.interval;
+  uint32_t advertising = (uint32_t)hc_08->param.aint * 5 / 8;
+
+  if(now - avda->window_tick >= HC_08_AVDA_RATE_WINDOW){
+    avda->metrics.rate = avda->window_updates * 1000 / (now - avda->window_tick);
+    avda->window_updates = 0;
+    avda->window_tick = now;
+  }
+
+  if(advertising > interval){
+    interval = advertising;
+  }
+  if(!avda->has_pending || hc_08->status_connect != hc_08_status_not_connected ||
+      (avda->metrics.published + avda->metrics.rejected > 0 && now - avda->publish_tick < interval)){
+    return;
+  }
+
+  // a rejected sample stays pending and is tried again after the interval
+  avda->publish_tick = now;
+  if(hc_08_cmd_set_avda(hc_08, avda->pending) != hc_08_status_ok){
+    avda->metrics.rejected++;
+    return;
+  }
+  hc_08_read_answer(hc_08);
+  if(hc_08_check_set(hc_08) != hc_08_status_ok){
+    avda->metrics.rejected++;
+    return;
+  }
+  strcpy(avda->published, avda->pending);
+  avda->has_pending = 0;
+  avda->metrics.published++;
+  avda->window_updates++;
+}
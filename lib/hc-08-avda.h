@@ -0,0 +1,50 @@
+#ifndef HC_08_AVDA_H
+#define HC_08_AVDA_H
+
+#include "hc-08.h"
+
+#define HC_08_AVDA_DATA_SIZE    9      // binary bytes that fit HC_08_AVDA_MAX_LENGHT characters
+#define HC_08_AVDA_INTERVAL     100    // ms, minimum time between two updates
+#define HC_08_AVDA_RATE_WINDOW  1000   // ms over which updates per second are counted
+
+/*
+ * Broadcast publisher over AT+AVDA. Samples are binary, encoded 6 bits per character
+ * (A-Z a-z 0-9 - _), so 9 bytes fit the 12 characters of the advertising data.
+ * Only the newest sample is kept: a sample submitted before the previous one was sent
+ * replaces it. A sample equal to the data already advertised is not sent again, and
+ * updates are not sent faster than cfg.interval or than one per advertising interval
+ * (hc_08->param.aint), since the module could not advertise them anyway.
+ * AT+AVDA only works while hc_08->status_connect is hc_08_status_not_connected.
+ */
+typedef struct{
+  hc_08_ST *hc_08;
+
+  struct{
+    uint32_t interval;
+  }cfg;
+
+  char pending[HC_08_AVDA_MAX_LENGHT + 1];
+  uint8_t has_pending;
+  char published[HC_08_AVDA_MAX_LENGHT + 1];
+  uint32_t publish_tick;
+  uint32_t window_tick;
+  uint32_t window_updates;
+
+  struct{
+    uint32_t submitted;
+    uint32_t published;
+    uint32_t unchanged;      // samples equal to the advertised data
+    uint32_t replaced;       // samples overwritten by a newer one before they were sent
+    uint32_t rejected;       // AT+AVDA not answered with OK
+    uint32_t rate;           // updates per second in the last full window
+  }metrics;
+}hc_08_avda_ST;
+
+uint8_t hc_08_avda_encode(const uint8_t *data, uint8_t size, char *text);
+uint8_t hc_08_avda_decode(const char *text, uint8_t length, uint8_t *data);
+
+void hc_08_avda_init(hc_08_avda_ST *avda, hc_08_ST *hc_08);
+hc_08_status hc_08_avda_submit(hc_08_avda_ST *avda, const uint8_t *data, uint8_t size);
+void hc_08_avda_process(hc_08_avda_ST *avda);
+
+#endif /* HC_08_AVDA_H */
@@ -0,0 +1,161 @@
+#include "hc-08-batch.h"
+#include <string.h>
+
+/**
+  * @brief  Sending the buffer in one burst and updating the delay metrics
+  * @param  *batch pointer to the batching structure
+  * @param  now current tick
+  */
+static void hc_08_batch_send(hc_08_batch_ST *batch, uint32_t now){
+  uint32_t delay = now - batch->first_tick;
+
+  hc_08_uart_tx(batch->hc_08, batch->buff, batch->size);
+  batch->metrics.flushes++;
+  batch->metrics.bytes += batch->size;
+  batch->metrics.delay_sum += (uint64_t)batch->writes * now - batch->write_ticks;
+  if(batch->metrics.writes > 0){
+    batch->metrics.delay_avg = (uint32_t)(batch->metrics.delay_sum / batch->metrics.writes);
+  }
+  if(delay > batch->metrics.delay_max){
+    batch->metrics.delay_max = delay;
+  }
+
+  batch->size = 0;
+  batch->writes = 0;
+  batch->write_ticks = 0;
+  batch->state = hc_08_batch_state_idle;
+}
+
+/**
+  * @brief  Waking the module, or sending at once when it does not sleep. The mode is only
+  *         trusted while it is valid in hc_08->param (hc_08_cmd_set_mode(...) invalidates it),
+  *         otherwise the module is assumed to sleep
+  * @param  *batch pointer to the batching structure
+  * @param  now current tick
+  */
+static void hc_08_batch_start(hc_08_batch_ST *batch, uint32_t now){
+  hc_08_ST *hc_08 = batch->hc_08;
+
+  if(((hc_08->param_valid & (1UL << hc_08_field_mode)) && hc_08->param.mode == hc_08_mode_full) ||
+      batch->cfg.wake_time == 0){
+    hc_08_batch_send(batch, now);
+    return;
+  }
+  hc_08_uart_tx(batch->hc_08, &batch->cfg.wake_byte, 1);
+  batch->metrics.wakeups++;
+  batch->wake_tick = now;
+  batch->state = hc_08_batch_state_waking;
+}
+
+/**
+  * @brief  Initialization of the transmit batching
+  * @param  *batch pointer to the batching structure
+  * @param  *hc_08 pointer to the HC-08 module structure. A tick source must be registered
+  *           with hc_08_reg_tick_cbfunc(...). If hc_08->param does not hold a valid mode and
+  *           the module is not connected, the mode is read from the module (AT+MODE=?)
+  * @param  *buff buffer owned by the caller, valid as long as the batching is used
+  * @param  size buffer size, the largest burst
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if there is no buffer
+  */
+hc_08_status hc_08_batch_init(hc_08_batch_ST *batch, hc_08_ST *hc_08, char *buff, uint16_t size){
+  if(buff == NULL || size == 0){
+    return hc_08_status_error;
+  }
+  memset(batch, 0, sizeof(*batch));
+  batch->hc_08 = hc_08;
+  batch->buff = buff;
+  batch->capacity = size;
+
+  batch->cfg.threshold = HC_08_BATCH_THRESHOLD < size ? HC_08_BATCH_THRESHOLD : size;
+  batch->cfg.deadline = HC_08_BATCH_DEADLINE;
+  batch->cfg.wake_time = HC_08_BATCH_WAKE_TIME;
+  batch->cfg.wake_byte = HC_08_BATCH_WAKE_BYTE;
+
+  if(!(hc_08->param_valid & (1UL << hc_08_field_mode)) && hc_08->status_connect == hc_08_status_not_connected){
+    hc_08_read_field(hc_08, hc_08_field_mode);
+  }
+  batch->start_tick = hc_08_get_tick(hc_08);
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Adding data to the next burst. Never blocks and never wakes the module itself,
+  *         hc_08_batch_process(...) does
+  * @param  *batch pointer to the batching structure
+  * @param  *data data to send
+  * @param  size data size
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if the data does not fit the free space. A flush is started,
+  *             write again after the next hc_08_batch_process(...)
+  */
+hc_08_status hc_08_batch_write(hc_08_batch_ST *batch, const char *data, uint16_t size){
+  uint32_t now = hc_08_get_tick(batch->hc_08);
+
+  if(size == 0){
+    return hc_08_status_ok;
+  }
+  if(size > batch->capacity - batch->size){
+    batch->metrics.overflows++;
+    if(batch->size > 0 && batch->state == hc_08_batch_state_idle){
+      hc_08_batch_start(batch, now);
+    }
+    return hc_08_status_error;
+  }
+
+  if(batch->size == 0){
+    batch->first_tick = now;
+  }
+  memcpy(batch->buff + batch->size, data, size);
+  batch->size += size;
+  batch->writes++;
+  batch->write_ticks += now;
+  batch->metrics.writes++;
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Sending the waiting data without waiting for the threshold or the deadline,
+  *         e.g. before the module is disconnected or switched off. The burst itself still
+  *         follows the wake time, so call hc_08_batch_process(...) until batch->size is 0
+  * @param  *batch pointer to the batching structure
+  */
+void hc_08_batch_flush(hc_08_batch_ST *batch){
+  if(batch->size > 0 && batch->state == hc_08_batch_state_idle){
+    hc_08_batch_start(batch, hc_08_get_tick(batch->hc_08));
+  }
+}
+
+/**
+  * @brief  Processing of the batching, called from the main loop. Never blocks
+  * @param  *batch pointer to the batching structure
+  */
+void hc_08_batch_process(hc_08_batch_ST *batch){
+  uint32_t now = hc_08_get_tick(batch->hc_08);
+
+  if(batch->state == hc_08_batch_state_waking){
+    if(now - batch->wake_tick >= batch->cfg.wake_time){
+      hc_08_batch_send(batch, now);
+    }
+    return;
+  }
+  if(batch->size > 0 && (batch->size >= batch->cfg.threshold || now - batch->first_tick >= batch->cfg.deadline)){
+    hc_08_batch_start(batch, now);
+  }
+}
+
+/**
+  * @brief  Wakeups since the initialization, scaled to one hour
+  * @param  *batch pointer to the batching structure
+  * @retval wakeups per hour, 0 before the first second
+  */
+uint32_t hc_08_batch_wakeups_per_hour(hc_08_batch_ST *batch){
+  uint32_t elapsed = hc_08_get_tick(batch->hc_08) - batch->start_tick;
+
+  if(elapsed < 1000){
+    return 0;
+  }
+  return (uint32_t)((uint64_t)batch->metrics.wakeups * 3600000UL / elapsed);
+}
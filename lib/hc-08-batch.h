@@ -0,0 +1,63 @@
+#ifndef HC_08_BATCH_H
+#define HC_08_BATCH_H
+
+#include "hc-08.h"
+
+#define HC_08_BATCH_THRESHOLD   0x60   // bytes that trigger a flush (limited to the buffer size)
+#define HC_08_BATCH_DEADLINE    1000   // ms, longest time a byte waits in the buffer
+#define HC_08_BATCH_WAKE_TIME   10     // ms between the wake byte and the data
+#define HC_08_BATCH_WAKE_BYTE   0x00   // byte that wakes the module, the peer should drop it
+
+typedef enum{
+  hc_08_batch_state_idle = 0,
+  hc_08_batch_state_waking,
+}hc_08_batch_state;
+
+/*
+ * Transmit batching for the sleep modes (hc_08_mode_level_1 and level_2). Every UART write
+ * wakes a sleeping module, so data is collected in a buffer owned by the caller and sent in
+ * one burst when cfg.threshold bytes are waiting or the oldest byte is cfg.deadline old.
+ * Before the burst the module is woken with cfg.wake_byte and given cfg.wake_time to start
+ * its UART; bytes written meanwhile join the burst. In hc_08_mode_full the burst is sent
+ * without the wake byte; the mode is taken from hc_08->param while it is valid there, read
+ * by hc_08_batch_init(...) when it is not, and assumed to be a sleep mode if unknown. Needs a tick source (hc_08_reg_tick_cbfunc).
+ */
+typedef struct{
+  hc_08_ST *hc_08;
+  char *buff;
+  uint16_t capacity;
+  uint16_t size;
+
+  struct{
+    uint16_t threshold;
+    uint32_t deadline;
+    uint32_t wake_time;
+    char wake_byte;
+  }cfg;
+
+  hc_08_batch_state state;
+  uint32_t first_tick;       // write of the oldest byte in the buffer
+  uint32_t wake_tick;
+  uint32_t start_tick;
+  uint32_t writes;           // writes waiting in the buffer
+  uint64_t write_ticks;      // sum of their ticks
+
+  struct{
+    uint32_t writes;
+    uint32_t bytes;
+    uint32_t flushes;
+    uint32_t wakeups;
+    uint32_t overflows;      // writes refused because the buffer was full
+    uint32_t delay_avg;      // ms from a write to its burst, average over all writes
+    uint32_t delay_max;      // ms
+    uint64_t delay_sum;
+  }metrics;
+}hc_08_batch_ST;
+
+hc_08_status hc_08_batch_init(hc_08_batch_ST *batch, hc_08_ST *hc_08, char *buff, uint16_t size);
+hc_08_status hc_08_batch_write(hc_08_batch_ST *batch, const char *data, uint16_t size);
+void hc_08_batch_flush(hc_08_batch_ST *batch);
+void hc_08_batch_process(hc_08_batch_ST *batch);
+uint32_t hc_08_batch_wakeups_per_hour(hc_08_batch_ST *batch);
+
+#endif /* HC_08_BATCH_H */
@@ -0,0 +1,98 @@
+#include "hc-08-cache.h"
+#include <string.h>
+
+/**
+  * @brief  Initialization of the cache. All fields start invalid
+  * @param  *cache pointer to the cache structure
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  ttl ms a value is trusted (HC_08_CACHE_TTL, HC_08_CACHE_TTL_FOREVER, 0 to always ask).
+  *           Without a tick source (hc_08_reg_tick_cbfunc) values never expire by age
+  */
+void hc_08_cache_init(hc_08_cache_ST *cache, hc_08_ST *hc_08, uint32_t ttl){
+  memset(cache, 0, sizeof(*cache));
+  cache->hc_08 = hc_08;
+  for(uint8_t i = 0; i < HC_08_FIELD_SIZE; i++){
+    cache->ttl[i] = ttl;
+  }
+  hc_08->param_valid = 0;
+}
+
+/**
+  * @brief  Changing the TTL of one field, e.g. HC_08_CACHE_TTL_FOREVER for the address
+  * @param  *cache pointer to the cache structure
+  * @param  field the field
+  * @param  ttl ms
+  */
+void hc_08_cache_set_ttl(hc_08_cache_ST *cache, hc_08_field field, uint32_t ttl){
+  if((unsigned int)field < HC_08_FIELD_SIZE){
+    cache->ttl[field] = ttl;
+  }
+}
+
+/**
+  * @brief  Asking the module for a field now, whatever the state of the cache
+  * @param  *cache pointer to the cache structure
+  * @param  field the field
+  * @retval hc_08_status:
+  *             hc_08_status_ok, the value is in hc_08->param
+  *             hc_08_status_error if the answer could not be parsed (the field stays invalid)
+  */
+hc_08_status hc_08_cache_refresh(hc_08_cache_ST *cache, hc_08_field field){
+  hc_08_ST *hc_08 = cache->hc_08;
+
+  if((unsigned int)field >= HC_08_FIELD_SIZE){
+    return hc_08_status_error;
+  }
+  cache->stats.misses++;
+  if(hc_08_read_field(hc_08, field) != hc_08_status_ok){
+    cache->stats.errors++;
+    return hc_08_status_error;
+  }
+  cache->tick[field] = hc_08_get_tick(hc_08);
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Making sure hc_08->param holds the current value of a field. Asks the module only
+  *         if the field is invalid or older than its TTL
+  * @param  *cache pointer to the cache structure
+  * @param  field the field
+  * @retval hc_08_status:
+  *             hc_08_status_ok, the value is in hc_08->param
+  *             hc_08_status_error if the module had to be asked and the answer could not be parsed
+  */
+hc_08_status hc_08_cache_get(hc_08_cache_ST *cache, hc_08_field field){
+  hc_08_ST *hc_08 = cache->hc_08;
+  uint32_t ttl;
+
+  if((unsigned int)field >= HC_08_FIELD_SIZE){
+    return hc_08_status_error;
+  }
+  ttl = cache->ttl[field];
+  if((hc_08->param_valid & (1UL << field)) && ttl != 0 &&
+      (ttl == HC_08_CACHE_TTL_FOREVER || hc_08->get_tick == NULL ||
+       hc_08_get_tick(hc_08) - cache->tick[field] < ttl)){
+    cache->stats.hits++;
+    return hc_08_status_ok;
+  }
+  return hc_08_cache_refresh(cache, field);
+}
+
+/**
+  * @brief  Forgetting a field, e.g. after it was changed from the other side of the link
+  * @param  *cache pointer to the cache structure
+  * @param  field the field
+  */
+void hc_08_cache_invalidate(hc_08_cache_ST *cache, hc_08_field field){
+  if((unsigned int)field < HC_08_FIELD_SIZE){
+    hc_08_param_invalidate(cache->hc_08, field);
+  }
+}
+
+/**
+  * @brief  Forgetting all fields, e.g. after the module was reset or replaced
+  * @param  *cache pointer to the cache structure
+  */
+void hc_08_cache_invalidate_all(hc_08_cache_ST *cache){
+  cache->hc_08->param_valid = 0;
+}
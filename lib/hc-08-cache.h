@@ -0,0 +1,33 @@
+#ifndef HC_08_CACHE_H
+#define HC_08_CACHE_H
+
+#include "hc-08.h"
+
+#define HC_08_CACHE_TTL           60000        // ms a value read from the module is trusted
+#define HC_08_CACHE_TTL_FOREVER   0xFFFFFFFF   // kept until a set command or hc_08_cache_invalidate(...)
+
+/*
+ * Read-through cache over hc_08->param. hc_08_cache_get(...) only asks the module when
+ * the field was never read, was written by a set command or is older than its TTL;
+ * the value is then read from hc_08->param as usual.
+ */
+typedef struct{
+  hc_08_ST *hc_08;
+  uint32_t ttl[HC_08_FIELD_SIZE];
+  uint32_t tick[HC_08_FIELD_SIZE];
+
+  struct{
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t errors;
+  }stats;
+}hc_08_cache_ST;
+
+void hc_08_cache_init(hc_08_cache_ST *cache, hc_08_ST *hc_08, uint32_t ttl);
+void hc_08_cache_set_ttl(hc_08_cache_ST *cache, hc_08_field field, uint32_t ttl);
+hc_08_status hc_08_cache_get(hc_08_cache_ST *cache, hc_08_field field);
+hc_08_status hc_08_cache_refresh(hc_08_cache_ST *cache, hc_08_field field);
+void hc_08_cache_invalidate(hc_08_cache_ST *cache, hc_08_field field);
+void hc_08_cache_invalidate_all(hc_08_cache_ST *cache);
+
+#endif /* HC_08_CACHE_H */
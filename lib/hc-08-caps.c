@@ -0,0 +1,149 @@
+#include "hc-08-caps.h"
+#include <string.h>
+
+#define HC_08_CAPS_FIELDS_V2  (HC_08_FIELD_ALL & ~((1UL << hc_08_field_luuid) | (1UL << hc_08_field_suuid) | \
+                               (1UL << hc_08_field_tuuid) | (1UL << hc_08_field_aust) | (1UL << hc_08_field_led)))
+
+/*
+ * Known firmware, newest first. Only V3.3 (2020-10-16) was tested; the other entries
+ * assume nothing beyond it: later V3 releases get the same commands with more time to
+ * answer, V2 and anything older only the commands of the first datasheets.
+ */
+static const hc_08_caps_entry_ST hc_08_caps_table[] = {
+  {3, 3, HC_08_FIELD_ALL, hc_08_caps_rx | hc_08_caps_avda | hc_08_caps_clear, 10},
+  {3, 0, HC_08_FIELD_ALL, hc_08_caps_rx | hc_08_caps_avda | hc_08_caps_clear, 20},
+  {2, 0, HC_08_CAPS_FIELDS_V2, hc_08_caps_rx | hc_08_caps_clear, 50},
+};
+#define HC_08_CAPS_TABLE_SIZE (sizeof(hc_08_caps_table) / sizeof(hc_08_caps_table[0]))
+
+/**
+  * @brief  Copying an entry of the table and passing its answer wait to the UART layer
+  * @param  *caps pointer to the capability structure
+  * @param  *entry the entry
+  * @param  latency ms, expected answer time
+  */
+static void hc_08_caps_use(hc_08_caps_ST *caps, const hc_08_caps_entry_ST *entry, uint16_t latency){
+  caps->fields = entry->fields;
+  caps->commands = entry->commands;
+  caps->latency = latency;
+  memset(caps->misses, 0, sizeof(caps->misses));
+  if(caps->set_timeout != NULL){
+    caps->set_timeout(caps->ctx, (uint32_t)latency * HC_08_CAPS_MARGIN);
+  }
+}
+
+/**
+  * @brief  Initialization with the most careful entry of the table, until the version is known
+  * @param  *caps pointer to the capability structure
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  set_timeout sets how long the UART layer waits for an answer, in ms (e.g.
+  *           hc_08_posix_set_timeout), NULL to leave it as it is
+  * @param  *ctx user pointer passed to set_timeout
+  */
+void hc_08_caps_init(hc_08_caps_ST *caps, hc_08_ST *hc_08, void (*set_timeout)(void *ctx, uint32_t timeout), void *ctx){
+  memset(caps, 0, sizeof(*caps));
+  caps->hc_08 = hc_08;
+  caps->set_timeout = set_timeout;
+  caps->ctx = ctx;
+  hc_08_caps_use(caps, &hc_08_caps_table[HC_08_CAPS_TABLE_SIZE - 1], HC_08_CAPS_LATENCY_UNKNOWN);
+}
+
+/**
+  * @brief  Choosing the capabilities of a version: the newest entry of the table that is not
+  *         newer than it (a newer firmware is taken to keep the commands of V3.3)
+  * @param  *caps pointer to the capability structure
+  * @param  *version firmware version
+  */
+void hc_08_caps_select(hc_08_caps_ST *caps, const hc_08_version_ST *version){
+  uint16_t code = ((uint16_t)version->major << 8) | version->minor;
+
+  for(uint8_t i = 0; i < HC_08_CAPS_TABLE_SIZE; i++){
+    const hc_08_caps_entry_ST *entry = &hc_08_caps_table[i];
+
+    if((((uint16_t)entry->major << 8) | entry->minor) <= code){
+      hc_08_caps_use(caps, entry, entry->latency);
+      caps->known = entry->major == version->major && entry->minor == version->minor;
+      return;
+    }
+  }
+  hc_08_caps_use(caps, &hc_08_caps_table[HC_08_CAPS_TABLE_SIZE - 1], hc_08_caps_table[HC_08_CAPS_TABLE_SIZE - 1].latency);
+  caps->known = 0;
+}
+
+/**
+  * @brief  Asking the module for its firmware version (AT+VERSION) and choosing its
+  *         capabilities. The version is in hc_08->param.version
+  * @param  *caps pointer to the capability structure
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if the answer could not be parsed, the careful entry is kept
+  */
+hc_08_status hc_08_caps_detect(hc_08_caps_ST *caps){
+  hc_08_ST *hc_08 = caps->hc_08;
+
+  hc_08_cmd_version(hc_08);
+  hc_08_read_answer(hc_08);
+  if(hc_08_parse_version(hc_08, hc_08->uart.rx_size) != hc_08_status_ok){
+    hc_08_caps_init(caps, hc_08, caps->set_timeout, caps->ctx);
+    return hc_08_status_error;
+  }
+  hc_08_caps_select(caps, &hc_08->param.version);
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Checking whether the firmware answers the query of a field
+  * @param  *caps pointer to the capability structure
+  * @param  field the field
+  * @retval 1 if supported
+  */
+uint8_t hc_08_caps_supports(hc_08_caps_ST *caps, hc_08_field field){
+  return (unsigned int)field < HC_08_FIELD_SIZE && (caps->fields & (1UL << field)) != 0;
+}
+
+/**
+  * @brief  hc_08_read_all(...) limited to the commands of the firmware. Fields without a query
+  *         command are not asked; AT+RX is used only if the firmware has it. A query that is
+  *         not answered at all HC_08_CAPS_MISSES times in a row is removed from caps->fields
+  *         (hc_08_caps_select(...) or hc_08_caps_detect(...) restore it)
+  * @param  *caps pointer to the capability structure
+  * @param  fields bits (1 << hc_08_field) of the fields to read
+  * @param  *round_trips number of commands sent, NULL if not needed
+  * @retval hc_08_status:
+  *             hc_08_status_ok if every supported field asked for is now valid
+  *             hc_08_status_error if some are not, see hc_08->param_valid
+  */
+hc_08_status hc_08_caps_read_all(hc_08_caps_ST *caps, uint32_t fields, uint8_t *round_trips){
+  hc_08_ST *hc_08 = caps->hc_08;
+  uint8_t count = 0;
+
+  fields &= HC_08_FIELD_ALL;
+  for(uint8_t field = 0; field < HC_08_FIELD_SIZE; field++){
+    if((fields & (1UL << field)) && !(caps->fields & (1UL << field))){
+      caps->metrics.skipped++;
+    }
+  }
+  fields &= caps->fields;
+  hc_08->param_valid &= ~fields;
+
+  if(caps->commands & hc_08_caps_rx){
+    hc_08_read_all(hc_08, fields & HC_08_FIELD_BASE, &count);
+  }
+  for(uint8_t field = 0; field < HC_08_FIELD_SIZE; field++){
+    if(!(fields & (1UL << field)) || (hc_08->param_valid & (1UL << field))){
+      continue;
+    }
+    count++;
+    if(hc_08_read_field(hc_08, (hc_08_field)field) == hc_08_status_ok || hc_08_rx_received(hc_08) > 0){
+      caps->misses[field] = 0;
+    }else if(++caps->misses[field] >= HC_08_CAPS_MISSES){
+      caps->fields &= ~(1UL << field);
+      caps->metrics.learned++;
+    }
+  }
+
+  if(round_trips != NULL){
+    *round_trips = count;
+  }
+  return (hc_08->param_valid & fields) == fields ? hc_08_status_ok : hc_08_status_error;
+}
@@ -0,0 +1,55 @@
+#ifndef HC_08_CAPS_H
+#define HC_08_CAPS_H
+
+#include "hc-08.h"
+
+#define HC_08_CAPS_LATENCY_UNKNOWN   100   // ms, answer time assumed when AT+VERSION is not understood
+#define HC_08_CAPS_MARGIN            2     // answer wait set through set_timeout, in latencies
+#define HC_08_CAPS_MISSES            3     // unanswered reads in a row before a query is removed
+
+typedef enum{
+  hc_08_caps_rx = 1 << 0,       // AT+RX
+  hc_08_caps_avda = 1 << 1,     // AT+AVDA
+  hc_08_caps_clear = 1 << 2     // AT+CLEAR
+}hc_08_caps_command;
+
+typedef struct{
+  uint8_t major;
+  uint8_t minor;
+  uint32_t fields;      // bits (1 << hc_08_field) with a query command
+  uint8_t commands;     // hc_08_caps_command bits
+  uint16_t latency;     // ms, expected time to the end of an answer
+}hc_08_caps_entry_ST;
+
+/*
+ * Commands supported by the firmware of a module, chosen from its AT+VERSION answer.
+ * Queries the firmware does not know are not sent (an unknown command is not answered
+ * at all, so each costs a full read timeout), and the answer wait of the UART layer is set
+ * from latency through set_timeout. A query left unanswered HC_08_CAPS_MISSES reads in a
+ * row is also removed at run time, so versions missing from the table stop costing
+ * timeouts, while a single lost answer does not disable a query.
+ */
+typedef struct{
+  hc_08_ST *hc_08;
+  uint8_t known;        // version found in the table
+  uint32_t fields;
+  uint8_t commands;
+  uint16_t latency;
+  uint8_t misses[HC_08_FIELD_SIZE];
+
+  void (*set_timeout)(void *ctx, uint32_t timeout);
+  void *ctx;
+
+  struct{
+    uint32_t skipped;   // queries not sent
+    uint32_t learned;   // queries removed after they were not answered
+  }metrics;
+}hc_08_caps_ST;
+
+void hc_08_caps_init(hc_08_caps_ST *caps, hc_08_ST *hc_08, void (*set_timeout)(void *ctx, uint32_t timeout), void *ctx);
+hc_08_status hc_08_caps_detect(hc_08_caps_ST *caps);
+void hc_08_caps_select(hc_08_caps_ST *caps, const hc_08_version_ST *version);
+uint8_t hc_08_caps_supports(hc_08_caps_ST *caps, hc_08_field field);
+hc_08_status hc_08_caps_read_all(hc_08_caps_ST *caps, uint32_t fields, uint8_t *round_trips);
+
+#endif /* HC_08_CAPS_H */
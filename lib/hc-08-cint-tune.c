@@ -0,0 +1,163 @@
+#include "hc-08-cint-tune.h"
+#include <string.h>
+
+/**
+  * @brief  Connection interval of a level. Levels are spaced quadratically so the steps
+  *         near the fast end are small and the idle end is reached in a few steps
+  * @param  fast value of level 0
+  * @param  slow value of the last level
+  * @param  level level number
+  */
+static uint16_t hc_08_cint_tune_value(uint16_t fast, uint16_t slow, uint8_t level){
+  uint32_t last = HC_08_CINT_TUNE_LEVELS - 1;
+
+  return (uint16_t)(fast + ((uint32_t)(slow - fast) * level * level) / (last * last));
+}
+
+/**
+  * @brief  Writing the interval of the target level to the module (only while not connected,
+  *         in transparent mode the command would go to the peer) and checking the answer.
+  *         The bytes of the command are not counted as traffic
+  * @param  *tune pointer to the controller structure
+  * @param  now current tick
+  */
+static void hc_08_cint_tune_apply(hc_08_cint_tune_ST *tune, uint32_t now){
+  uint16_t cint_min = hc_08_cint_tune_value(tune->cfg.fast_min, tune->cfg.slow_min, tune->target);
+  uint16_t cint_max = hc_08_cint_tune_value(tune->cfg.fast_max, tune->cfg.slow_max, tune->target);
+  uint32_t tx_bytes = tune->hc_08->stats.tx_bytes;
+  hc_08_status status = hc_08_status_error;
+
+  tune->write_tick = now;
+  if(hc_08_cmd_set_cint_min_max(tune->hc_08, cint_min, cint_max) == hc_08_status_ok){
+    hc_08_read_answer(tune->hc_08);
+    status = hc_08_check_set(tune->hc_08);
+  }
+  tune->last_tx_bytes += tune->hc_08->stats.tx_bytes - tx_bytes;
+  if(status != hc_08_status_ok){
+    tune->metrics.rejected++;
+    return;
+  }
+  tune->level = tune->target;
+  tune->written = 1;
+  tune->hc_08->param.cint_min = cint_min;
+  tune->hc_08->param.cint_max = cint_max;
+  tune->metrics.cint_min = cint_min;
+  tune->metrics.cint_max = cint_max;
+  tune->metrics.reconfigs++;
+}
+
+/**
+  * @brief  Initialization of the adaptive connection interval controller. The controller starts
+  *         at the slow end and narrows the interval as soon as a burst is seen
+  * @param  *tune pointer to the controller structure
+  * @param  *hc_08 pointer to the HC-08 module structure. A tick source must be registered
+  *           with hc_08_reg_tick_cbfunc(...)
+  * @param  fast_min, fast_max connection interval used during bursts, 6~3199
+  * @param  slow_min, slow_max connection interval used when idle, 6~3199
+  * @param  queue_depth returns the number of bytes waiting to be sent, NULL if there is no queue
+  * @param  *ctx user pointer passed to queue_depth
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if the intervals are out of range or fast is slower than slow
+  */
+hc_08_status hc_08_cint_tune_init(hc_08_cint_tune_ST *tune, hc_08_ST *hc_08,
+                                  uint16_t fast_min, uint16_t fast_max,
+                                  uint16_t slow_min, uint16_t slow_max,
+                                  uint16_t (*queue_depth)(void *ctx), void *ctx){
+  if(fast_min < HC_08_CINT_MIN || slow_max > HC_08_CINT_MAX ||
+      fast_min > fast_max || slow_min > slow_max ||
+      fast_min > slow_min || fast_max > slow_max){
+    return hc_08_status_error;
+  }
+
+  memset(tune, 0, sizeof(*tune));
+  tune->hc_08 = hc_08;
+  tune->queue_depth = queue_depth;
+  tune->ctx = ctx;
+
+  tune->cfg.fast_min = fast_min;
+  tune->cfg.fast_max = fast_max;
+  tune->cfg.slow_min = slow_min;
+  tune->cfg.slow_max = slow_max;
+  tune->cfg.period = HC_08_CINT_TUNE_PERIOD;
+  tune->cfg.rate_high = HC_08_CINT_TUNE_RATE_HIGH;
+  tune->cfg.rate_low = HC_08_CINT_TUNE_RATE_LOW;
+  tune->cfg.depth_high = HC_08_CINT_TUNE_DEPTH_HIGH;
+  tune->cfg.hold = HC_08_CINT_TUNE_HOLD;
+  tune->cfg.idle_hold = HC_08_CINT_TUNE_IDLE_HOLD;
+
+  tune->level = HC_08_CINT_TUNE_LEVELS - 1;
+  tune->target = tune->level;
+  tune->sample_tick = hc_08_get_tick(hc_08);
+  tune->change_tick = tune->sample_tick - tune->cfg.hold;
+  tune->last_tx_bytes = hc_08->stats.tx_bytes;
+
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Controller step. Must be called periodically from the main loop.
+  *         A burst (rate above rate_high or queue deeper than depth_high) switches straight to
+  *         the fastest level. The interval is widened one level at a time after idle_hold of
+  *         low traffic. Two changes of the target are never closer than hold.
+  *         The target is only evaluated between two samples taken while connected: without a
+  *         connection there is no traffic to measure, and the bytes sent meanwhile are AT
+  *         commands. The target is written while the module is not connected (the interval is used
+  *         from the next connection anyway), a rejected write is retried after hold
+  * @param  *tune pointer to the controller structure
+  */
+void hc_08_cint_tune_process(hc_08_cint_tune_ST *tune){
+  uint32_t now = hc_08_get_tick(tune->hc_08);
+  uint32_t elapsed = now - tune->sample_tick;
+  uint32_t rate;
+  uint16_t depth;
+  uint8_t target;
+  uint8_t connected;
+
+  if(elapsed < tune->cfg.period){
+    return;
+  }
+
+  rate = (uint32_t)(((uint64_t)(tune->hc_08->stats.tx_bytes - tune->last_tx_bytes) * 1000) / elapsed);
+  depth = (tune->queue_depth != NULL) ? tune->queue_depth(tune->ctx) : 0;
+  connected = tune->hc_08->status_connect == hc_08_status_connected;
+  tune->last_tx_bytes = tune->hc_08->stats.tx_bytes;
+  tune->sample_tick = now;
+  tune->metrics.level_time[tune->level] += elapsed;
+  tune->metrics.depth = depth;
+
+  target = tune->target;
+  if(!connected || !tune->connected){
+    tune->low = 0;
+  }else{
+    tune->metrics.rate = (tune->metrics.rate * 3 + rate) / 4;
+    if(rate >= tune->cfg.rate_high || depth >= tune->cfg.depth_high){
+      target = 0;
+      tune->low = 0;
+    }else if(tune->metrics.rate < tune->cfg.rate_low && depth == 0){
+      if(!tune->low){
+        tune->low = 1;
+        tune->low_since = now;
+      }else if(now - tune->low_since >= tune->cfg.idle_hold && tune->target < HC_08_CINT_TUNE_LEVELS - 1){
+        target = tune->target + 1;
+      }
+    }else{
+      tune->low = 0;
+    }
+  }
+
+  if(target != tune->target && now - tune->change_tick >= tune->cfg.hold){
+    tune->target = target;
+    tune->change_tick = now;
+    tune->low_since = now;
+  }
+  tune->connected = connected;
+
+  if(tune->hc_08->status_connect != hc_08_status_not_connected ||
+      (tune->written && tune->target == tune->level)){
+    return;
+  }
+  if(tune->metrics.rejected == 0 || now - tune->write_tick >= tune->cfg.hold){
+    hc_08_cint_tune_apply(tune, now);
+  }
+}
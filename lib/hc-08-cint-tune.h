@@ -0,0 +1,61 @@
+#ifndef HC_08_CINT_TUNE_H
+#define HC_08_CINT_TUNE_H
+
+#include "hc-08.h"
+
+#define HC_08_CINT_TUNE_LEVELS      4
+
+#define HC_08_CINT_TUNE_PERIOD      100    // ms between traffic samples
+#define HC_08_CINT_TUNE_RATE_HIGH   1000   // B/s, narrow above this rate
+#define HC_08_CINT_TUNE_RATE_LOW    100    // B/s, widen below this rate
+#define HC_08_CINT_TUNE_DEPTH_HIGH  64     // bytes waiting in the TX queue
+#define HC_08_CINT_TUNE_HOLD        2000   // ms, minimum time between two reconfigurations
+#define HC_08_CINT_TUNE_IDLE_HOLD   5000   // ms of low traffic before widening one level
+
+typedef struct{
+  hc_08_ST *hc_08;
+  uint16_t (*queue_depth)(void *ctx);
+  void *ctx;
+
+  struct{
+    uint16_t fast_min;
+    uint16_t fast_max;
+    uint16_t slow_min;
+    uint16_t slow_max;
+    uint32_t period;
+    uint32_t rate_high;
+    uint32_t rate_low;
+    uint16_t depth_high;
+    uint32_t hold;
+    uint32_t idle_hold;
+  }cfg;
+
+  uint8_t level;                  // level written to the module
+  uint8_t target;                 // level chosen from the traffic, written once not connected
+  uint8_t written;
+  uint32_t sample_tick;
+  uint32_t last_tx_bytes;
+  uint32_t change_tick;
+  uint32_t write_tick;
+  uint32_t low_since;
+  uint8_t low;
+  uint8_t connected;              // the last sample was taken while connected
+
+  struct{
+    uint16_t cint_min;
+    uint16_t cint_max;
+    uint32_t rate;
+    uint16_t depth;
+    uint32_t reconfigs;
+    uint32_t rejected;
+    uint32_t level_time[HC_08_CINT_TUNE_LEVELS];
+  }metrics;
+}hc_08_cint_tune_ST;
+
+hc_08_status hc_08_cint_tune_init(hc_08_cint_tune_ST *tune, hc_08_ST *hc_08,
+                                  uint16_t fast_min, uint16_t fast_max,
+                                  uint16_t slow_min, uint16_t slow_max,
+                                  uint16_t (*queue_depth)(void *ctx), void *ctx);
+void hc_08_cint_tune_process(hc_08_cint_tune_ST *tune);
+
+#endif /* HC_08_CINT_TUNE_H */
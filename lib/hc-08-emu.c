@@ -0,0 +1,433 @@
+#include "hc-08-emu.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static const uint32_t hc_08_emu_baud_value[] = {
+  [hc_08_baud_1200bps] = 1200,
+  [hc_08_baud_2400bps] = 2400,
+  [hc_08_baud_4800bps] = 4800,
+  [hc_08_baud_9600bps] = 9600,
+  [hc_08_baud_19200bps] = 19200,
+  [hc_08_baud_38400bps] = 38400,
+  [hc_08_baud_57600bps] = 57600,
+  [hc_08_baud_115200bps] = 115200
+};
+
+/**
+  * @brief  Factory settings of the module (AT+DEFAULT)
+  * @param  *emu pointer to the emulator structure
+  */
+static void hc_08_emu_default(hc_08_emu_ST *emu){
+  static const uint8_t addres[6] = {0x3C, 0xE4, 0xB0, 0x89, 0xDC, 0x03};
+
+  strcpy(emu->param.name, "HC-08");
+  emu->param.role = hc_08_role_slave;
+  emu->param.baud = hc_08_baud_9600bps;
+  emu->param.parity = hc_08_parity_bit_no_parity;
+  memcpy(emu->param.addres, addres, sizeof(emu->param.addres));
+  strcpy(emu->param.pin, "000000");
+  emu->param.rfpm = hc_08_rfpm_4dBm;
+  emu->param.cont = hc_08_cont_0;
+  emu->param.mode = hc_08_mode_full;
+  emu->param.aint = 320;
+  emu->param.cint_min = 6;
+  emu->param.cint_max = 12;
+  emu->param.ctout = 200;
+  emu->param.luuid = 0xFFF0;
+  emu->param.suuid = 0xFFE0;
+  emu->param.tuuid = 0xFFE1;
+  emu->param.aust = 20;
+  emu->param.led = hc_08_led_on;
+}
+
+/**
+  * @brief  Looking up a value in one of the string tables of hc-08.h
+  * @retval index of the value, -1 if not found
+  */
+static int hc_08_emu_lookup(const char * const *table, int table_size, const char *value){
+  for(int i = 0; i < table_size; i++){
+    if(strcmp(table[i], value) == 0){
+      return i;
+    }
+  }
+  return -1;
+}
+
+/**
+  * @brief  Parsing a number in the given base and in the range min..max
+  * @retval hc_08_status_ok if the whole string is a number in range
+  */
+static hc_08_status hc_08_emu_number(const char *value, int base, uint32_t min, uint32_t max, uint16_t *result){
+  char *end;
+  unsigned long number = strtoul(value, &end, base);
+
+  if(end == value || *end != '\0' || number < min || number > max){
+    return hc_08_status_error;
+  }
+  *result = (uint16_t)number;
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Building the answer to a query command
+  * @param  *emu pointer to the emulator structure
+  * @param  *key command name without "AT+" and "=?"
+  * @retval hc_08_status_error for unknown commands
+  */
+static hc_08_status hc_08_emu_query(hc_08_emu_ST *emu, const char *key){
+  char *r = emu->reply;
+  int size = -1;
+
+  if(strcmp(key, "ROLE") == 0){
+    size = sprintf(r, "%s", hc_08_role_c[emu->param.role]);
+  }else if(strcmp(key, "NAME") == 0){
+    size = sprintf(r, "%s", emu->param.name);
+  }else if(strcmp(key, "ADDR") == 0){
+    size = sprintf(r, "%02X,%02X,%02X,%02X,%02X,%02X", emu->param.addres[0], emu->param.addres[1],
+                   emu->param.addres[2], emu->param.addres[3], emu->param.addres[4], emu->param.addres[5]);
+  }else if(strcmp(key, "RFPM") == 0){
+    size = sprintf(r, "RFPM=%s", hc_08_rfpm_c[emu->param.rfpm]);
+  }else if(strcmp(key, "BAUD") == 0){
+    size = sprintf(r, "BAUD=%s,%s", hc_08_baud_c[emu->param.baud], hc_08_parity_bit_c[emu->param.parity]);
+  }else if(strcmp(key, "CONT") == 0){
+    size = sprintf(r, "CONT=%s", hc_08_cont_c[emu->param.cont]);
+  }else if(strcmp(key, "MODE") == 0){
+    size = sprintf(r, "MODE=%s", hc_08_mode_c[emu->param.mode]);
+  }else if(strcmp(key, "AINT") == 0){
+    size = sprintf(r, "AINT=%u", (unsigned int)emu->param.aint);
+  }else if(strcmp(key, "CINT") == 0){
+    size = sprintf(r, "CINT=%u,%u", (unsigned int)emu->param.cint_min, (unsigned int)emu->param.cint_max);
+  }else if(strcmp(key, "CTOUT") == 0){
+    size = sprintf(r, "CTOUT=%u", (unsigned int)emu->param.ctout);
+  }else if(strcmp(key, "LED") == 0){
+    size = sprintf(r, "LED=%s", hc_08_led_c[emu->param.led]);
+  }else if(strcmp(key, "LUUID") == 0){
+    size = sprintf(r, "LUUID=%04X", (unsigned int)emu->param.luuid);
+  }else if(strcmp(key, "SUUID") == 0){
+    size = sprintf(r, "SUUID=%04X", (unsigned int)emu->param.suuid);
+  }else if(strcmp(key, "TUUID") == 0){
+    size = sprintf(r, "TUUID=%04X", (unsigned int)emu->param.tuuid);
+  }else if(strcmp(key, "AUST") == 0){
+    size = sprintf(r, "AUST=%u", (unsigned int)emu->param.aust);
+  }
+
+  if(size < 0){
+    return hc_08_status_error;
+  }
+  emu->reply_size = (uint16_t)size;
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Executing a set command
+  * @param  *emu pointer to the emulator structure
+  * @param  *key command name without "AT+" and "="
+  * @param  *value the value after "="
+  * @retval hc_08_status_error for unknown commands and invalid values
+  */
+static hc_08_status hc_08_emu_set(hc_08_emu_ST *emu, const char *key, char *value){
+  uint16_t number = 0;
+  int index;
+
+  if(strcmp(key, "ROLE") == 0){
+    if(value[0] == 'M'){
+      emu->param.role = hc_08_role_master;
+    }else if(value[0] == 'S'){
+      emu->param.role = hc_08_role_slave;
+    }else{
+      return hc_08_status_error;
+    }
+  }else if(strcmp(key, "NAME") == 0){
+    if(strlen(value) == 0 || strlen(value) > HC_08_MAX_NAME_LENGHT){
+      return hc_08_status_error;
+    }
+    strcpy(emu->param.name, value);
+  }else if(strcmp(key, "ADDR") == 0){
+    if(strlen(value) != HC_08_ADDRES_LENGHT){
+      return hc_08_status_error;
+    }
+    for(uint8_t i = 0; i < sizeof(emu->param.addres); i++){
+      char byte[3] = {value[i * 2], value[i * 2 + 1], '\0'};
+      if(hc_08_emu_number(byte, 16, 0, 0xff, &number) != hc_08_status_ok){
+        return hc_08_status_error;
+      }
+      emu->param.addres[i] = (uint8_t)number;
+    }
+  }else if(strcmp(key, "RFPM") == 0){
+    if((index = hc_08_emu_lookup(hc_08_rfpm_param_c, HC_08_RFPM_SIZE, value)) < 0){
+      return hc_08_status_error;
+    }
+    emu->param.rfpm = (hc_08_rfpm)index;
+  }else if(strcmp(key, "BAUD") == 0){
+    char *parity = strchr(value, ',');
+    hc_08_parity_bit parity_bit = emu->param.parity;
+
+    if(parity != NULL){
+      *parity++ = '\0';
+      if((index = hc_08_emu_lookup(hc_08_parity_bit_c, HC_08_PARITY_SIZE, parity)) < 0){
+        return hc_08_status_error;
+      }
+      parity_bit = (hc_08_parity_bit)index;
+    }
+    if((index = hc_08_emu_lookup(hc_08_baud_c, HC_08_BAUD_SIZE, value)) < 0){
+      return hc_08_status_error;
+    }
+    emu->param.baud = (hc_08_baud)index;
+    emu->param.parity = parity_bit;
+  }else if(strcmp(key, "CONT") == 0){
+    if((index = hc_08_emu_lookup(hc_08_cont_param_c, HC_08_CONT_SIZE, value)) < 0){
+      return hc_08_status_error;
+    }
+    emu->param.cont = (hc_08_cont)index;
+  }else if(strcmp(key, "MODE") == 0){
+    if((index = hc_08_emu_lookup(hc_08_mode_c, HC_08_MODE_SIZE, value)) < 0){
+      return hc_08_status_error;
+    }
+    emu->param.mode = (hc_08_mode)index;
+  }else if(strcmp(key, "LED") == 0){
+    if((index = hc_08_emu_lookup(hc_08_led_c, HC_08_LED_SIZE, value)) < 0){
+      return hc_08_status_error;
+    }
+    emu->param.led = (hc_08_led)index;
+  }else if(strcmp(key, "AINT") == 0){
+    if(hc_08_emu_number(value, 10, HC_08_AINT_MIN, HC_08_AINT_MAX, &emu->param.aint) != hc_08_status_ok){
+      return hc_08_status_error;
+    }
+  }else if(strcmp(key, "CINT") == 0){
+    char *max = strchr(value, ',');
+    uint16_t cint_max;
+
+    if(max != NULL){
+      *max++ = '\0';
+    }
+    if(hc_08_emu_number(value, 10, HC_08_CINT_MIN, HC_08_CINT_MAX, &number) != hc_08_status_ok){
+      return hc_08_status_error;
+    }
+    cint_max = number;
+    if(max != NULL && hc_08_emu_number(max, 10, number, HC_08_CINT_MAX, &cint_max) != hc_08_status_ok){
+      return hc_08_status_error;
+    }
+    emu->param.cint_min = number;
+    emu->param.cint_max = cint_max;
+  }else if(strcmp(key, "CTOUT") == 0){
+    if(hc_08_emu_number(value, 10, HC_08_CTOUT_MIN, HC_08_CTOUT_MAX, &emu->param.ctout) != hc_08_status_ok){
+      return hc_08_status_error;
+    }
+  }else if(strcmp(key, "AUST") == 0){
+    if(hc_08_emu_number(value, 10, HC_08_AUST_MIN, HC_08_AUST_MAX, &emu->param.aust) != hc_08_status_ok){
+      return hc_08_status_error;
+    }
+  }else if(strcmp(key, "LUUID") == 0){
+    return hc_08_emu_number(value, 16, 0, 0xffff, &emu->param.luuid);
+  }else if(strcmp(key, "SUUID") == 0){
+    return hc_08_emu_number(value, 16, 0, 0xffff, &emu->param.suuid);
+  }else if(strcmp(key, "TUUID") == 0){
+    return hc_08_emu_number(value, 16, 0, 0xffff, &emu->param.tuuid);
+  }else if(strcmp(key, "AVDA") == 0){
+    if(strlen(value) == 0 || strlen(value) > HC_08_AVDA_MAX_LENGHT){
+      return hc_08_status_error;
+    }
+    strcpy(emu->param.avda, value);
+    emu->avda_updates++;
+  }else if(strcmp(key, "PASS") == 0 || strcmp(key, "TYPE") == 0){
+    return hc_08_status_ok;
+  }else{
+    return hc_08_status_error;
+  }
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Checking the command against emu->unsupported
+  * @param  *emu pointer to the emulator structure
+  * @param  *cmd NUL terminated command
+  * @retval 1 if the firmware would not answer it
+  */
+static uint8_t hc_08_emu_unsupported(hc_08_emu_ST *emu, const char *cmd){
+  const char *list = emu->unsupported;
+  size_t length;
+
+  if(list == NULL || strncmp(cmd, HC_08_COMMAND_ATPLUS, strlen(HC_08_COMMAND_ATPLUS)) != 0){
+    return 0;
+  }
+  cmd += strlen(HC_08_COMMAND_ATPLUS);
+  length = strcspn(cmd, "=");
+  while(*list != '\0'){
+    size_t item = strcspn(list, ",");
+
+    if(item == length && strncmp(list, cmd, length) == 0){
+      return 1;
+    }
+    list += item;
+    if(*list == ','){
+      list++;
+    }
+  }
+  return 0;
+}
+
+/**
+  * @brief  Executing one AT command and preparing the answer
+  * @param  *emu pointer to the emulator structure
+  * @param  *cmd NUL terminated command
+  */
+static void hc_08_emu_execute(hc_08_emu_ST *emu, char *cmd){
+  hc_08_status status = hc_08_status_ok;
+  char *value;
+
+  emu->reply_size = 0;
+  emu->commands++;
+  if(hc_08_emu_unsupported(emu, cmd)){
+    return;
+  }
+
+  if(strcmp(cmd, HC_08_COMMAND_AT) == 0 || strcmp(cmd, HC_08_COMMAND_RESET) == 0 ||
+      strcmp(cmd, HC_08_COMMAND_CLEAR) == 0){
+    // answered with OK only
+  }else if(strcmp(cmd, HC_08_COMMAND_DEFAULT) == 0){
+    hc_08_emu_default(emu);
+  }else if(strcmp(cmd, HC_08_COMMAND_VERSION) == 0){
+    emu->reply_size = snprintf(emu->reply, sizeof(emu->reply), "%s", emu->version);
+    return;
+  }else if(strcmp(cmd, HC_08_COMMAND_RX) == 0){
+    emu->reply_size = snprintf(emu->reply, sizeof(emu->reply),
+                               "Name:%s\r\nRole:%s\r\nBaud:%s,%s\r\nAddr:%02X,%02X,%02X,%02X,%02X,%02X\r\nPIN :%s\r\n",
+                               emu->param.name, hc_08_role_c[emu->param.role],
+                               hc_08_baud_c[emu->param.baud], hc_08_parity_bit_c[emu->param.parity],
+                               emu->param.addres[0], emu->param.addres[1], emu->param.addres[2],
+                               emu->param.addres[3], emu->param.addres[4], emu->param.addres[5],
+                               emu->param.pin);
+    return;
+  }else if(strncmp(cmd, HC_08_COMMAND_ATPLUS, strlen(HC_08_COMMAND_ATPLUS)) == 0 &&
+            (value = strchr(cmd, '=')) != NULL){
+    char *key = cmd + strlen(HC_08_COMMAND_ATPLUS);
+
+    *value++ = '\0';
+    if(strcmp(value, HC_08_TEXT_QUERY) == 0){
+      status = hc_08_emu_query(emu, key);
+      if(status == hc_08_status_ok){
+        return;
+      }
+    }else{
+      status = hc_08_emu_set(emu, key, value);
+    }
+  }else{
+    status = hc_08_status_error;
+  }
+
+  if(status == hc_08_status_ok){
+    emu->reply_size = sprintf(emu->reply, "%s", HC_08_TEXT_OK);
+  }else{
+    emu->errors++;
+    emu->reply_size = sprintf(emu->reply, "ERROR");
+  }
+}
+
+/**
+  * @brief  Initialization of the emulator with the factory settings
+  * @param  *emu pointer to the emulator structure
+  */
+void hc_08_emu_init(hc_08_emu_ST *emu){
+  memset(emu, 0, sizeof(*emu));
+  emu->version = HC_08_EMU_VERSION;
+  hc_08_emu_default(emu);
+}
+
+/**
+  * @brief  Binding the emulator to the module structure in place of a real UART
+  * @param  *emu pointer to the emulator structure
+  * @param  *hc_08 pointer to the HC-08 module structure
+  */
+void hc_08_emu_attach(hc_08_emu_ST *emu, hc_08_ST *hc_08){
+  hc_08_reg_uart_cbfunc_ctx(hc_08, hc_08_emu_tx, hc_08_emu_rx, emu);
+}
+
+/**
+  * @brief  UART transmit function of the emulator (see hc_08_reg_uart_cbfunc_ctx)
+  * @param  *ctx pointer to the emulator structure
+  * @param  *buff the command sent to the module
+  * @param  size command length
+  */
+void hc_08_emu_tx(void *ctx, char *buff, uint16_t size){
+  hc_08_emu_ST *emu = (hc_08_emu_ST *)ctx;
+  char cmd[HC_08_EMU_REPLY_SIZE];
+
+  if(size >= sizeof(cmd)){
+    size = sizeof(cmd) - 1;
+  }
+  memcpy(cmd, buff, size);
+  cmd[size] = '\0';
+
+  emu->time_us += (uint64_t)size * hc_08_emu_byte_time_us(emu) + HC_08_EMU_CMD_LATENCY_US;
+  if(emu->param.mode != hc_08_mode_full){
+    emu->time_us += HC_08_EMU_WAKE_US;
+  }
+  hc_08_emu_execute(emu, cmd);
+}
+
+/**
+  * @brief  UART receive function of the emulator (see hc_08_reg_uart_cbfunc_ctx)
+  * @param  *ctx pointer to the emulator structure
+  * @param  *buff receive buffer
+  * @param  size receive buffer size
+  * @retval number of bytes of the answer written to buff
+  */
+uint16_t hc_08_emu_rx(void *ctx, char *buff, uint16_t size){
+  hc_08_emu_ST *emu = (hc_08_emu_ST *)ctx;
+  uint16_t count = emu->reply_size < size ? emu->reply_size : size;
+
+  memcpy(buff, emu->reply, count);
+  emu->reply_size = 0;
+  emu->time_us += (uint64_t)count * hc_08_emu_byte_time_us(emu);
+
+  return count;
+}
+
+/**
+  * @brief  Time to transfer one byte over the UART at the current baud rate and parity
+  * @param  *emu pointer to the emulator structure
+  * @retval microseconds
+  */
+uint32_t hc_08_emu_byte_time_us(hc_08_emu_ST *emu){
+  uint32_t bits = (emu->param.parity == hc_08_parity_bit_no_parity) ? 10 : 11;
+
+  return (bits * 1000000UL + hc_08_emu_baud_value[emu->param.baud] - 1) / hc_08_emu_baud_value[emu->param.baud];
+}
+
+/**
+  * @brief  Expected round trip of size bytes sent to a peer with the same settings and echoed back.
+  *         UART in and out on both sides, half a connection interval of waiting plus one interval
+  *         per extra connection event in each direction
+  * @param  *emu pointer to the emulator structure
+  * @param  size payload size
+  * @retval microseconds
+  */
+uint32_t hc_08_emu_data_rtt_us(hc_08_emu_ST *emu, uint16_t size){
+  uint32_t interval = ((uint32_t)emu->param.cint_min + emu->param.cint_max) * 1250 / 2;
+  uint32_t packets = (size + HC_08_EMU_PKT_PAYLOAD - 1) / HC_08_EMU_PKT_PAYLOAD;
+  uint32_t events = (packets + HC_08_EMU_PKT_PER_EVENT - 1) / HC_08_EMU_PKT_PER_EVENT;
+  uint32_t rtt = 4 * (uint32_t)size * hc_08_emu_byte_time_us(emu);
+
+  if(events == 0){
+    events = 1;
+  }
+  rtt += 2 * (interval / 2 + (events - 1) * interval);
+  if(emu->param.mode != hc_08_mode_full){
+    rtt += 2 * HC_08_EMU_WAKE_US;
+  }
+  return rtt;
+}
+
+/**
+  * @brief  Expected one-way goodput, limited by the UART or by the connection events
+  * @param  *emu pointer to the emulator structure
+  * @retval bytes per second
+  */
+uint32_t hc_08_emu_throughput(hc_08_emu_ST *emu){
+  uint32_t interval = ((uint32_t)emu->param.cint_min + emu->param.cint_max) * 1250 / 2;
+  uint32_t uart = 1000000UL / hc_08_emu_byte_time_us(emu);
+  uint32_t air = (uint32_t)(((uint64_t)HC_08_EMU_PKT_PER_EVENT * HC_08_EMU_PKT_PAYLOAD * 1000000UL) / interval);
+
+  return uart < air ? uart : air;
+}
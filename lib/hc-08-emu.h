@@ -0,0 +1,64 @@
+#ifndef HC_08_EMU_H
+#define HC_08_EMU_H
+
+#include "hc-08.h"
+
+#define HC_08_EMU_REPLY_SIZE        0x80
+
+#define HC_08_EMU_CMD_LATENCY_US    5000  // time the firmware takes to answer an AT command
+#define HC_08_EMU_WAKE_US           6000  // first byte to a sleeping module (mode 1 and 2)
+#define HC_08_EMU_PKT_PER_EVENT     4     // notifications per connection event
+#define HC_08_EMU_PKT_PAYLOAD       20    // bytes per notification
+
+#define HC_08_EMU_VERSION           "HC-08V3.3,2020-10-16"
+
+/*
+ * Software model of the AT command interface of a HC-08 V3.3 module.
+ * Keeps the module state, answers commands through the context UART functions and
+ * advances a virtual clock by the UART and firmware time each exchange would take.
+ */
+typedef struct{
+  struct{
+    char name[HC_08_MAX_NAME_LENGHT + 1];
+    hc_08_role role;
+    hc_08_baud baud;
+    hc_08_parity_bit parity;
+    uint8_t addres[6];
+    char pin[7];
+    hc_08_rfpm rfpm;
+    hc_08_cont cont;
+    hc_08_mode mode;
+    uint16_t aint;
+    uint16_t cint_min;
+    uint16_t cint_max;
+    uint16_t ctout;
+    uint16_t luuid;
+    uint16_t suuid;
+    uint16_t tuuid;
+    uint16_t aust;
+    hc_08_led led;
+    char avda[HC_08_AVDA_MAX_LENGHT + 1];
+  }param;
+
+  const char *version;       // AT+VERSION answer, HC_08_EMU_VERSION by default
+  const char *unsupported;   // commands left unanswered like an older firmware, e.g. "AUST,RX", NULL for none
+
+  char reply[HC_08_EMU_REPLY_SIZE];
+  uint16_t reply_size;
+
+  uint64_t time_us;
+  uint32_t commands;
+  uint32_t errors;
+  uint32_t avda_updates;
+}hc_08_emu_ST;
+
+void hc_08_emu_init(hc_08_emu_ST *emu);
+void hc_08_emu_attach(hc_08_emu_ST *emu, hc_08_ST *hc_08);
+void hc_08_emu_tx(void *ctx, char *buff, uint16_t size);
+uint16_t hc_08_emu_rx(void *ctx, char *buff, uint16_t size);
+
+uint32_t hc_08_emu_byte_time_us(hc_08_emu_ST *emu);
+uint32_t hc_08_emu_data_rtt_us(hc_08_emu_ST *emu, uint16_t size);
+uint32_t hc_08_emu_throughput(hc_08_emu_ST *emu);
+
+#endif /* HC_08_EMU_H */
@@ -0,0 +1,235 @@
+#include "hc-08-health.h"
+#include <string.h>
+
+/**
+  * @brief  Sending one AT heartbeat and updating the response time averages
+  * @param  *health pointer to the monitor structure
+  * @retval hc_08_status:
+  *             hc_08_status_ok if the module answered OK
+  *             hc_08_status_error
+  */
+static hc_08_status hc_08_health_heartbeat(hc_08_health_ST *health){
+  hc_08_ST *hc_08 = health->hc_08;
+  uint32_t start = hc_08_get_tick(hc_08);
+  uint32_t sample;
+  hc_08_status status;
+
+  // an OK left over from an earlier exchange must not answer for a silent module
+  hc_08_clear_buff_rx(hc_08);
+  hc_08_cmd_at(hc_08);
+  hc_08_read_answer(hc_08);
+  status = hc_08_check_set(hc_08);
+
+  health->metrics.heartbeats++;
+  health->last_tx_bytes = hc_08->stats.tx_bytes;
+  health->last_rx_bytes = hc_08->stats.rx_bytes;
+  if(status != hc_08_status_ok){
+    health->metrics.failures++;
+    return hc_08_status_error;
+  }
+
+  health->ok_tick = hc_08_get_tick(hc_08);
+  health->metrics.rtt = health->ok_tick - start;
+  sample = health->metrics.rtt * 16;
+  if(health->metrics.heartbeats - health->metrics.failures == 1){
+    health->metrics.rtt_fast = sample;
+    health->metrics.rtt_slow = sample;
+  }else{
+    health->metrics.rtt_fast += ((int32_t)sample - (int32_t)health->metrics.rtt_fast) / 4;
+    health->metrics.rtt_slow += ((int32_t)sample - (int32_t)health->metrics.rtt_slow) / 32;
+  }
+  // one tick of jitter on a fast link is not a trend
+  health->metrics.slowing = health->metrics.rtt_fast > health->metrics.rtt_slow * HC_08_HEALTH_SLOW_RATIO + 16;
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Starting an attempt of an escalation level: doing its action and scheduling
+  *         the heartbeat that checks it
+  * @param  *health pointer to the monitor structure
+  * @param  level the level
+  * @param  now current tick
+  */
+static void hc_08_health_enter(hc_08_health_ST *health, hc_08_health_level level, uint32_t now){
+  hc_08_ST *hc_08 = health->hc_08;
+
+  health->level = level;
+  switch(level){
+  case hc_08_health_level_resync:
+    // drop whatever is left of a broken answer so the next OK is read from the start
+    hc_08_clear_buff_rx(hc_08);
+    hc_08_read_answer(hc_08);
+    hc_08_clear_buff_rx(hc_08);
+    health->next_tick = now + health->cfg.retry;
+    break;
+  case hc_08_health_level_reset:
+    hc_08_cmd_reset(hc_08);
+    hc_08_read_answer(hc_08);
+    health->next_tick = now + health->cfg.reset_wait;
+    break;
+  case hc_08_health_level_power_cycle:
+    health->metrics.power_cycles++;
+    if(health->power_cycle != NULL){
+      health->power_cycle(health->ctx);
+    }
+    health->next_tick = now + health->power_wait;
+    if(health->power_wait < health->cfg.power_wait_max / 2){
+      health->power_wait *= 2;
+    }else{
+      health->power_wait = health->cfg.power_wait_max;
+    }
+    break;
+  default:
+    health->next_tick = now + health->cfg.retry;
+    break;
+  }
+  health->last_tx_bytes = hc_08->stats.tx_bytes;
+  health->last_rx_bytes = hc_08->stats.rx_bytes;
+}
+
+/**
+  * @brief  Closing an incident after a heartbeat was answered
+  * @param  *health pointer to the monitor structure
+  * @param  now current tick
+  */
+static void hc_08_health_recover(hc_08_health_ST *health, uint32_t now){
+  health->metrics.ttr = now - health->detect_tick;
+  if(health->metrics.ttr > health->metrics.ttr_max){
+    health->metrics.ttr_max = health->metrics.ttr;
+  }
+  health->metrics.downtime += health->metrics.ttd + health->metrics.ttr;
+  health->metrics.recovered[health->level]++;
+
+  health->level = hc_08_health_level_ok;
+  health->attempts = 0;
+  health->power_wait = health->cfg.power_wait;
+  health->activity_tick = now;
+}
+
+/**
+  * @brief  Number of attempts of an escalation level before moving to the next one
+  * @param  *health pointer to the monitor structure
+  * @param  level the level
+  */
+static uint8_t hc_08_health_attempts(hc_08_health_ST *health, hc_08_health_level level){
+  switch(level){
+  case hc_08_health_level_retry:
+    return health->cfg.retries;
+  case hc_08_health_level_resync:
+    return health->cfg.resyncs;
+  case hc_08_health_level_reset:
+    return health->cfg.resets;
+  default:
+    return 0;
+  }
+}
+
+/**
+  * @brief  Initialization of the health monitor
+  * @param  *health pointer to the monitor structure
+  * @param  *hc_08 pointer to the HC-08 module structure. A tick source must be registered
+  *           with hc_08_reg_tick_cbfunc(...)
+  * @param  power_cycle switches the supply of the module off and on, NULL if the board cannot.
+  *           The power cycle level then only waits and checks again
+  * @param  *ctx user pointer passed to power_cycle
+  */
+void hc_08_health_init(hc_08_health_ST *health, hc_08_ST *hc_08, void (*power_cycle)(void *ctx), void *ctx){
+  memset(health, 0, sizeof(*health));
+  health->hc_08 = hc_08;
+  health->power_cycle = power_cycle;
+  health->ctx = ctx;
+
+  health->cfg.idle = HC_08_HEALTH_IDLE;
+  health->cfg.idle_min = HC_08_HEALTH_IDLE_MIN;
+  health->cfg.retry = HC_08_HEALTH_RETRY;
+  health->cfg.retries = HC_08_HEALTH_RETRIES;
+  health->cfg.resyncs = HC_08_HEALTH_RESYNCS;
+  health->cfg.resets = HC_08_HEALTH_RESETS;
+  health->cfg.reset_wait = HC_08_HEALTH_RESET_WAIT;
+  health->cfg.power_wait = HC_08_HEALTH_POWER_WAIT;
+  health->cfg.power_wait_max = HC_08_HEALTH_POWER_WAIT_MAX;
+
+  health->power_wait = health->cfg.power_wait;
+  health->activity_tick = hc_08_get_tick(hc_08);
+  health->ok_tick = health->activity_tick;
+  health->last_tx_bytes = hc_08->stats.tx_bytes;
+  health->last_rx_bytes = hc_08->stats.rx_bytes;
+}
+
+/**
+  * @brief  Reporting traffic that does not pass through the library (data received by an
+  *         interrupt in transparent mode, etc.). Postpones the next heartbeat
+  * @param  *health pointer to the monitor structure
+  */
+void hc_08_health_activity(hc_08_health_ST *health){
+  health->activity_tick = hc_08_get_tick(health->hc_08);
+  health->ok_tick = health->activity_tick;
+}
+
+/**
+  * @brief  Long-term average response time of the heartbeats
+  * @param  *health pointer to the monitor structure
+  * @retval ms
+  */
+uint32_t hc_08_health_rtt(hc_08_health_ST *health){
+  return (health->metrics.rtt_slow + 8) / 16;
+}
+
+/**
+  * @brief  Processing of the monitor, called from the main loop. Blocks for one AT exchange
+  *         when a heartbeat is due. Nothing is sent while the module is connected: an escalation
+  *         that is under way waits until the connection is dropped
+  * @param  *health pointer to the monitor structure
+  */
+void hc_08_health_process(hc_08_health_ST *health){
+  hc_08_ST *hc_08 = health->hc_08;
+  uint32_t now = hc_08_get_tick(hc_08);
+  uint32_t interval;
+
+  if(hc_08->stats.rx_bytes != health->last_rx_bytes){
+    health->ok_tick = now;
+  }
+  if(hc_08->stats.tx_bytes != health->last_tx_bytes || hc_08->stats.rx_bytes != health->last_rx_bytes){
+    health->activity_tick = now;
+    health->last_tx_bytes = hc_08->stats.tx_bytes;
+    health->last_rx_bytes = hc_08->stats.rx_bytes;
+  }
+
+  if(health->level == hc_08_health_level_ok){
+    interval = health->metrics.slowing ? health->cfg.idle_min : health->cfg.idle;
+    if(hc_08->status_connect != hc_08_status_not_connected || now - health->activity_tick < interval){
+      return;
+    }
+    if(hc_08_health_heartbeat(health) == hc_08_status_ok){
+      health->activity_tick = hc_08_get_tick(hc_08);
+      return;
+    }
+    now = hc_08_get_tick(hc_08);
+    health->metrics.incidents++;
+    health->detect_tick = now;
+    health->metrics.ttd = now - health->ok_tick;
+    if(health->metrics.ttd > health->metrics.ttd_max){
+      health->metrics.ttd_max = health->metrics.ttd;
+    }
+    health->attempts = 0;
+    hc_08_health_enter(health, hc_08_health_level_retry, now);
+    return;
+  }
+
+  if(hc_08->status_connect != hc_08_status_not_connected || (int32_t)(now - health->next_tick) < 0){
+    return;
+  }
+  if(hc_08_health_heartbeat(health) == hc_08_status_ok){
+    hc_08_health_recover(health, hc_08_get_tick(hc_08));
+    return;
+  }
+  now = hc_08_get_tick(hc_08);
+  health->attempts++;
+  if(health->level != hc_08_health_level_power_cycle &&
+      health->attempts >= hc_08_health_attempts(health, health->level)){
+    health->attempts = 0;
+    hc_08_health_enter(health, (hc_08_health_level)(health->level + 1), now);
+  }else{
+    hc_08_health_enter(health, health->level, now);
+  }
+}
@@ -0,0 +1,93 @@
+#ifndef HC_08_HEALTH_H
+#define HC_08_HEALTH_H
+
+#include "hc-08.h"
+
+#define HC_08_HEALTH_IDLE           5000    // ms without traffic before a heartbeat is sent
+#define HC_08_HEALTH_IDLE_MIN       1000    // ms, heartbeat period while the answers are slowing down
+#define HC_08_HEALTH_RETRY          200     // ms between attempts inside one escalation level
+#define HC_08_HEALTH_RETRIES        3       // failed heartbeats before moving to resync
+#define HC_08_HEALTH_RESYNCS        2       // failed resyncs before AT+RESET
+#define HC_08_HEALTH_RESETS         2       // AT+RESET attempts before the power cycle
+#define HC_08_HEALTH_RESET_WAIT     1000    // ms the module needs to boot after AT+RESET
+#define HC_08_HEALTH_POWER_WAIT     2000    // ms after the first power cycle
+#define HC_08_HEALTH_POWER_WAIT_MAX 60000   // ms, the wait doubles up to this value
+#define HC_08_HEALTH_SLOW_RATIO     2       // answers this many times slower than usual are a trend
+
+typedef enum{
+  hc_08_health_level_ok,
+  hc_08_health_level_retry,
+  hc_08_health_level_resync,
+  hc_08_health_level_reset,
+  hc_08_health_level_power_cycle
+}hc_08_health_level;
+
+static const char * const hc_08_health_level_c[] = {
+  [hc_08_health_level_ok] = "ok",
+  [hc_08_health_level_retry] = "retry",
+  [hc_08_health_level_resync] = "resync",
+  [hc_08_health_level_reset] = "reset",
+  [hc_08_health_level_power_cycle] = "power cycle"
+};
+#define HC_08_HEALTH_LEVEL_SIZE 0x05
+
+/*
+ * Link health monitor. AT heartbeats are sent only after HC_08_HEALTH_IDLE without
+ * traffic through hc_08_uart_tx(...)/hc_08_read_answer(...) and only while
+ * hc_08->status_connect is hc_08_status_not_connected (AT commands would be sent to
+ * the peer in transparent mode). A failed heartbeat starts an escalation:
+ * retry -> resync -> AT+RESET -> power cycle callback, each with a bounded number of
+ * attempts, until a heartbeat is answered again. The escalation is suspended while
+ * the module is connected.
+ */
+typedef struct{
+  hc_08_ST *hc_08;
+  void (*power_cycle)(void *ctx);
+  void *ctx;
+
+  struct{
+    uint32_t idle;
+    uint32_t idle_min;
+    uint32_t retry;
+    uint8_t retries;
+    uint8_t resyncs;
+    uint8_t resets;
+    uint32_t reset_wait;
+    uint32_t power_wait;
+    uint32_t power_wait_max;
+  }cfg;
+
+  hc_08_health_level level;
+  uint8_t attempts;
+  uint32_t next_tick;
+  uint32_t power_wait;
+  uint32_t activity_tick;
+  uint32_t ok_tick;
+  uint32_t detect_tick;
+  uint32_t last_tx_bytes;
+  uint32_t last_rx_bytes;
+
+  struct{
+    uint32_t rtt;            // ms, last heartbeat
+    uint32_t rtt_fast;       // ms * 16, short average
+    uint32_t rtt_slow;       // ms * 16, long average
+    uint8_t slowing;         // the short average is HC_08_HEALTH_SLOW_RATIO times the long one
+    uint32_t heartbeats;
+    uint32_t failures;
+    uint32_t incidents;
+    uint32_t recovered[HC_08_HEALTH_LEVEL_SIZE];
+    uint32_t power_cycles;
+    uint32_t ttd;            // ms, last answer before the incident to its detection
+    uint32_t ttd_max;
+    uint32_t ttr;            // ms, detection to the first answer after it
+    uint32_t ttr_max;
+    uint32_t downtime;       // ms, sum of ttd + ttr of all incidents
+  }metrics;
+}hc_08_health_ST;
+
+void hc_08_health_init(hc_08_health_ST *health, hc_08_ST *hc_08, void (*power_cycle)(void *ctx), void *ctx);
+void hc_08_health_process(hc_08_health_ST *health);
+void hc_08_health_activity(hc_08_health_ST *health);
+uint32_t hc_08_health_rtt(hc_08_health_ST *health);
+
+#endif /* HC_08_HEALTH_H */
@@ -0,0 +1,318 @@
+#include "hc-08-link.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+  * @brief  CRC-8 (polynomial 0x07) of the frame
+  */
+static uint8_t hc_08_link_crc(const char *data, uint16_t size){
+  uint8_t crc = 0;
+
+  for(uint16_t i = 0; i < size; i++){
+    crc ^= (uint8_t)data[i];
+    for(uint8_t bit = 0; bit < 8; bit++){
+      crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+static void hc_08_link_put32(char *data, uint32_t value){
+  for(uint8_t i = 0; i < 4; i++){
+    data[i] = (char)(value >> (8 * i));
+  }
+}
+
+static uint32_t hc_08_link_get32(const char *data){
+  uint32_t value = 0;
+
+  for(uint8_t i = 0; i < 4; i++){
+    value |= (uint32_t)(uint8_t)data[i] << (8 * i);
+  }
+  return value;
+}
+
+/**
+  * @brief  Building a frame: magic, payload size, sequence number, timestamp (little endian),
+  *         payload (a pattern derived from the sequence number) and CRC-8
+  * @param  *frame buffer of at least size + HC_08_LINK_OVERHEAD bytes
+  * @param  seq sequence number
+  * @param  timestamp_us send time
+  * @param  size payload size, up to HC_08_LINK_PAYLOAD_MAX
+  * @retval frame size
+  */
+uint16_t hc_08_link_encode(char *frame, uint32_t seq, uint32_t timestamp_us, uint8_t size){
+  if(size > HC_08_LINK_PAYLOAD_MAX){
+    size = HC_08_LINK_PAYLOAD_MAX;
+  }
+  frame[0] = (char)HC_08_LINK_MAGIC_0;
+  frame[1] = (char)HC_08_LINK_MAGIC_1;
+  frame[2] = (char)size;
+  hc_08_link_put32(frame + 3, seq);
+  hc_08_link_put32(frame + 7, timestamp_us);
+  for(uint8_t i = 0; i < size; i++){
+    frame[HC_08_LINK_HEADER + i] = (char)(seq + i);
+  }
+  frame[HC_08_LINK_HEADER + size] = (char)hc_08_link_crc(frame, HC_08_LINK_HEADER + size);
+  return HC_08_LINK_OVERHEAD + size;
+}
+
+/**
+  * @brief  Feeding received bytes to the decoder. Every complete frame with a good CRC is
+  *         passed to the callback; its raw pointer is valid only during the call
+  * @param  *rx pointer to the decoder
+  * @param  *data received bytes
+  * @param  size number of bytes
+  * @param  frame callback
+  * @param  *ctx user pointer passed to the callback
+  */
+void hc_08_link_input(hc_08_link_rx_ST *rx, const char *data, uint16_t size,
+                      void (*frame)(void *ctx, const hc_08_link_frame_ST *frame), void *ctx){
+  for(uint16_t i = 0; i < size; i++){
+    uint16_t length;
+
+    rx->buff[rx->size++] = data[i];
+    // resynchronize on the magic and on impossible sizes
+    while(rx->size > 0){
+      if((uint8_t)rx->buff[0] != HC_08_LINK_MAGIC_0 ||
+          (rx->size > 1 && (uint8_t)rx->buff[1] != HC_08_LINK_MAGIC_1) ||
+          (rx->size > 2 && (uint8_t)rx->buff[2] > HC_08_LINK_PAYLOAD_MAX)){
+        rx->bad++;
+        memmove(rx->buff, rx->buff + 1, --rx->size);
+        continue;
+      }
+      if(rx->size < HC_08_LINK_HEADER){
+        break;
+      }
+      length = HC_08_LINK_OVERHEAD + (uint8_t)rx->buff[2];
+      if(rx->size < length){
+        break;
+      }
+      if((uint8_t)rx->buff[length - 1] != hc_08_link_crc(rx->buff, length - 1)){
+        rx->bad++;
+        memmove(rx->buff, rx->buff + 1, --rx->size);
+        continue;
+      }
+      {
+        hc_08_link_frame_ST decoded = {
+          .seq = hc_08_link_get32(rx->buff + 3),
+          .timestamp_us = hc_08_link_get32(rx->buff + 7),
+          .size = (uint8_t)rx->buff[2],
+          .raw = rx->buff,
+          .raw_size = length
+        };
+
+        frame(ctx, &decoded);
+      }
+      rx->size -= length;
+      memmove(rx->buff, rx->buff + length, rx->size);
+    }
+  }
+}
+
+/**
+  * @brief  Frame callback of the peer
+  */
+static void hc_08_link_peer_frame(void *ctx, const hc_08_link_frame_ST *frame){
+  hc_08_link_peer_ST *peer = (hc_08_link_peer_ST *)ctx;
+  uint32_t now = peer->clock_us();
+
+  if(peer->metrics.frames == 0){
+    peer->metrics.first_us = now;
+  }else if((int32_t)(frame->seq - peer->next_seq) > 0){
+    peer->metrics.missing += frame->seq - peer->next_seq;
+  }
+  peer->metrics.last_us = now;
+  peer->metrics.frames++;
+  peer->metrics.bytes += frame->size;
+  peer->next_seq = frame->seq + 1;
+
+  if(peer->mode == hc_08_link_mode_echo){
+    hc_08_uart_tx(peer->hc_08, (char *)frame->raw, frame->raw_size);
+  }
+}
+
+/**
+  * @brief  Initialization of the benchmark peer. The module must be connected to the driver
+  * @param  *peer pointer to the peer structure
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  mode echo or sink
+  * @param  clock_us microsecond clock
+  */
+void hc_08_link_peer_init(hc_08_link_peer_ST *peer, hc_08_ST *hc_08, hc_08_link_mode mode, uint32_t (*clock_us)(void)){
+  memset(peer, 0, sizeof(*peer));
+  peer->hc_08 = hc_08;
+  peer->mode = mode;
+  peer->clock_us = clock_us;
+}
+
+/**
+  * @brief  Processing of the peer: reading what was received (hc_08_read_answer) and
+  *         echoing or counting the frames
+  * @param  *peer pointer to the peer structure
+  */
+void hc_08_link_peer_process(hc_08_link_peer_ST *peer){
+  hc_08_read_answer(peer->hc_08);
+  hc_08_link_input(&peer->rx, peer->hc_08->uart.buff_rx, peer->hc_08->uart.rx_size, hc_08_link_peer_frame, peer);
+}
+
+/**
+  * @brief  Payload received per second between the first and the last frame
+  * @param  *peer pointer to the peer structure
+  * @retval bytes per second
+  */
+uint32_t hc_08_link_peer_throughput(hc_08_link_peer_ST *peer){
+  uint32_t elapsed = peer->metrics.last_us - peer->metrics.first_us;
+
+  return elapsed == 0 ? 0 : (uint32_t)((uint64_t)peer->metrics.bytes * 1000000ULL / elapsed);
+}
+
+/**
+  * @brief  Frame callback of the driver: matching an echo with its frame in flight
+  */
+static void hc_08_link_driver_frame(void *ctx, const hc_08_link_frame_ST *frame){
+  hc_08_link_driver_ST *driver = (hc_08_link_driver_ST *)ctx;
+  uint8_t slot = frame->seq % driver->cfg.window;
+  uint32_t now = driver->clock_us();
+
+  if(!driver->inflight[slot].used || driver->inflight[slot].seq != frame->seq){
+    driver->metrics.late++;
+    return;
+  }
+  driver->inflight[slot].used = 0;
+  driver->outstanding--;
+  driver->metrics.received++;
+  driver->metrics.bytes += frame->size;
+  driver->metrics.end_us = now;
+  if(driver->metrics.received <= driver->sample_capacity){
+    driver->samples[driver->metrics.received - 1] = now - frame->timestamp_us;
+    driver->sorted = 0;
+  }
+}
+
+/**
+  * @brief  Initialization of the benchmark driver with 1000 frames of 20 bytes and a window
+  *         of 8 frames (cfg can be changed before the first hc_08_link_driver_process)
+  * @param  *driver pointer to the driver structure
+  * @param  *hc_08 pointer to the HC-08 module structure, connected to the peer
+  * @param  mode mode of the peer
+  * @param  clock_us microsecond clock
+  * @param  *samples array for the RTT of every echo, NULL if not needed
+  * @param  sample_capacity size of the array
+  */
+void hc_08_link_driver_init(hc_08_link_driver_ST *driver, hc_08_ST *hc_08, hc_08_link_mode mode,
+                            uint32_t (*clock_us)(void), uint32_t *samples, uint32_t sample_capacity){
+  memset(driver, 0, sizeof(*driver));
+  driver->hc_08 = hc_08;
+  driver->mode = mode;
+  driver->clock_us = clock_us;
+  driver->samples = samples;
+  driver->sample_capacity = samples != NULL ? sample_capacity : 0;
+  driver->cfg.payload = 20;
+  driver->cfg.window = 8;
+  driver->cfg.frames = 1000;
+  driver->cfg.timeout_us = HC_08_LINK_TIMEOUT_US;
+}
+
+/**
+  * @brief  Processing of the driver: sending the frames the window (echo) or the rate (sink)
+  *         allows, reading the echoes and expiring frames in flight
+  * @param  *driver pointer to the driver structure
+  * @retval 1 while the run is not finished
+  */
+uint8_t hc_08_link_driver_process(hc_08_link_driver_ST *driver){
+  char frame[HC_08_LINK_FRAME_MAX];
+  uint32_t now = driver->clock_us();
+
+  if(driver->cfg.window == 0 || driver->cfg.window > HC_08_LINK_WINDOW_MAX){
+    driver->cfg.window = HC_08_LINK_WINDOW_MAX;
+  }
+  if(driver->seq == 0){
+    driver->metrics.start_us = now;
+  }
+
+  while(driver->seq < driver->cfg.frames){
+    uint16_t size;
+
+    // the slot of this sequence number is still taken while an older frame waits for its timeout
+    if(driver->mode == hc_08_link_mode_echo && driver->inflight[driver->seq % driver->cfg.window].used){
+      break;
+    }
+    if(driver->mode == hc_08_link_mode_sink && driver->cfg.rate != 0 &&
+        (uint64_t)driver->metrics.bytes * 1000000ULL > (uint64_t)(now - driver->metrics.start_us) * driver->cfg.rate){
+      break;
+    }
+    size = hc_08_link_encode(frame, driver->seq, now, driver->cfg.payload);
+    hc_08_uart_tx(driver->hc_08, frame, size);
+    driver->metrics.sent++;
+    if(driver->mode == hc_08_link_mode_echo){
+      uint8_t slot = driver->seq % driver->cfg.window;
+
+      driver->inflight[slot].seq = driver->seq;
+      driver->inflight[slot].sent_us = now;
+      driver->inflight[slot].used = 1;
+      driver->outstanding++;
+    }else{
+      driver->metrics.bytes += driver->cfg.payload;
+      driver->metrics.end_us = now;
+    }
+    driver->seq++;
+  }
+
+  if(driver->mode == hc_08_link_mode_sink){
+    return driver->seq < driver->cfg.frames;
+  }
+
+  hc_08_read_answer(driver->hc_08);
+  hc_08_link_input(&driver->rx, driver->hc_08->uart.buff_rx, driver->hc_08->uart.rx_size,
+                   hc_08_link_driver_frame, driver);
+
+  now = driver->clock_us();
+  for(uint8_t slot = 0; slot < driver->cfg.window; slot++){
+    if(driver->inflight[slot].used && now - driver->inflight[slot].sent_us > driver->cfg.timeout_us){
+      driver->inflight[slot].used = 0;
+      driver->outstanding--;
+      driver->metrics.lost++;
+    }
+  }
+  return driver->seq < driver->cfg.frames || driver->outstanding > 0;
+}
+
+/**
+  * @brief  Payload echoed (echo) or sent (sink) per second
+  * @param  *driver pointer to the driver structure
+  * @retval bytes per second
+  */
+uint32_t hc_08_link_driver_throughput(hc_08_link_driver_ST *driver){
+  uint32_t elapsed = driver->metrics.end_us - driver->metrics.start_us;
+
+  return elapsed == 0 ? 0 : (uint32_t)((uint64_t)driver->metrics.bytes * 1000000ULL / elapsed);
+}
+
+static int hc_08_link_compare(const void *a, const void *b){
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+
+  return (x > y) - (x < y);
+}
+
+/**
+  * @brief  Percentile of the round trip times
+  * @param  *driver pointer to the driver structure
+  * @param  permille 500 for the median, 990 for p99, 1000 for the maximum
+  * @retval us, 0 without samples
+  */
+uint32_t hc_08_link_driver_percentile(hc_08_link_driver_ST *driver, uint16_t permille){
+  uint32_t count = driver->metrics.received < driver->sample_capacity ? driver->metrics.received : driver->sample_capacity;
+  uint32_t index;
+
+  if(count == 0){
+    return 0;
+  }
+  if(!driver->sorted){
+    qsort(driver->samples, count, sizeof(driver->samples[0]), hc_08_link_compare);
+    driver->sorted = 1;
+  }
+  index = (uint32_t)(((uint64_t)count * permille + 999) / 1000);
+  return driver->samples[index > 0 ? index - 1 : 0];
+}
@@ -0,0 +1,113 @@
+#ifndef HC_08_LINK_H
+#define HC_08_LINK_H
+
+#include "hc-08.h"
+
+#define HC_08_LINK_MAGIC_0        0xA5
+#define HC_08_LINK_MAGIC_1        0x5A
+#define HC_08_LINK_HEADER         11     // magic, size, sequence, timestamp
+#define HC_08_LINK_OVERHEAD       12     // header and CRC-8
+#define HC_08_LINK_PAYLOAD_MAX    200
+#define HC_08_LINK_FRAME_MAX      (HC_08_LINK_PAYLOAD_MAX + HC_08_LINK_OVERHEAD)
+#define HC_08_LINK_WINDOW_MAX     64     // frames waiting for their echo
+#define HC_08_LINK_TIMEOUT_US     2000000
+
+typedef enum{
+  hc_08_link_mode_echo,          // the peer sends every frame back
+  hc_08_link_mode_sink           // the peer only counts
+}hc_08_link_mode;
+
+typedef struct{
+  uint32_t seq;
+  uint32_t timestamp_us;
+  uint8_t size;                  // payload size
+  const char *raw;               // whole frame as received
+  uint16_t raw_size;
+}hc_08_link_frame_ST;
+
+/*
+ * Stream decoder: finds frames in the received bytes, skipping bytes until the magic and
+ * dropping frames whose CRC does not match
+ */
+typedef struct{
+  char buff[HC_08_LINK_FRAME_MAX];
+  uint16_t size;
+  uint32_t bad;                  // bytes skipped to find a frame
+}hc_08_link_rx_ST;
+
+/*
+ * Benchmark peer: echoes or counts the frames of a driver, over the transparent link
+ */
+typedef struct{
+  hc_08_ST *hc_08;
+  hc_08_link_mode mode;
+  uint32_t (*clock_us)(void);
+  hc_08_link_rx_ST rx;
+  uint32_t next_seq;
+
+  struct{
+    uint32_t frames;
+    uint32_t bytes;              // payload
+    uint32_t missing;            // sequence numbers skipped
+    uint32_t first_us;
+    uint32_t last_us;
+  }metrics;
+}hc_08_link_peer_ST;
+
+/*
+ * Benchmark driver: sends timestamped, numbered frames and matches the echoes. With an
+ * echo peer at most cfg.window frames are in flight and a frame not echoed within
+ * cfg.timeout_us is lost; with a sink peer frames are sent at cfg.rate and the peer
+ * counts the losses.
+ */
+typedef struct{
+  hc_08_ST *hc_08;
+  hc_08_link_mode mode;
+  uint32_t (*clock_us)(void);
+  hc_08_link_rx_ST rx;
+
+  struct{
+    uint8_t payload;
+    uint8_t window;
+    uint32_t frames;
+    uint32_t timeout_us;
+    uint32_t rate;               // bytes per second in sink mode, 0 for as fast as written
+  }cfg;
+
+  uint32_t seq;
+  uint8_t outstanding;
+  struct{
+    uint32_t seq;
+    uint32_t sent_us;
+    uint8_t used;
+  }inflight[HC_08_LINK_WINDOW_MAX];
+  uint32_t *samples;             // RTT of every echo, owned by the caller
+  uint32_t sample_capacity;
+  uint8_t sorted;
+
+  struct{
+    uint32_t sent;
+    uint32_t received;
+    uint32_t lost;
+    uint32_t late;               // echoes after their timeout or not sent by this run
+    uint32_t bytes;              // payload sent (sink) or echoed (echo)
+    uint32_t start_us;
+    uint32_t end_us;
+  }metrics;
+}hc_08_link_driver_ST;
+
+uint16_t hc_08_link_encode(char *frame, uint32_t seq, uint32_t timestamp_us, uint8_t size);
+void hc_08_link_input(hc_08_link_rx_ST *rx, const char *data, uint16_t size,
+                      void (*frame)(void *ctx, const hc_08_link_frame_ST *frame), void *ctx);
+
+void hc_08_link_peer_init(hc_08_link_peer_ST *peer, hc_08_ST *hc_08, hc_08_link_mode mode, uint32_t (*clock_us)(void));
+void hc_08_link_peer_process(hc_08_link_peer_ST *peer);
+uint32_t hc_08_link_peer_throughput(hc_08_link_peer_ST *peer);
+
+void hc_08_link_driver_init(hc_08_link_driver_ST *driver, hc_08_ST *hc_08, hc_08_link_mode mode,
+                            uint32_t (*clock_us)(void), uint32_t *samples, uint32_t sample_capacity);
+uint8_t hc_08_link_driver_process(hc_08_link_driver_ST *driver);
+uint32_t hc_08_link_driver_throughput(hc_08_link_driver_ST *driver);
+uint32_t hc_08_link_driver_percentile(hc_08_link_driver_ST *driver, uint16_t permille);
+
+#endif /* HC_08_LINK_H */
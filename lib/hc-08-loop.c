@@ -0,0 +1,378 @@
+#define _DEFAULT_SOURCE
+#include "hc-08-loop.h"
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+
+/**
+  * @brief  Moment the timer of a node fires: the command deadline, or the end of the
+  *         silence after the last bytes of an answer if that comes first
+  * @param  *node pointer to the node
+  */
+static uint64_t hc_08_loop_timer(hc_08_loop_node_ST *node){
+  if(node->idle_deadline != 0 && node->idle_deadline < node->deadline){
+    return node->idle_deadline;
+  }
+  return node->deadline;
+}
+
+/**
+  * @brief  Exchanging two entries of the timer heap
+  */
+static void hc_08_loop_heap_swap(hc_08_loop_ST *loop, uint32_t a, uint32_t b){
+  hc_08_loop_node_ST *node = loop->heap[a];
+
+  loop->heap[a] = loop->heap[b];
+  loop->heap[b] = node;
+  loop->heap[a]->heap_index = a;
+  loop->heap[b]->heap_index = b;
+}
+
+/**
+  * @brief  Restoring the order of the timer heap around one entry
+  * @param  *loop pointer to the loop structure
+  * @param  index position of the entry that changed
+  */
+static void hc_08_loop_heap_fix(hc_08_loop_ST *loop, uint32_t index){
+  while(index > 0 && hc_08_loop_timer(loop->heap[index]) < hc_08_loop_timer(loop->heap[(index - 1) / 2])){
+    hc_08_loop_heap_swap(loop, index, (index - 1) / 2);
+    index = (index - 1) / 2;
+  }
+  for(;;){
+    uint32_t smallest = index;
+    uint32_t left = index * 2 + 1;
+    uint32_t right = left + 1;
+
+    if(left < loop->heap_size && hc_08_loop_timer(loop->heap[left]) < hc_08_loop_timer(loop->heap[smallest])){
+      smallest = left;
+    }
+    if(right < loop->heap_size && hc_08_loop_timer(loop->heap[right]) < hc_08_loop_timer(loop->heap[smallest])){
+      smallest = right;
+    }
+    if(smallest == index){
+      break;
+    }
+    hc_08_loop_heap_swap(loop, index, smallest);
+    index = smallest;
+  }
+}
+
+/**
+  * @brief  Taking a node out of the timer heap, if it is there
+  */
+static void hc_08_loop_heap_remove(hc_08_loop_ST *loop, hc_08_loop_node_ST *node){
+  uint32_t index = node->heap_index;
+
+  if(index >= loop->heap_size || loop->heap[index] != node){
+    return;
+  }
+  loop->heap_size--;
+  if(index != loop->heap_size){
+    hc_08_loop_heap_swap(loop, index, loop->heap_size);
+    hc_08_loop_heap_fix(loop, index);
+  }
+  node->heap_index = UINT32_MAX;
+}
+
+/**
+  * @brief  Finishing the pending command of a node and delivering the event
+  * @param  *loop pointer to the loop structure
+  * @param  *node pointer to the node
+  * @param  event hc_08_loop_event_answer or hc_08_loop_event_timeout
+  * @param  status result of the parser
+  */
+static void hc_08_loop_complete(hc_08_loop_ST *loop, hc_08_loop_node_ST *node, hc_08_loop_event event, hc_08_status status){
+  hc_08_loop_heap_remove(loop, node);
+  node->pending = 0;
+  node->idle_deadline = 0;
+  if(event == hc_08_loop_event_answer){
+    loop->stats.answers++;
+  }else{
+    loop->stats.timeouts++;
+  }
+  node->callback(node, event, status, node->ctx);
+  if(!node->pending){
+    node->hc_08->uart.rx_size = 0;
+  }
+}
+
+/**
+  * @brief  Taking a node out of the loop: its timer, its descriptor and the events of the
+  *         current batch that are not handled yet. Does nothing for a node already out
+  * @param  *loop pointer to the loop structure
+  * @param  *node pointer to the node
+  */
+static void hc_08_loop_detach(hc_08_loop_ST *loop, hc_08_loop_node_ST *node){
+  if(!node->watched){
+    return;
+  }
+  hc_08_loop_heap_remove(loop, node);
+  node->pending = 0;
+  node->watched = 0;
+  epoll_ctl(loop->epfd, EPOLL_CTL_DEL, node->fd, NULL);
+  loop->node_count--;
+  for(int i = loop->batch_next; i < loop->batch_size; i++){
+    if(loop->batch[i].data.ptr == node){
+      loop->batch[i].data.ptr = NULL;
+    }
+  }
+}
+
+/**
+  * @brief  Reading what the module sent. Answers have no terminator and may arrive in
+  *         several reads, so a pending answer is parsed only after loop->rx_idle of silence
+  *         (or when the receive buffer is full)
+  * @param  *loop pointer to the loop structure
+  * @param  *node pointer to the node
+  * @param  now current time
+  */
+static void hc_08_loop_readable(hc_08_loop_ST *loop, hc_08_loop_node_ST *node, uint64_t now){
+  hc_08_ST *hc_08 = node->hc_08;
+  uint16_t free_size = hc_08->uart.rx_capacity - hc_08->uart.rx_size;
+  ssize_t count;
+
+  if(free_size == 0){
+    hc_08->uart.rx_size = 0;
+    free_size = hc_08->uart.rx_capacity;
+  }
+  count = read(node->fd, hc_08->uart.buff_rx + hc_08->uart.rx_size, free_size);
+  if(count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)){
+    return;
+  }
+  if(count <= 0){
+    hc_08_loop_detach(loop, node);
+    node->callback(node, hc_08_loop_event_closed, hc_08_status_error, node->ctx);
+    return;
+  }
+  hc_08->uart.rx_size += (uint16_t)count;
+  hc_08->stats.rx_bytes += (uint32_t)count;
+
+  if(node->pending){
+    if(hc_08->uart.rx_size >= hc_08->uart.rx_capacity){
+      hc_08_loop_complete(loop, node, hc_08_loop_event_answer, node->parse(hc_08, hc_08->uart.rx_size));
+    }else{
+      node->idle_deadline = now + loop->rx_idle;
+      hc_08_loop_heap_fix(loop, node->heap_index);
+    }
+  }else{
+    loop->stats.data++;
+    node->callback(node, hc_08_loop_event_data, hc_08_status_ok, node->ctx);
+    if(!node->pending){
+      hc_08->uart.rx_size = 0;
+    }
+  }
+}
+
+/**
+  * @brief  Monotonic time used for the deadlines of the loop
+  * @retval milliseconds
+  */
+uint64_t hc_08_loop_now(void){
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+/**
+  * @brief  Initialization of an event loop. One loop serves many modules from one thread;
+  *         to spread the modules over several cores create one loop per thread (shard) and
+  *         add each module to exactly one of them. Loops share no state
+  * @param  *loop pointer to the loop structure
+  * @param  capacity maximum number of modules in this loop
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error
+  */
+hc_08_status hc_08_loop_init(hc_08_loop_ST *loop, uint32_t capacity){
+  memset(loop, 0, sizeof(*loop));
+  loop->rx_idle = HC_08_LOOP_RX_IDLE;
+  loop->capacity = capacity;
+  loop->heap = calloc(capacity, sizeof(loop->heap[0]));
+  loop->epfd = epoll_create1(EPOLL_CLOEXEC);
+  if(loop->heap == NULL || loop->epfd < 0){
+    hc_08_loop_deinit(loop);
+    return hc_08_status_error;
+  }
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Releasing the loop. The descriptors of the nodes are not closed
+  * @param  *loop pointer to the loop structure
+  */
+void hc_08_loop_deinit(hc_08_loop_ST *loop){
+  if(loop->epfd >= 0){
+    close(loop->epfd);
+  }
+  free(loop->heap);
+  loop->heap = NULL;
+  loop->epfd = -1;
+}
+
+/**
+  * @brief  Adding a module to the loop
+  * @param  *loop pointer to the loop structure
+  * @param  *node pointer to the node, must stay valid until hc_08_loop_remove(...)
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  fd non-blocking descriptor the module answers on
+  * @param  callback called with the parsed answer (the receive buffer is valid during the call),
+  *           on timeout, on data received while no command is pending and when fd is closed.
+  *           The next command may be sent from the callback
+  * @param  *ctx user pointer passed to the callback
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if the loop is full or fd cannot be watched
+  */
+hc_08_status hc_08_loop_add(hc_08_loop_ST *loop, hc_08_loop_node_ST *node, hc_08_ST *hc_08, int fd,
+                            void (*callback)(hc_08_loop_node_ST *node, hc_08_loop_event event, hc_08_status status, void *ctx),
+                            void *ctx){
+  struct epoll_event ev = {.events = EPOLLIN, .data.ptr = node};
+
+  if(loop->node_count >= loop->capacity){
+    return hc_08_status_error;
+  }
+  memset(node, 0, sizeof(*node));
+  node->hc_08 = hc_08;
+  node->fd = fd;
+  node->callback = callback;
+  node->ctx = ctx;
+  node->heap_index = UINT32_MAX;
+  hc_08->uart.rx_size = 0;
+
+  if(epoll_ctl(loop->epfd, EPOLL_CTL_ADD, fd, &ev) != 0){
+    return hc_08_status_error;
+  }
+  node->watched = 1;
+  loop->node_count++;
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Removing a module from the loop. A pending command is dropped without a callback.
+  *         May be called from a callback, and after hc_08_loop_event_closed (the node is
+  *         already out then)
+  * @param  *loop pointer to the loop structure
+  * @param  *node pointer to the node
+  */
+void hc_08_loop_remove(hc_08_loop_ST *loop, hc_08_loop_node_ST *node){
+  hc_08_loop_detach(loop, node);
+}
+
+/**
+  * @brief  Announcing that a command was sent to the module (hc_08_cmd_...) and how to parse
+  *         its answer. Only one command per module may be pending
+  * @param  *loop pointer to the loop structure
+  * @param  *node pointer to the node
+  * @param  parse parser of the answer (hc_08_parse_..., or hc_08_loop_parse_ok for set commands)
+  * @param  timeout ms to wait for the answer
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if a command is already pending
+  */
+hc_08_status hc_08_loop_expect(hc_08_loop_ST *loop, hc_08_loop_node_ST *node,
+                               hc_08_status (*parse)(hc_08_ST *hc_08, uint16_t size), uint32_t timeout){
+  if(node->pending){
+    return hc_08_status_error;
+  }
+  node->parse = parse;
+  node->pending = 1;
+  node->deadline = hc_08_loop_now() + timeout;
+  node->idle_deadline = 0;
+  node->hc_08->uart.rx_size = 0;
+
+  node->heap_index = loop->heap_size;
+  loop->heap[loop->heap_size++] = node;
+  hc_08_loop_heap_fix(loop, node->heap_index);
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Parser for the answer to set commands (hc_08_check_set)
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  size the size of received data
+  */
+hc_08_status hc_08_loop_parse_ok(hc_08_ST *hc_08, uint16_t size){
+  (void)size;
+  return hc_08_check_set(hc_08);
+}
+
+/**
+  * @brief  One pass of the loop: waits for readable descriptors or the nearest deadline,
+  *         then delivers answers, data and timeouts
+  * @param  *loop pointer to the loop structure
+  * @param  max_wait maximum wait in ms, -1 to wait until something happens
+  * @retval number of descriptors handled, -1 on error
+  */
+int hc_08_loop_run_once(hc_08_loop_ST *loop, int max_wait){
+  struct epoll_event events[HC_08_LOOP_MAX_EVENTS];
+  uint64_t now = hc_08_loop_now();
+  int wait = max_wait;
+  int count;
+
+  if(loop->heap_size > 0){
+    uint64_t next = hc_08_loop_timer(loop->heap[0]);
+    int until = next <= now ? 0 : next - now >= INT_MAX ? INT_MAX : (int)(next - now);
+
+    if(wait < 0 || until < wait){
+      wait = until;
+    }
+  }
+
+  count = epoll_wait(loop->epfd, events, HC_08_LOOP_MAX_EVENTS, wait);
+  if(count < 0){
+    return errno == EINTR ? 0 : -1;
+  }
+  loop->stats.wakeups++;
+
+  now = hc_08_loop_now();
+  loop->batch = events;
+  loop->batch_size = count;
+  for(int i = 0; i < count; i++){
+    hc_08_loop_node_ST *node = events[i].data.ptr;
+
+    loop->batch_next = i + 1;
+    // NULL if the node was removed by a callback of this batch
+    if(node != NULL){
+      hc_08_loop_readable(loop, node, now);
+    }
+  }
+  loop->batch_size = 0;
+
+  while(loop->heap_size > 0 && hc_08_loop_timer(loop->heap[0]) <= now){
+    hc_08_loop_node_ST *node = loop->heap[0];
+
+    // the answer ends with the silence after it, or with the deadline
+    if(node->hc_08->uart.rx_size > 0){
+      hc_08_loop_complete(loop, node, hc_08_loop_event_answer, node->parse(node->hc_08, node->hc_08->uart.rx_size));
+    }else{
+      hc_08_loop_complete(loop, node, hc_08_loop_event_timeout, hc_08_status_error);
+    }
+  }
+  return count;
+}
+
+/**
+  * @brief  Running the loop until hc_08_loop_stop(...)
+  * @param  *loop pointer to the loop structure
+  */
+void hc_08_loop_run(hc_08_loop_ST *loop){
+  loop->stop = 0;
+  while(!loop->stop){
+    if(hc_08_loop_run_once(loop, 100) < 0){
+      break;
+    }
+  }
+}
+
+/**
+  * @brief  Asking hc_08_loop_run(...) to return. Takes effect within 100 ms
+  * @param  *loop pointer to the loop structure
+  */
+void hc_08_loop_stop(hc_08_loop_ST *loop){
+  loop->stop = 1;
+}
@@ -0,0 +1,72 @@
+#ifndef HC_08_LOOP_H
+#define HC_08_LOOP_H
+
+#include "hc-08.h"
+
+#define HC_08_LOOP_MAX_EVENTS   64
+#define HC_08_LOOP_RX_IDLE      20    // ms of silence that ends an answer
+
+typedef enum{
+  hc_08_loop_event_answer,
+  hc_08_loop_event_timeout,
+  hc_08_loop_event_data,
+  hc_08_loop_event_closed
+}hc_08_loop_event;
+
+typedef struct hc_08_loop_node_ST hc_08_loop_node_ST;
+struct epoll_event;
+
+/*
+ * One module served by the loop. The node only borrows hc_08 and fd: the UART functions
+ * of hc_08 must write to fd (hc-08-posix.h, or any other descriptor based transport).
+ */
+struct hc_08_loop_node_ST{
+  hc_08_ST *hc_08;
+  int fd;
+  void (*callback)(hc_08_loop_node_ST *node, hc_08_loop_event event, hc_08_status status, void *ctx);
+  void *ctx;
+
+  hc_08_status (*parse)(hc_08_ST *hc_08, uint16_t size);
+  uint8_t pending;
+  uint8_t watched;
+  uint64_t deadline;
+  uint64_t idle_deadline;
+  uint32_t heap_index;
+};
+
+typedef struct{
+  int epfd;
+  hc_08_loop_node_ST **heap;
+  uint32_t heap_size;
+  uint32_t capacity;
+  uint32_t node_count;
+  uint32_t rx_idle;
+  volatile int stop;
+
+  struct epoll_event *batch;      // events of the current epoll_wait, handled up to batch_next
+  int batch_next;
+  int batch_size;
+
+  struct{
+    uint32_t answers;
+    uint32_t timeouts;
+    uint32_t data;
+    uint32_t wakeups;
+  }stats;
+}hc_08_loop_ST;
+
+hc_08_status hc_08_loop_init(hc_08_loop_ST *loop, uint32_t capacity);
+void hc_08_loop_deinit(hc_08_loop_ST *loop);
+hc_08_status hc_08_loop_add(hc_08_loop_ST *loop, hc_08_loop_node_ST *node, hc_08_ST *hc_08, int fd,
+                            void (*callback)(hc_08_loop_node_ST *node, hc_08_loop_event event, hc_08_status status, void *ctx),
+                            void *ctx);
+void hc_08_loop_remove(hc_08_loop_ST *loop, hc_08_loop_node_ST *node);
+hc_08_status hc_08_loop_expect(hc_08_loop_ST *loop, hc_08_loop_node_ST *node,
+                               hc_08_status (*parse)(hc_08_ST *hc_08, uint16_t size), uint32_t timeout);
+hc_08_status hc_08_loop_parse_ok(hc_08_ST *hc_08, uint16_t size);
+int hc_08_loop_run_once(hc_08_loop_ST *loop, int max_wait);
+void hc_08_loop_run(hc_08_loop_ST *loop);
+void hc_08_loop_stop(hc_08_loop_ST *loop);
+uint64_t hc_08_loop_now(void);
+
+#endif /* HC_08_LOOP_H */
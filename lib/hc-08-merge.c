@@ -0,0 +1,302 @@
+#include "hc-08-merge.h"
+#include <string.h>
+#include <stdlib.h>
+
+/**
+  * @brief  Exchanging two entries of the heap
+  */
+static void hc_08_merge_heap_swap(hc_08_merge_ST *merge, uint32_t a, uint32_t b){
+  hc_08_merge_queue_ST *queue = merge->heap[a];
+
+  merge->heap[a] = merge->heap[b];
+  merge->heap[b] = queue;
+  merge->heap[a]->heap_index = a;
+  merge->heap[b]->heap_index = b;
+}
+
+/**
+  * @brief  Restoring the order of the heap around one entry
+  * @param  *merge pointer to the merge structure
+  * @param  index position of the entry that changed
+  */
+static void hc_08_merge_heap_fix(hc_08_merge_ST *merge, uint32_t index){
+  while(index > 0 && merge->heap[index]->key < merge->heap[(index - 1) / 2]->key){
+    hc_08_merge_heap_swap(merge, index, (index - 1) / 2);
+    index = (index - 1) / 2;
+  }
+  for(;;){
+    uint32_t smallest = index;
+    uint32_t left = index * 2 + 1;
+    uint32_t right = left + 1;
+
+    if(left < merge->heap_size && merge->heap[left]->key < merge->heap[smallest]->key){
+      smallest = left;
+    }
+    if(right < merge->heap_size && merge->heap[right]->key < merge->heap[smallest]->key){
+      smallest = right;
+    }
+    if(smallest == index){
+      break;
+    }
+    hc_08_merge_heap_swap(merge, index, smallest);
+    index = smallest;
+  }
+}
+
+/**
+  * @brief  Current key of a queue: its first record, or if it is empty the earliest record
+  *         it may still send. Keys only grow, except for a queue that was not waited for
+  *         and then sends an older record.
+  *         The watermark is loaded before the tail: a push stores the tail first, so a
+  *         watermark seen here belongs to a record the tail load sees too, and the key of
+  *         an empty queue is never above its next record
+  * @param  *queue pointer to the queue
+  * @param  *record set to the first record, NULL if the queue is empty
+  */
+static uint64_t hc_08_merge_key(hc_08_merge_queue_ST *queue, hc_08_merge_record_ST **record){
+  uint32_t head = (uint32_t)atomic_load_explicit(&queue->head, memory_order_relaxed);
+  uint64_t watermark = (uint64_t)atomic_load_explicit(&queue->watermark, memory_order_acquire);
+
+  if((uint32_t)atomic_load_explicit(&queue->tail, memory_order_acquire) != head){
+    *record = &queue->records[head & queue->mask];
+    return (*record)->timestamp_us;
+  }
+  *record = NULL;
+  return watermark > queue->key ? watermark : queue->key;
+}
+
+/**
+  * @brief  How far empty queues are passed while queues fill up: the newest record of the
+  *         queues filled above cfg.high. Only records that were pushed count, so a queue
+  *         is never passed up to now_us while its producer may still send
+  * @param  *merge pointer to the merge structure
+  * @retval timestamp of that record, 0 if no queue is filled above cfg.high
+  */
+static uint64_t hc_08_merge_pressure(hc_08_merge_ST *merge){
+  uint64_t bound = 0;
+
+  for(uint32_t i = 0; i < merge->heap_size; i++){
+    hc_08_merge_queue_ST *queue = merge->heap[i];
+    uint32_t tail = (uint32_t)atomic_load_explicit(&queue->tail, memory_order_acquire);
+    uint32_t used = tail - (uint32_t)atomic_load_explicit(&queue->head, memory_order_relaxed);
+
+    if(used > 0 && (uint64_t)used * 100 >= (uint64_t)(queue->mask + 1) * merge->cfg.high){
+      uint64_t newest = queue->records[(tail - 1) & queue->mask].timestamp_us;
+
+      bound = newest > bound ? newest : bound;
+    }
+  }
+  return bound;
+}
+
+/**
+  * @brief  Initialization of a module queue
+  * @param  *queue pointer to the queue structure
+  * @param  *records records owned by the caller, valid as long as the queue is used
+  * @param  count number of records, a power of two
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if count is not a power of two
+  */
+hc_08_status hc_08_merge_queue_init(hc_08_merge_queue_ST *queue, hc_08_merge_record_ST *records, uint32_t count){
+  if(records == NULL || count < 2 || (count & (count - 1)) != 0){
+    return hc_08_status_error;
+  }
+  queue->records = records;
+  queue->mask = count - 1;
+  queue->source = 0;
+  queue->key = 0;
+  queue->heap_index = UINT32_MAX;
+  atomic_init(&queue->tail, 0);
+  atomic_init(&queue->watermark, 0);
+  atomic_init(&queue->full, 0);
+  atomic_init(&queue->disorder, 0);
+  atomic_init(&queue->head, 0);
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Queuing a record, from the producer thread of the queue. Never blocks
+  * @param  *queue pointer to the queue structure
+  * @param  timestamp_us time of the record, not older than the watermark
+  * @param  *data record data
+  * @param  size 0 to HC_08_MERGE_RECORD_SIZE bytes
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if the queue is full, the record is older than the watermark
+  *             or the size is out of range
+  */
+hc_08_status hc_08_merge_push(hc_08_merge_queue_ST *queue, uint64_t timestamp_us, const char *data, uint16_t size){
+  uint32_t tail = (uint32_t)atomic_load_explicit(&queue->tail, memory_order_relaxed);
+  hc_08_merge_record_ST *record;
+
+  if(size > HC_08_MERGE_RECORD_SIZE){
+    return hc_08_status_error;
+  }
+  if(timestamp_us < (uint64_t)atomic_load_explicit(&queue->watermark, memory_order_relaxed)){
+    atomic_fetch_add_explicit(&queue->disorder, 1, memory_order_relaxed);
+    return hc_08_status_error;
+  }
+  if(tail - (uint32_t)atomic_load_explicit(&queue->head, memory_order_acquire) > queue->mask){
+    atomic_fetch_add_explicit(&queue->full, 1, memory_order_relaxed);
+    return hc_08_status_error;
+  }
+
+  record = &queue->records[tail & queue->mask];
+  record->timestamp_us = timestamp_us;
+  record->source = queue->source;
+  record->size = size;
+  memcpy(record->data, data, size);
+  atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+  atomic_store_explicit(&queue->watermark, timestamp_us, memory_order_release);
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Moving the watermark while the module has nothing to send, from the producer
+  *         thread of the queue: no record older than timestamp_us will follow
+  * @param  *queue pointer to the queue structure
+  * @param  timestamp_us the new watermark, an older one is ignored
+  */
+void hc_08_merge_idle(hc_08_merge_queue_ST *queue, uint64_t timestamp_us){
+  if(timestamp_us > (uint64_t)atomic_load_explicit(&queue->watermark, memory_order_relaxed)){
+    atomic_store_explicit(&queue->watermark, timestamp_us, memory_order_release);
+  }
+}
+
+/**
+  * @brief  Number of records waiting in a queue
+  * @param  *queue pointer to the queue structure
+  */
+uint32_t hc_08_merge_queue_used(hc_08_merge_queue_ST *queue){
+  uint32_t head = (uint32_t)atomic_load_explicit(&queue->head, memory_order_acquire);
+
+  return (uint32_t)atomic_load_explicit(&queue->tail, memory_order_acquire) - head;
+}
+
+/**
+  * @brief  Initialization of the merge
+  * @param  *merge pointer to the merge structure
+  * @param  capacity maximum number of queues
+  * @param  output receives the records in time order. The record is valid only during the call
+  * @param  late receives the records older than the stream, NULL to drop them
+  * @param  *ctx user pointer passed to output and late
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error
+  */
+hc_08_status hc_08_merge_init(hc_08_merge_ST *merge, uint32_t capacity,
+                              void (*output)(void *ctx, const hc_08_merge_record_ST *record),
+                              void (*late)(void *ctx, const hc_08_merge_record_ST *record), void *ctx){
+  memset(merge, 0, sizeof(*merge));
+  merge->output = output;
+  merge->late = late;
+  merge->ctx = ctx;
+  merge->cfg.lateness_us = HC_08_MERGE_LATENESS_US;
+  merge->cfg.high = HC_08_MERGE_HIGH;
+  merge->capacity = capacity;
+  merge->heap = calloc(capacity, sizeof(merge->heap[0]));
+  return merge->heap != NULL ? hc_08_status_ok : hc_08_status_error;
+}
+
+/**
+  * @brief  Releasing the merge. The queues are not touched
+  * @param  *merge pointer to the merge structure
+  */
+void hc_08_merge_deinit(hc_08_merge_ST *merge){
+  free(merge->heap);
+  merge->heap = NULL;
+  merge->heap_size = 0;
+}
+
+/**
+  * @brief  Adding a module queue, before its first push. Its records get the number of
+  *         queues added before it as source
+  * @param  *merge pointer to the merge structure
+  * @param  *queue pointer to the queue, must stay valid as long as the merge is used
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if the merge is full
+  */
+hc_08_status hc_08_merge_add(hc_08_merge_ST *merge, hc_08_merge_queue_ST *queue){
+  hc_08_merge_record_ST *record;
+
+  if(merge->heap_size >= merge->capacity){
+    return hc_08_status_error;
+  }
+  queue->source = (uint16_t)merge->heap_size;
+  queue->key = hc_08_merge_key(queue, &record);
+  queue->heap_index = merge->heap_size;
+  merge->heap[merge->heap_size++] = queue;
+  hc_08_merge_heap_fix(merge, queue->heap_index);
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Sending the records that are in order. Called from one thread, periodically
+  *         and when records were pushed
+  * @param  *merge pointer to the merge structure
+  * @param  now_us current time, on the clock of the timestamps
+  * @param  max most records to send, 0 for no limit
+  * @retval number of records sent to output or late
+  */
+uint32_t hc_08_merge_process(hc_08_merge_ST *merge, uint64_t now_us, uint32_t max){
+  uint32_t count = 0;
+  uint64_t bound = 0;
+  uint8_t scanned = 0;
+
+  while(merge->heap_size > 0 && (max == 0 || count < max)){
+    hc_08_merge_queue_ST *queue = merge->heap[0];
+    hc_08_merge_record_ST *record;
+    uint64_t key = hc_08_merge_key(queue, &record);
+
+    if(key != queue->key){
+      queue->key = key;
+      hc_08_merge_heap_fix(merge, 0);
+      continue;
+    }
+
+    if(record != NULL){
+      if(record->timestamp_us < merge->watermark){
+        merge->metrics.late++;
+        if(merge->late != NULL){
+          merge->late(merge->ctx, record);
+        }
+      }else{
+        merge->watermark = record->timestamp_us;
+        merge->metrics.records++;
+        merge->output(merge->ctx, record);
+      }
+      atomic_store_explicit(&queue->head, (uint32_t)atomic_load_explicit(&queue->head, memory_order_relaxed) + 1,
+                            memory_order_release);
+      count++;
+      continue;
+    }
+
+    // empty queue on top: wait for it, unless it is silent for too long or others fill up
+    if(!scanned){
+      bound = hc_08_merge_pressure(merge);
+      scanned = 1;
+    }
+    if(now_us > key && now_us - key > merge->cfg.lateness_us){
+      queue->key = now_us - merge->cfg.lateness_us;
+    }else if(key < bound){
+      queue->key = bound;
+    }else{
+      merge->metrics.waits++;
+      break;
+    }
+    merge->metrics.skips++;
+    hc_08_merge_heap_fix(merge, 0);
+  }
+  return count;
+}
+
+/**
+  * @brief  End of the streams: every queued record is sent, no queue is waited for
+  * @param  *merge pointer to the merge structure
+  * @retval number of records sent to output or late
+  */
+uint32_t hc_08_merge_flush(hc_08_merge_ST *merge){
+  return hc_08_merge_process(merge, UINT64_MAX, 0);
+}
@@ -0,0 +1,91 @@
+#ifndef HC_08_MERGE_H
+#define HC_08_MERGE_H
+
+#include "hc-08.h"
+#include <stdatomic.h>
+
+#ifndef HC_08_MERGE_RECORD_SIZE
+#define HC_08_MERGE_RECORD_SIZE   0x20     // longest record data
+#endif
+
+#define HC_08_MERGE_LATENESS_US   500000   // longest wait for a module that sends nothing
+#define HC_08_MERGE_HIGH          75       // % of a queue in use that ends the wait at once
+
+typedef struct{
+  uint64_t timestamp_us;
+  uint16_t source;                          // index of the queue in the merge
+  uint16_t size;
+  char data[HC_08_MERGE_RECORD_SIZE];
+}hc_08_merge_record_ST;
+
+/*
+ * Queue of the timestamped records of one module: one producer (the thread reading the
+ * module), one consumer (the merge). Records are pushed in time order. The watermark is
+ * the producer's promise that no record older than it will follow: every push moves it to
+ * the record, and hc_08_merge_idle(...) moves it while the module has nothing to send.
+ * The records are owned by the caller, their number must be a power of two; a push to a
+ * full queue is refused, so the memory of the merge is bounded by the queues.
+ */
+typedef struct{
+  hc_08_merge_record_ST *records;
+  uint32_t mask;
+  uint16_t source;
+
+  _Alignas(64) atomic_uint_fast32_t tail;   // next record to write, owned by the producer
+  atomic_uint_fast64_t watermark;
+  atomic_uint_fast32_t full;                // pushes refused because the queue was full
+  atomic_uint_fast32_t disorder;            // pushes refused, older than the watermark
+
+  _Alignas(64) atomic_uint_fast32_t head;   // next record to merge, owned by the merge
+  uint64_t key;                             // head record or bound of the queue in the heap
+  uint32_t heap_index;
+}hc_08_merge_queue_ST;
+
+/*
+ * Time-ordered merge of the queues of many modules into one stream, from one thread.
+ * A heap keeps the queues by their key: the timestamp of the first record, or for an
+ * empty queue the earliest timestamp it may still send (its watermark). The record on top
+ * is sent to output(...) while no queue can send an older one. An empty queue whose
+ * watermark is older than now_us - cfg.lateness_us is not waited for any longer. While
+ * another queue is cfg.high % full, an empty queue is passed only as far as the records
+ * waiting in the others. Records that such a module sends later than the stream go to
+ * late(...) (if given) instead. Timestamps and now_us come
+ * from the same clock.
+ */
+typedef struct{
+  hc_08_merge_queue_ST **heap;
+  uint32_t heap_size;
+  uint32_t capacity;
+  void (*output)(void *ctx, const hc_08_merge_record_ST *record);
+  void (*late)(void *ctx, const hc_08_merge_record_ST *record);
+  void *ctx;
+
+  struct{
+    uint64_t lateness_us;
+    uint8_t high;
+  }cfg;
+
+  uint64_t watermark;                       // timestamp of the last record sent to output
+
+  struct{
+    uint64_t records;
+    uint64_t late;
+    uint32_t waits;                         // process calls stopped by an empty queue
+    uint32_t skips;                         // empty queues not waited for any longer
+  }metrics;
+}hc_08_merge_ST;
+
+hc_08_status hc_08_merge_queue_init(hc_08_merge_queue_ST *queue, hc_08_merge_record_ST *records, uint32_t count);
+hc_08_status hc_08_merge_push(hc_08_merge_queue_ST *queue, uint64_t timestamp_us, const char *data, uint16_t size);
+void hc_08_merge_idle(hc_08_merge_queue_ST *queue, uint64_t timestamp_us);
+uint32_t hc_08_merge_queue_used(hc_08_merge_queue_ST *queue);
+
+hc_08_status hc_08_merge_init(hc_08_merge_ST *merge, uint32_t capacity,
+                              void (*output)(void *ctx, const hc_08_merge_record_ST *record),
+                              void (*late)(void *ctx, const hc_08_merge_record_ST *record), void *ctx);
+void hc_08_merge_deinit(hc_08_merge_ST *merge);
+hc_08_status hc_08_merge_add(hc_08_merge_ST *merge, hc_08_merge_queue_ST *queue);
+uint32_t hc_08_merge_process(hc_08_merge_ST *merge, uint64_t now_us, uint32_t max);
+uint32_t hc_08_merge_flush(hc_08_merge_ST *merge);
+
+#endif /* HC_08_MERGE_H */
@@ -0,0 +1,384 @@
+#include "hc-08-pair.h"
+#include <string.h>
+
+/**
+  * @brief  Pseudo-random number for the air losses
+  * @retval 0..999999
+  */
+static uint32_t hc_08_pair_random(hc_08_pair_ST *pair){
+  pair->seed = pair->seed * 1664525UL + 1013904223UL;
+  return (pair->seed >> 8) % 1000000UL;
+}
+
+/**
+  * @brief  First connection event at or after a time
+  * @param  *pair pointer to the pair structure
+  * @param  time_us the time
+  */
+static uint64_t hc_08_pair_event_at(hc_08_pair_ST *pair, uint64_t time_us){
+  uint32_t interval = hc_08_pair_interval_us(pair);
+
+  if(time_us <= pair->anchor_us){
+    return pair->anchor_us;
+  }
+  return pair->anchor_us + (time_us - pair->anchor_us + interval - 1) / interval * interval;
+}
+
+/**
+  * @brief  Whether a packet sent in a connection event is lost on the air
+  * @param  *pair pointer to the pair structure
+  * @param  event_us the connection event
+  */
+static uint8_t hc_08_pair_lost(hc_08_pair_ST *pair, uint64_t event_us){
+  if(event_us >= pair->fade_start_us && event_us < pair->fade_end_us){
+    return 1;
+  }
+  return pair->loss_ppm > 0 && hc_08_pair_random(pair) < pair->loss_ppm;
+}
+
+/**
+  * @brief  Recording a supervision timeout, the earliest one wins
+  * @param  *pair pointer to the pair structure
+  * @param  time_us time at which the link is lost
+  */
+static void hc_08_pair_timeout(hc_08_pair_ST *pair, uint64_t time_us){
+  if(time_us < pair->timeout_us){
+    pair->timeout_us = time_us;
+  }
+}
+
+/**
+  * @brief  Supervision timeout of a fade that covers the connection
+  * @param  *pair pointer to the pair structure
+  */
+static void hc_08_pair_check_fade(hc_08_pair_ST *pair){
+  uint64_t start = pair->fade_start_us > pair->anchor_us ? pair->fade_start_us : pair->anchor_us;
+
+  if(pair->connected && pair->fade_end_us > start && pair->fade_end_us - start >= hc_08_pair_supervision_us(pair)){
+    hc_08_pair_timeout(pair, start + hc_08_pair_supervision_us(pair));
+  }
+}
+
+/**
+  * @brief  Time of the first connection event for a connection started at a time: the
+  *         average wait for an advertising packet of the slave and one connection interval.
+  *         Nothing is received during a fade
+  * @param  *pair pointer to the pair structure
+  * @param  start_us start of the connection
+  */
+static uint64_t hc_08_pair_schedule(hc_08_pair_ST *pair, uint64_t start_us){
+  if(start_us >= pair->fade_start_us && start_us < pair->fade_end_us){
+    start_us = pair->fade_end_us;
+  }
+  pair->reconnect_us = start_us + (uint64_t)pair->side[1].emu.param.aint * 625 / 2 + hc_08_pair_interval_us(pair);
+  return pair->reconnect_us;
+}
+
+/**
+  * @brief  Start of the connection at pair->reconnect_us
+  * @param  *pair pointer to the pair structure
+  */
+static void hc_08_pair_up(hc_08_pair_ST *pair){
+  for(uint8_t i = 0; i < 2; i++){
+    hc_08_pair_flow_ST *flow = &pair->flow[i];
+
+    flow->head = flow->tail = 0;
+    flow->uart_in_us = flow->uart_out_us = flow->event_us = 0;
+    flow->event_packets = 0;
+    pair->side[i].hc_08->status_connect = hc_08_status_connected;
+  }
+  pair->anchor_us = pair->reconnect_us;
+  pair->reconnect_us = HC_08_PAIR_NEVER;
+  pair->timeout_us = HC_08_PAIR_NEVER;
+  pair->connected = 1;
+  pair->stats.connects++;
+  hc_08_pair_check_fade(pair);
+}
+
+/**
+  * @brief  Number of packets in a direction
+  */
+static uint32_t hc_08_pair_count(const hc_08_pair_flow_ST *flow){
+  return (flow->tail - flow->head) % HC_08_PAIR_PACKETS;
+}
+
+/**
+  * @brief  Bytes the sending module still holds for the air at the current time
+  * @param  *pair pointer to the pair structure
+  * @param  *flow the direction
+  */
+static uint32_t hc_08_pair_buffered(hc_08_pair_ST *pair, const hc_08_pair_flow_ST *flow){
+  uint32_t bytes = 0;
+
+  for(uint32_t i = flow->head; i != flow->tail; i = (i + 1) % HC_08_PAIR_PACKETS){
+    if(flow->packet[i].event_us > pair->time_us){
+      bytes += flow->packet[i].size;
+    }
+  }
+  return bytes;
+}
+
+/**
+  * @brief  Sending data written by the host of one side over the air
+  * @param  *pair pointer to the pair structure
+  * @param  index sending side
+  * @param  *buff data
+  * @param  size data size
+  */
+static void hc_08_pair_send(hc_08_pair_ST *pair, uint8_t index, const char *buff, uint16_t size){
+  hc_08_pair_flow_ST *flow = &pair->flow[index];
+  hc_08_emu_ST *sender = &pair->side[index].emu;
+  uint32_t byte_in = hc_08_emu_byte_time_us(sender);
+  uint32_t byte_out = hc_08_emu_byte_time_us(&pair->side[index ^ 1].emu);
+  uint32_t interval = hc_08_pair_interval_us(pair);
+  uint32_t supervision = hc_08_pair_supervision_us(pair);
+  uint32_t buffered = hc_08_pair_buffered(pair, flow);
+  uint64_t start = pair->time_us > flow->uart_in_us ? pair->time_us : flow->uart_in_us;
+
+  if(sender->param.mode != hc_08_mode_full){
+    start += HC_08_EMU_WAKE_US;
+  }
+  flow->uart_in_us = start + (uint64_t)size * byte_in;
+
+  for(uint16_t offset = 0; offset < size; offset += HC_08_EMU_PKT_PAYLOAD){
+    uint16_t chunk = size - offset < HC_08_EMU_PKT_PAYLOAD ? size - offset : HC_08_EMU_PKT_PAYLOAD;
+    hc_08_pair_packet_ST *packet = &flow->packet[flow->tail];
+    uint64_t ready = start + (uint64_t)(offset + chunk) * byte_in;
+    uint64_t event, first;
+
+    if(hc_08_pair_count(flow) == HC_08_PAIR_PACKETS - 1 || buffered + chunk > HC_08_PAIR_MODULE_BUFFER){
+      flow->stats.dropped += size - offset;
+      return;
+    }
+    buffered += chunk;
+
+    event = hc_08_pair_event_at(pair, ready > flow->event_us ? ready : flow->event_us);
+    if(event == flow->event_us && flow->event_packets >= pair->pkt_per_event){
+      event += interval;
+    }
+    first = event;
+    while(hc_08_pair_lost(pair, event)){
+      flow->stats.retransmits++;
+      event += interval;
+      if(event - first >= supervision){
+        hc_08_pair_timeout(pair, first + supervision);
+        break;
+      }
+    }
+    // the link is gone before the packet gets through
+    if(event >= pair->timeout_us){
+      flow->stats.dropped += size - offset;
+      return;
+    }
+    if(event != flow->event_us){
+      flow->event_us = event;
+      flow->event_packets = 0;
+    }
+    flow->event_packets++;
+
+    packet->event_us = event;
+    packet->deliver_us = (event > flow->uart_out_us ? event : flow->uart_out_us) + (uint64_t)chunk * byte_out;
+    flow->uart_out_us = packet->deliver_us;
+    packet->size = chunk;
+    memcpy(packet->data, buff + offset, chunk);
+    flow->tail = (flow->tail + 1) % HC_08_PAIR_PACKETS;
+    flow->stats.packets++;
+    flow->stats.bytes += chunk;
+  }
+}
+
+/**
+  * @brief  Initialization of two emulated modules with the factory settings, side 0 as master.
+  *         The UART functions of both module structures are bound to the pair
+  * @param  *pair pointer to the pair structure
+  * @param  *master pointer to the HC-08 module structure of side 0
+  * @param  *slave pointer to the HC-08 module structure of side 1
+  */
+void hc_08_pair_init(hc_08_pair_ST *pair, hc_08_ST *master, hc_08_ST *slave){
+  hc_08_ST *hc_08[2] = {master, slave};
+
+  memset(pair, 0, sizeof(*pair));
+  pair->seed = 1;
+  pair->pkt_per_event = HC_08_EMU_PKT_PER_EVENT;
+  pair->timeout_us = HC_08_PAIR_NEVER;
+  pair->reconnect_us = HC_08_PAIR_NEVER;
+  for(uint8_t i = 0; i < 2; i++){
+    hc_08_pair_side_ST *side = &pair->side[i];
+
+    side->pair = pair;
+    side->index = i;
+    side->hc_08 = hc_08[i];
+    hc_08_emu_init(&side->emu);
+    hc_08_reg_uart_cbfunc_ctx(hc_08[i], hc_08_pair_tx, hc_08_pair_rx, side);
+    hc_08[i]->status_connect = hc_08_status_not_connected;
+  }
+  pair->side[0].emu.param.role = hc_08_role_master;
+}
+
+/**
+  * @brief  Connecting the modules. The clock moves by the average wait for an advertising
+  *         packet of the slave and one connection interval
+  * @param  *pair pointer to the pair structure
+  */
+void hc_08_pair_connect(hc_08_pair_ST *pair){
+  uint64_t start = pair->time_us;
+
+  pair->time_us = hc_08_pair_schedule(pair, start);
+  pair->stats.connect_us += pair->time_us - start;
+  hc_08_pair_up(pair);
+}
+
+/**
+  * @brief  Disconnecting the modules. Data still in flight is lost
+  * @param  *pair pointer to the pair structure
+  */
+void hc_08_pair_disconnect(hc_08_pair_ST *pair){
+  pair->connected = 0;
+  pair->timeout_us = HC_08_PAIR_NEVER;
+  pair->reconnect_us = HC_08_PAIR_NEVER;
+  for(uint8_t i = 0; i < 2; i++){
+    hc_08_pair_flow_ST *flow = &pair->flow[i];
+
+    for(uint32_t p = flow->head; p != flow->tail; p = (p + 1) % HC_08_PAIR_PACKETS){
+      flow->stats.dropped += flow->packet[p].size;
+    }
+    flow->head = flow->tail;
+    pair->side[i].hc_08->status_connect = hc_08_status_not_connected;
+  }
+}
+
+/**
+  * @brief  Moving the clock forward, through the supervision timeouts and reconnections on
+  *         the way
+  * @param  *pair pointer to the pair structure
+  * @param  time_us new time, ignored if it is in the past
+  */
+void hc_08_pair_advance(hc_08_pair_ST *pair, uint64_t time_us){
+  for(;;){
+    if(pair->connected && pair->timeout_us <= time_us){
+      uint64_t start = pair->timeout_us > pair->time_us ? pair->timeout_us : pair->time_us;
+
+      pair->time_us = start;
+      pair->stats.timeouts++;
+      hc_08_pair_disconnect(pair);
+      if(pair->reconnect){
+        pair->stats.connect_us += hc_08_pair_schedule(pair, start) - start;
+      }
+    }else if(!pair->connected && pair->reconnect_us <= time_us){
+      if(pair->reconnect_us > pair->time_us){
+        pair->time_us = pair->reconnect_us;
+      }
+      hc_08_pair_up(pair);
+    }else{
+      break;
+    }
+  }
+  if(time_us > pair->time_us){
+    pair->time_us = time_us;
+  }
+}
+
+/**
+  * @brief  Setting a fade: nothing gets through the air for a while. A fade as long as the
+  *         supervision timeout ends the connection
+  * @param  *pair pointer to the pair structure
+  * @param  start_us start of the fade
+  * @param  duration_us length of the fade
+  */
+void hc_08_pair_fade(hc_08_pair_ST *pair, uint64_t start_us, uint32_t duration_us){
+  pair->fade_start_us = start_us;
+  pair->fade_end_us = start_us + duration_us;
+  hc_08_pair_check_fade(pair);
+}
+
+/**
+  * @brief  Time of the next thing that happens on the link: a packet that comes out of a
+  *         UART, a supervision timeout or a reconnection, to move the clock straight to it
+  * @param  *pair pointer to the pair structure
+  * @retval us, HC_08_PAIR_NEVER if nothing is pending
+  */
+uint64_t hc_08_pair_next_us(hc_08_pair_ST *pair){
+  uint64_t next = pair->connected ? pair->timeout_us : pair->reconnect_us;
+
+  for(uint8_t i = 0; i < 2; i++){
+    const hc_08_pair_flow_ST *flow = &pair->flow[i];
+
+    if(flow->head != flow->tail && flow->packet[flow->head].deliver_us < next){
+      next = flow->packet[flow->head].deliver_us;
+    }
+  }
+  return next;
+}
+
+/**
+  * @brief  Connection interval set on the master (middle of cint_min..cint_max)
+  * @param  *pair pointer to the pair structure
+  * @retval us
+  */
+uint32_t hc_08_pair_interval_us(hc_08_pair_ST *pair){
+  const hc_08_emu_ST *master = &pair->side[0].emu;
+
+  return ((uint32_t)master->param.cint_min + master->param.cint_max) * 1250 / 2;
+}
+
+/**
+  * @brief  Supervision timeout set on the master (ctout, 10 ms units)
+  * @param  *pair pointer to the pair structure
+  * @retval us
+  */
+uint32_t hc_08_pair_supervision_us(hc_08_pair_ST *pair){
+  return (uint32_t)pair->side[0].emu.param.ctout * 10000;
+}
+
+/**
+  * @brief  UART transmit function of one side (see hc_08_reg_uart_cbfunc_ctx). AT commands
+  *         while not connected, data for the other side while connected
+  * @param  *ctx pointer to the side structure
+  * @param  *buff data
+  * @param  size data size
+  */
+void hc_08_pair_tx(void *ctx, char *buff, uint16_t size){
+  hc_08_pair_side_ST *side = (hc_08_pair_side_ST *)ctx;
+  hc_08_pair_ST *pair = side->pair;
+
+  if(pair->connected){
+    hc_08_pair_send(pair, side->index, buff, size);
+    return;
+  }
+  side->emu.time_us = pair->time_us;
+  hc_08_emu_tx(&side->emu, buff, size);
+  pair->time_us = side->emu.time_us;
+}
+
+/**
+  * @brief  UART receive function of one side (see hc_08_reg_uart_cbfunc_ctx). Never waits:
+  *         returns the packets that came out of the UART up to the current time
+  * @param  *ctx pointer to the side structure
+  * @param  *buff receive buffer
+  * @param  size receive buffer size
+  * @retval number of bytes written to buff
+  */
+uint16_t hc_08_pair_rx(void *ctx, char *buff, uint16_t size){
+  hc_08_pair_side_ST *side = (hc_08_pair_side_ST *)ctx;
+  hc_08_pair_ST *pair = side->pair;
+  hc_08_pair_flow_ST *flow = &pair->flow[side->index ^ 1];
+  uint16_t count = 0;
+
+  if(!pair->connected){
+    side->emu.time_us = pair->time_us;
+    count = hc_08_emu_rx(&side->emu, buff, size);
+    pair->time_us = side->emu.time_us;
+    return count;
+  }
+  while(flow->head != flow->tail){
+    hc_08_pair_packet_ST *packet = &flow->packet[flow->head];
+
+    if(packet->deliver_us > pair->time_us || packet->size > size - count){
+      break;
+    }
+    memcpy(buff + count, packet->data, packet->size);
+    count += packet->size;
+    flow->head = (flow->head + 1) % HC_08_PAIR_PACKETS;
+  }
+  return count;
+}
@@ -0,0 +1,93 @@
+#ifndef HC_08_PAIR_H
+#define HC_08_PAIR_H
+
+#include "hc-08.h"
+#include "hc-08-emu.h"
+
+#define HC_08_PAIR_PACKETS        512    // packets in flight per direction
+#define HC_08_PAIR_MODULE_BUFFER  512    // bytes a module holds for the air, more are dropped
+#define HC_08_PAIR_NEVER          UINT64_MAX
+
+typedef struct{
+  uint64_t event_us;       // connection event that carries it
+  uint64_t deliver_us;     // last byte out of the receiving UART
+  uint16_t size;
+  char data[HC_08_EMU_PKT_PAYLOAD];
+}hc_08_pair_packet_ST;
+
+/*
+ * One direction of the link
+ */
+typedef struct{
+  hc_08_pair_packet_ST packet[HC_08_PAIR_PACKETS];
+  uint32_t head;
+  uint32_t tail;
+  uint64_t uart_in_us;     // sending UART busy until
+  uint64_t uart_out_us;    // receiving UART busy until
+  uint64_t event_us;       // last event with packets of this direction
+  uint8_t event_packets;
+
+  struct{
+    uint32_t packets;
+    uint32_t bytes;
+    uint32_t retransmits;
+    uint32_t dropped;      // bytes that did not fit the module buffer
+  }stats;
+}hc_08_pair_flow_ST;
+
+struct hc_08_pair;
+
+typedef struct{
+  struct hc_08_pair *pair;
+  uint8_t index;
+  hc_08_emu_ST emu;        // AT interface of the module, used while not connected
+  hc_08_ST *hc_08;
+}hc_08_pair_side_ST;
+
+/*
+ * Two emulated modules connected to each other. While not connected each side is a
+ * hc-08-emu answering AT commands. Once connected, bytes written to one side come out of
+ * the other after the UART time of both modules, the wait for the next connection event
+ * (cint of side 0, the master) and at most pkt_per_event packets of
+ * HC_08_EMU_PKT_PAYLOAD bytes per event and direction. A packet lost on the air
+ * (loss_ppm, or a fade set with hc_08_pair_fade(...)) is sent again in the next event;
+ * when nothing gets through for the supervision timeout (ctout of the master) the link
+ * is lost, and with reconnect set the modules connect again after the advertising of the
+ * slave (aint). Both sides share one virtual clock, time_us: receiving never waits, the
+ * caller moves the clock with hc_08_pair_advance(...).
+ */
+typedef struct hc_08_pair{
+  hc_08_pair_side_ST side[2];
+  hc_08_pair_flow_ST flow[2];      // flow[i] goes from side i to the other side
+  uint64_t time_us;
+  uint64_t anchor_us;              // first connection event
+  uint8_t connected;
+  uint8_t reconnect;               // connect again after a supervision timeout
+  uint8_t pkt_per_event;           // HC_08_EMU_PKT_PER_EVENT by default
+  uint32_t loss_ppm;               // packets lost on the air per million
+  uint32_t seed;
+  uint64_t fade_start_us;          // nothing gets through in fade_start_us..fade_end_us
+  uint64_t fade_end_us;
+  uint64_t timeout_us;             // supervision timeout to come, HC_08_PAIR_NEVER if none
+  uint64_t reconnect_us;           // next connection, HC_08_PAIR_NEVER if none
+
+  struct{
+    uint32_t connects;
+    uint32_t timeouts;             // supervision timeouts
+    uint64_t connect_us;           // time spent connecting
+  }stats;
+}hc_08_pair_ST;
+
+void hc_08_pair_init(hc_08_pair_ST *pair, hc_08_ST *master, hc_08_ST *slave);
+void hc_08_pair_connect(hc_08_pair_ST *pair);
+void hc_08_pair_disconnect(hc_08_pair_ST *pair);
+void hc_08_pair_advance(hc_08_pair_ST *pair, uint64_t time_us);
+void hc_08_pair_fade(hc_08_pair_ST *pair, uint64_t start_us, uint32_t duration_us);
+uint64_t hc_08_pair_next_us(hc_08_pair_ST *pair);
+uint32_t hc_08_pair_interval_us(hc_08_pair_ST *pair);
+uint32_t hc_08_pair_supervision_us(hc_08_pair_ST *pair);
+
+void hc_08_pair_tx(void *ctx, char *buff, uint16_t size);
+uint16_t hc_08_pair_rx(void *ctx, char *buff, uint16_t size);
+
+#endif /* HC_08_PAIR_H */
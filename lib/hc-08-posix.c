@@ -0,0 +1,260 @@
+#define _DEFAULT_SOURCE
+#include "hc-08-posix.h"
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#ifdef __linux__
+#include <linux/serial.h>
+#endif
+
+static const speed_t hc_08_posix_speed[] = {
+  [hc_08_baud_1200bps] = B1200,
+  [hc_08_baud_2400bps] = B2400,
+  [hc_08_baud_4800bps] = B4800,
+  [hc_08_baud_9600bps] = B9600,
+  [hc_08_baud_19200bps] = B19200,
+  [hc_08_baud_38400bps] = B38400,
+  [hc_08_baud_57600bps] = B57600,
+  [hc_08_baud_115200bps] = B115200
+};
+
+/**
+  * @brief  Asking the serial driver to push received bytes to user space without the
+  *         usual batching delay. Drivers that do not support it (pseudo terminals) are ignored
+  * @param  fd tty descriptor
+  */
+static void hc_08_posix_low_latency(int fd){
+#if defined(__linux__) && defined(ASYNC_LOW_LATENCY)
+  struct serial_struct serial;
+
+  if(ioctl(fd, TIOCGSERIAL, &serial) == 0){
+    serial.flags |= ASYNC_LOW_LATENCY;
+    ioctl(fd, TIOCSSERIAL, &serial);
+  }
+#else
+  (void)fd;
+#endif
+}
+
+/**
+  * @brief  Opening a tty for the module: raw 8 data bits, 1 stop bit, no flow control,
+  *         non-blocking descriptor with VMIN = 0 and VTIME = 0
+  * @param  *port pointer to the port structure
+  * @param  *path tty path, e.g. "/dev/ttyUSB0"
+  * @param  baud UART baud rate, must match the module (hc_08_baud_9600bps after AT+DEFAULT)
+  * @param  parity UART parity bit
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if the tty cannot be opened or configured (errno is kept)
+  */
+hc_08_status hc_08_posix_open(hc_08_posix_ST *port, const char *path, hc_08_baud baud, hc_08_parity_bit parity){
+  port->fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+  port->rx_timeout = HC_08_POSIX_RX_TIMEOUT;
+  port->rx_idle = HC_08_POSIX_RX_IDLE;
+  port->tx_errors = 0;
+  port->tx_dropped = 0;
+  if(port->fd < 0){
+    return hc_08_status_error;
+  }
+
+  ioctl(port->fd, TIOCEXCL);
+  if(hc_08_posix_configure(port, baud, parity) != hc_08_status_ok){
+    int error = errno;
+
+    close(port->fd);
+    port->fd = -1;
+    errno = error;
+    return hc_08_status_error;
+  }
+  hc_08_posix_low_latency(port->fd);
+  tcflush(port->fd, TCIOFLUSH);
+
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Changing the baud rate and parity of an open port, e.g. after AT+BAUD
+  * @param  *port pointer to the port structure
+  * @param  baud UART baud rate
+  * @param  parity UART parity bit
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error
+  */
+hc_08_status hc_08_posix_configure(hc_08_posix_ST *port, hc_08_baud baud, hc_08_parity_bit parity){
+  struct termios tio;
+
+  if((unsigned int)baud >= HC_08_BAUD_SIZE || (unsigned int)parity >= HC_08_PARITY_SIZE ||
+      tcgetattr(port->fd, &tio) != 0){
+    return hc_08_status_error;
+  }
+
+  cfmakeraw(&tio);
+  tio.c_cflag &= ~(CSIZE | CSTOPB | PARENB | PARODD | CRTSCTS);
+  tio.c_cflag |= CS8 | CLOCAL | CREAD;
+  if(parity == hc_08_parity_bit_even_parity){
+    tio.c_cflag |= PARENB;
+  }else if(parity == hc_08_parity_bit_odd_parity){
+    tio.c_cflag |= PARENB | PARODD;
+  }
+  tio.c_iflag &= ~(IXON | IXOFF | IXANY);
+  tio.c_cc[VMIN] = 0;
+  tio.c_cc[VTIME] = 0;
+  cfsetispeed(&tio, hc_08_posix_speed[baud]);
+  cfsetospeed(&tio, hc_08_posix_speed[baud]);
+
+  if(tcsetattr(port->fd, TCSANOW, &tio) != 0){
+    return hc_08_status_error;
+  }
+  port->baud = baud;
+  port->parity = parity;
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  hc_08_posix_configure(...) with the signature of the line callbacks (hc-08-resync.h)
+  * @param  *ctx pointer to the port structure
+  */
+hc_08_status hc_08_posix_set_line(void *ctx, hc_08_baud baud, hc_08_parity_bit parity){
+  return hc_08_posix_configure((hc_08_posix_ST *)ctx, baud, parity);
+}
+
+/**
+  * @brief  Setting rx_timeout, with the signature of the timeout callbacks (hc-08-caps.h)
+  * @param  *ctx pointer to the port structure
+  * @param  timeout ms to wait for the first byte of an answer
+  */
+void hc_08_posix_set_timeout(void *ctx, uint32_t timeout){
+  ((hc_08_posix_ST *)ctx)->rx_timeout = timeout;
+}
+
+/**
+  * @brief  Closing the port
+  * @param  *port pointer to the port structure
+  */
+void hc_08_posix_close(hc_08_posix_ST *port){
+  if(port->fd >= 0){
+    close(port->fd);
+    port->fd = -1;
+  }
+}
+
+/**
+  * @brief  Binding the port to the module structure
+  * @param  *port pointer to the port structure
+  * @param  *hc_08 pointer to the HC-08 module structure
+  */
+void hc_08_posix_attach(hc_08_posix_ST *port, hc_08_ST *hc_08){
+  hc_08_reg_uart_cbfunc_ctx(hc_08, hc_08_posix_tx, hc_08_posix_rx, port);
+}
+
+/**
+  * @brief  Descriptor that becomes readable (poll, select, epoll) when the module sends data
+  * @param  *port pointer to the port structure
+  */
+int hc_08_posix_fd(hc_08_posix_ST *port){
+  return port->fd;
+}
+
+/**
+  * @brief  UART transmit function of the port (see hc_08_reg_uart_cbfunc_ctx). Waits for room
+  *         in the output queue when the driver is full. If no room appears within rx_timeout
+  *         or write fails, the rest of the buffer is dropped and counted in tx_errors and
+  *         tx_dropped
+  * @param  *ctx pointer to the port structure
+  * @param  *buff pointer to the buffer with the data to be transferred
+  * @param  size number of bytes of data to be transferred
+  */
+void hc_08_posix_tx(void *ctx, char *buff, uint16_t size){
+  hc_08_posix_ST *port = (hc_08_posix_ST *)ctx;
+  uint16_t sent = 0;
+
+  while(sent < size){
+    ssize_t count = write(port->fd, buff + sent, size - sent);
+
+    if(count > 0){
+      sent += (uint16_t)count;
+    }else if(count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)){
+      struct pollfd pfd = {.fd = port->fd, .events = POLLOUT};
+
+      int ready = poll(&pfd, 1, (int)port->rx_timeout);
+
+      if(ready < 0 && errno == EINTR){
+        continue;
+      }
+      if(ready <= 0){
+        break;
+      }
+    }else if(count < 0 && errno == EINTR){
+      continue;
+    }else{
+      break;
+    }
+  }
+  if(sent < size){
+    port->tx_errors++;
+    port->tx_dropped += size - sent;
+  }
+}
+
+/**
+  * @brief  Reading the bytes that are already waiting, without blocking
+  * @param  *port pointer to the port structure
+  * @param  *buff receive buffer
+  * @param  size receive buffer size
+  * @retval number of bytes read
+  */
+uint16_t hc_08_posix_read(hc_08_posix_ST *port, char *buff, uint16_t size){
+  uint16_t received = 0;
+
+  while(received < size){
+    ssize_t count = read(port->fd, buff + received, size - received);
+
+    if(count > 0){
+      received += (uint16_t)count;
+    }else if(count < 0 && errno == EINTR){
+      continue;
+    }else{
+      break;
+    }
+  }
+  return received;
+}
+
+/**
+  * @brief  UART receive function of the port (see hc_08_reg_uart_cbfunc_ctx). Waits up to
+  *         rx_timeout for the first byte, then collects bytes until the line has been idle
+  *         for rx_idle or the buffer is full, like a receive-to-idle DMA transfer
+  * @param  *ctx pointer to the port structure
+  * @param  *buff receive buffer
+  * @param  size receive buffer size
+  * @retval number of bytes received
+  */
+uint16_t hc_08_posix_rx(void *ctx, char *buff, uint16_t size){
+  hc_08_posix_ST *port = (hc_08_posix_ST *)ctx;
+  struct pollfd pfd = {.fd = port->fd, .events = POLLIN};
+  uint16_t received = 0;
+  int timeout = (int)port->rx_timeout;
+
+  while(received < size){
+    int ready = poll(&pfd, 1, timeout);
+
+    if(ready < 0 && errno == EINTR){
+      continue;
+    }
+    if(ready <= 0 || !(pfd.revents & POLLIN)){
+      break;
+    }
+    uint16_t count = hc_08_posix_read(port, buff + received, size - received);
+    if(count == 0){
+      break;
+    }
+    received += count;
+    timeout = (int)port->rx_idle;
+  }
+  return received;
+}
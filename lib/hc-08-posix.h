@@ -0,0 +1,37 @@
+#ifndef HC_08_POSIX_H
+#define HC_08_POSIX_H
+
+#include "hc-08.h"
+
+#define HC_08_POSIX_RX_TIMEOUT    1000  // ms to wait for the first byte of an answer
+#define HC_08_POSIX_RX_IDLE       20    // ms of silence that ends an answer
+
+/*
+ * UART functions for a HC-08 attached to a Linux tty (USB-serial adapter, on-board UART).
+ * The descriptor is non-blocking; hc_08_posix_rx(...) waits with poll() so that
+ * hc_08_read_answer(...) keeps its blocking behaviour, while event loops use
+ * hc_08_posix_fd(...) and hc_08_posix_read(...) directly.
+ */
+typedef struct{
+  int fd;
+  hc_08_baud baud;
+  hc_08_parity_bit parity;
+  uint32_t rx_timeout;
+  uint32_t rx_idle;
+  uint32_t tx_errors;     // hc_08_posix_tx(...) calls that gave up (poll timeout, write error)
+  uint32_t tx_dropped;    // bytes those calls did not write
+}hc_08_posix_ST;
+
+hc_08_status hc_08_posix_open(hc_08_posix_ST *port, const char *path, hc_08_baud baud, hc_08_parity_bit parity);
+hc_08_status hc_08_posix_configure(hc_08_posix_ST *port, hc_08_baud baud, hc_08_parity_bit parity);
+hc_08_status hc_08_posix_set_line(void *ctx, hc_08_baud baud, hc_08_parity_bit parity);
+void hc_08_posix_set_timeout(void *ctx, uint32_t timeout);
+void hc_08_posix_close(hc_08_posix_ST *port);
+void hc_08_posix_attach(hc_08_posix_ST *port, hc_08_ST *hc_08);
+int hc_08_posix_fd(hc_08_posix_ST *port);
+
+void hc_08_posix_tx(void *ctx, char *buff, uint16_t size);
+uint16_t hc_08_posix_rx(void *ctx, char *buff, uint16_t size);
+uint16_t hc_08_posix_read(hc_08_posix_ST *port, char *buff, uint16_t size);
+
+#endif /* HC_08_POSIX_H */
@@ -0,0 +1,234 @@
+#include "hc-08-prio.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+  * @brief  Adding an item at the end of the queue of its class
+  */
+static void hc_08_prio_queue(hc_08_prio_ST *prio, hc_08_prio_item_ST *item){
+  item->next = NULL;
+  item->sent = 0;
+  item->tick = hc_08_get_tick(prio->hc_08);
+  if(prio->tail[item->cls] != NULL){
+    prio->tail[item->cls]->next = item;
+  }else{
+    prio->head[item->cls] = item;
+  }
+  prio->tail[item->cls] = item;
+}
+
+/**
+  * @brief  Removing the head of a queue and reporting it done
+  */
+static void hc_08_prio_finish(hc_08_prio_ST *prio, hc_08_prio_class cls){
+  hc_08_prio_item_ST *item = prio->head[cls];
+
+  prio->head[cls] = item->next;
+  if(prio->head[cls] == NULL){
+    prio->tail[cls] = NULL;
+  }
+  prio->metrics.items[cls]++;
+  if(item->done != NULL){
+    item->done(prio->hc_08, item);
+  }
+}
+
+/**
+  * @brief  Recording the wait of an item that starts now
+  */
+static void hc_08_prio_started(hc_08_prio_ST *prio, hc_08_prio_item_ST *item, uint32_t now){
+  uint32_t wait = now - item->tick;
+  hc_08_prio_class cls = item->cls;
+
+  prio->started[cls]++;
+  prio->metrics.wait_sum[cls] += wait;
+  prio->metrics.wait_avg[cls] = (uint32_t)(prio->metrics.wait_sum[cls] / prio->started[cls]);
+  if(wait > prio->metrics.wait_max[cls]){
+    prio->metrics.wait_max[cls] = wait;
+  }
+  if(wait > prio->cfg.deadline[cls]){
+    prio->metrics.misses[cls]++;
+  }
+}
+
+/**
+  * @brief  Asking for the end of the connection once the head of the control queue has waited
+  *         cfg.deadline, AT commands are read only while not connected
+  */
+static void hc_08_prio_release(hc_08_prio_ST *prio, uint32_t now){
+  hc_08_prio_item_ST *item = prio->head[hc_08_prio_control];
+
+  if(item == NULL || prio->release == NULL || prio->released ||
+      now - item->tick < prio->cfg.deadline[hc_08_prio_control]){
+    return;
+  }
+  prio->released = 1;
+  prio->metrics.releases++;
+  prio->release(prio->ctx);
+}
+
+/**
+  * @brief  Time one byte takes on the UART at the baud rate and parity in hc_08->param
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @retval us
+  */
+uint32_t hc_08_prio_byte_time_us(hc_08_ST *hc_08){
+  uint32_t bits = hc_08->param.parity == hc_08_parity_bit_no_parity ? 10 : 11;
+
+  return (uint32_t)(bits * 1000000UL / strtoul(hc_08_baud_c[hc_08->param.baud], NULL, 10));
+}
+
+/**
+  * @brief  Initialization of the arbitration
+  * @param  *prio pointer to the arbitration structure
+  * @param  *hc_08 pointer to the HC-08 module structure. A tick source must be registered
+  *           with hc_08_reg_tick_cbfunc(...)
+  * @param  release called once while connected when an AT command has waited
+  *           cfg.deadline[hc_08_prio_control], may end the connection. NULL to wait for the
+  *           next disconnection
+  * @param  *ctx user pointer passed to release
+  */
+void hc_08_prio_init(hc_08_prio_ST *prio, hc_08_ST *hc_08, void (*release)(void *ctx), void *ctx){
+  memset(prio, 0, sizeof(*prio));
+  prio->hc_08 = hc_08;
+  prio->release = release;
+  prio->ctx = ctx;
+  prio->cfg.chunk = HC_08_PRIO_CHUNK;
+  prio->cfg.deadline[hc_08_prio_control] = HC_08_PRIO_DEADLINE_CONTROL;
+  prio->cfg.deadline[hc_08_prio_realtime] = HC_08_PRIO_DEADLINE_REALTIME;
+  prio->cfg.deadline[hc_08_prio_bulk] = HC_08_PRIO_DEADLINE_BULK;
+  prio->line_free = hc_08_get_tick(hc_08);
+}
+
+/**
+  * @brief  Queuing data. Never blocks; the data must stay valid until done is called
+  * @param  *prio pointer to the arbitration structure
+  * @param  *item item owned by the caller
+  * @param  cls hc_08_prio_realtime or hc_08_prio_bulk
+  * @param  *data data to send
+  * @param  size data size
+  * @param  done called when the last byte is written, NULL if not needed
+  * @param  *ctx user pointer, item->ctx
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error for the control class or no data
+  */
+hc_08_status hc_08_prio_data(hc_08_prio_ST *prio, hc_08_prio_item_ST *item, hc_08_prio_class cls,
+                             const char *data, uint16_t size,
+                             void (*done)(hc_08_ST *hc_08, hc_08_prio_item_ST *item), void *ctx){
+  if(cls == hc_08_prio_control || cls >= HC_08_PRIO_CLASSES || size == 0){
+    return hc_08_status_error;
+  }
+  item->cls = cls;
+  item->data = data;
+  item->size = size;
+  item->command = NULL;
+  item->done = done;
+  item->ctx = ctx;
+  hc_08_prio_queue(prio, item);
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Queuing an AT command. Never blocks; command is called when the module is not
+  *         connected and the UART is free, e.g. a function that calls hc_08_cmd_set_led(...)
+  * @param  *prio pointer to the arbitration structure
+  * @param  *item item owned by the caller
+  * @param  command function that sends the command
+  * @param  done called after the answer was read into hc_08->uart.buff_rx, NULL if not needed.
+  *           The buffer is cleared before command, so an older answer is never seen there
+  * @param  *ctx user pointer passed to command, item->ctx
+  */
+void hc_08_prio_command(hc_08_prio_ST *prio, hc_08_prio_item_ST *item, void (*command)(hc_08_ST *hc_08, void *ctx),
+                        void (*done)(hc_08_ST *hc_08, hc_08_prio_item_ST *item), void *ctx){
+  item->cls = hc_08_prio_control;
+  item->data = NULL;
+  item->size = 0;
+  item->command = command;
+  item->done = done;
+  item->ctx = ctx;
+  hc_08_prio_queue(prio, item);
+}
+
+/**
+  * @brief  Processing of the arbitration, called from the main loop. Once the previous write
+  *         has left the UART, runs one AT command (not connected), or writes one realtime
+  *         item or one chunk of bulk data (connected). Blocks only for an AT command.
+  *         While connected, an AT command past its deadline calls release
+  * @param  *prio pointer to the arbitration structure
+  */
+void hc_08_prio_process(hc_08_prio_ST *prio){
+  uint32_t now = hc_08_get_tick(prio->hc_08);
+  hc_08_prio_item_ST *item;
+  uint16_t size;
+
+  if(prio->hc_08->status_connect == hc_08_status_connected){
+    hc_08_prio_release(prio, now);
+  }else{
+    prio->released = 0;
+  }
+  if((int32_t)(now - prio->line_free) < 0){
+    return;
+  }
+
+  if(prio->hc_08->status_connect != hc_08_status_connected){
+    item = prio->head[hc_08_prio_control];
+    if(item == NULL){
+      return;
+    }
+    hc_08_prio_started(prio, item, now);
+    hc_08_clear_buff_rx(prio->hc_08);
+    item->command(prio->hc_08, item->ctx);
+    hc_08_read_answer(prio->hc_08);
+    prio->line_free = hc_08_get_tick(prio->hc_08);
+    hc_08_prio_finish(prio, hc_08_prio_control);
+    return;
+  }
+
+  // old bulk data shares the UART with realtime data, one chunk against cfg.chunk bytes
+  item = prio->head[hc_08_prio_realtime];
+  if(prio->head[hc_08_prio_bulk] != NULL &&
+      (item == NULL || (prio->credit <= 0 && now - prio->head[hc_08_prio_bulk]->tick >= prio->cfg.deadline[hc_08_prio_bulk]))){
+    if(item != NULL){
+      prio->credit = prio->cfg.chunk;
+      prio->metrics.aged++;
+    }
+    item = prio->head[hc_08_prio_bulk];
+  }
+  if(item == NULL){
+    return;
+  }
+
+  if(item->sent == 0){
+    hc_08_prio_started(prio, item, now);
+  }
+  size = item->size - item->sent;
+  if(item->cls == hc_08_prio_bulk && size > prio->cfg.chunk){
+    size = prio->cfg.chunk;
+  }
+  hc_08_uart_tx(prio->hc_08, (char *)item->data + item->sent, size);
+  item->sent += size;
+  prio->metrics.bytes[item->cls] += size;
+  if(item->cls == hc_08_prio_realtime){
+    prio->credit -= size;
+  }
+  prio->line_free = now + (uint32_t)(((uint64_t)size * hc_08_prio_byte_time_us(prio->hc_08) + 999) / 1000);
+  if(item->sent == item->size){
+    hc_08_prio_finish(prio, item->cls);
+  }
+}
+
+/**
+  * @brief  Number of items waiting in a class
+  * @param  *prio pointer to the arbitration structure
+  * @param  cls the class
+  * @retval items
+  */
+uint32_t hc_08_prio_pending(hc_08_prio_ST *prio, hc_08_prio_class cls){
+  uint32_t count = 0;
+
+  for(hc_08_prio_item_ST *item = prio->head[cls]; item != NULL; item = item->next){
+    count++;
+  }
+  return count;
+}
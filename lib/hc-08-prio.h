@@ -0,0 +1,90 @@
+#ifndef HC_08_PRIO_H
+#define HC_08_PRIO_H
+
+#include "hc-08.h"
+
+#define HC_08_PRIO_CHUNK              80     // bytes of bulk data per write, 4 packets of 20 bytes
+#define HC_08_PRIO_DEADLINE_CONTROL   500    // ms
+#define HC_08_PRIO_DEADLINE_REALTIME  100    // ms
+#define HC_08_PRIO_DEADLINE_BULK      2000   // ms, older bulk data takes turns with realtime data
+
+typedef enum{
+  hc_08_prio_control = 0,        // AT commands, only while not connected
+  hc_08_prio_realtime,           // data, only while connected, never split
+  hc_08_prio_bulk                // data, only while connected, sent in chunks
+}hc_08_prio_class;
+
+#define HC_08_PRIO_CLASSES  3
+
+struct hc_08_prio_item;
+
+/*
+ * Queued UART use, owned by the caller until done is called. A control item runs
+ * command (any hc_08_cmd_* call), reads the answer and calls done, which parses it from
+ * hc_08->uart.buff_rx (cleared before the command, so it holds only this answer); a data item is sent and done is called when its last byte is written.
+ */
+typedef struct hc_08_prio_item{
+  struct hc_08_prio_item *next;
+  hc_08_prio_class cls;
+  const char *data;
+  uint16_t size;
+  uint16_t sent;
+  void (*command)(hc_08_ST *hc_08, void *ctx);
+  void (*done)(hc_08_ST *hc_08, struct hc_08_prio_item *item);
+  void *ctx;
+  uint32_t tick;                 // queued at
+}hc_08_prio_item_ST;
+
+/*
+ * Priority arbitration of one UART between AT commands, realtime data and bulk data.
+ * The module reads AT commands only while not connected and sends everything it gets while
+ * connected, so control items wait for hc_08->status_connect to be not connected and data
+ * items for it to be connected. Bulk data is written in chunks of cfg.chunk bytes and the
+ * next write waits until the previous one has left the UART (baud rate and parity in
+ * hc_08->param), so an urgent item waits at most for one chunk. Bulk data older than
+ * cfg.deadline[bulk] would otherwise starve, so it gets one chunk for every cfg.chunk bytes
+ * of realtime data: the head of the realtime queue waits at most two chunk times, and
+ * bulk data keeps at least half of the UART. A control item that has waited cfg.deadline
+ * while connected calls the release callback, if given, once; it may end the connection
+ * (e.g. through the KEY pin) so the command can run. Otherwise cfg.deadline of each class
+ * is only measured (metrics.misses). Needs a tick source (hc_08_reg_tick_cbfunc).
+ */
+typedef struct{
+  hc_08_ST *hc_08;
+  void (*release)(void *ctx);
+  void *ctx;
+  hc_08_prio_item_ST *head[HC_08_PRIO_CLASSES];
+  hc_08_prio_item_ST *tail[HC_08_PRIO_CLASSES];
+  uint32_t line_free;            // tick at which the last write has left the UART
+  int32_t credit;                // realtime bytes before old bulk data gets its next chunk
+  uint32_t started[HC_08_PRIO_CLASSES];
+  uint8_t released;              // release was called for the waiting control items
+
+  struct{
+    uint16_t chunk;
+    uint32_t deadline[HC_08_PRIO_CLASSES];
+  }cfg;
+
+  struct{
+    uint32_t items[HC_08_PRIO_CLASSES];
+    uint32_t bytes[HC_08_PRIO_CLASSES];
+    uint32_t wait_max[HC_08_PRIO_CLASSES];   // ms from queued to the first byte
+    uint32_t wait_avg[HC_08_PRIO_CLASSES];   // ms
+    uint64_t wait_sum[HC_08_PRIO_CLASSES];
+    uint32_t misses[HC_08_PRIO_CLASSES];     // items that waited longer than cfg.deadline
+    uint32_t aged;                           // chunks of old bulk data sent before realtime data
+    uint32_t releases;                       // release calls for control items past their deadline
+  }metrics;
+}hc_08_prio_ST;
+
+void hc_08_prio_init(hc_08_prio_ST *prio, hc_08_ST *hc_08, void (*release)(void *ctx), void *ctx);
+hc_08_status hc_08_prio_data(hc_08_prio_ST *prio, hc_08_prio_item_ST *item, hc_08_prio_class cls,
+                             const char *data, uint16_t size,
+                             void (*done)(hc_08_ST *hc_08, hc_08_prio_item_ST *item), void *ctx);
+void hc_08_prio_command(hc_08_prio_ST *prio, hc_08_prio_item_ST *item, void (*command)(hc_08_ST *hc_08, void *ctx),
+                        void (*done)(hc_08_ST *hc_08, hc_08_prio_item_ST *item), void *ctx);
+void hc_08_prio_process(hc_08_prio_ST *prio);
+uint32_t hc_08_prio_pending(hc_08_prio_ST *prio, hc_08_prio_class cls);
+uint32_t hc_08_prio_byte_time_us(hc_08_ST *hc_08);
+
+#endif /* HC_08_PRIO_H */
@@ -0,0 +1,197 @@
+#include "hc-08-profile.h"
+#include <string.h>
+
+/*
+ * aint is in 0.625 ms units, cint in 1.25 ms units and ctout in 10 ms units
+ */
+static const hc_08_profile_ST hc_08_profile_table[] = {
+  [hc_08_profile_low_latency] = {
+    .aint = 32, .cint_min = 6, .cint_max = 12, .ctout = 100,
+    .rfpm = hc_08_rfpm_4dBm, .mode = hc_08_mode_full
+  },
+  [hc_08_profile_throughput] = {
+    .aint = 160, .cint_min = 6, .cint_max = 8, .ctout = 200,
+    .rfpm = hc_08_rfpm_4dBm, .mode = hc_08_mode_full
+  },
+  [hc_08_profile_balanced] = {
+    .aint = 320, .cint_min = 24, .cint_max = 40, .ctout = 300,
+    .rfpm = hc_08_rfpm_0dBm, .mode = hc_08_mode_level_1
+  },
+  [hc_08_profile_battery] = {
+    .aint = 1600, .cint_min = 80, .cint_max = 160, .ctout = 600,
+    .rfpm = hc_08_rfpm_0dBm, .mode = hc_08_mode_level_2
+  }
+};
+
+/**
+  * @brief  Sending a set command that was already written to the transfer buffer
+  *         and checking the answer of the module
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  status result of the hc_08_cmd_set_... function, hc_08_status_error means nothing was sent
+  */
+static hc_08_status hc_08_profile_check(hc_08_ST *hc_08, hc_08_status status){
+  if(status != hc_08_status_ok){
+    return status;
+  }
+  hc_08_read_answer(hc_08);
+  return hc_08_check_set(hc_08);
+}
+
+/**
+  * @brief  Writing all values of a profile to the module. Stops at the first rejected value
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  *profile pointer to the profile
+  */
+static hc_08_status hc_08_profile_write(hc_08_ST *hc_08, const hc_08_profile_ST *profile){
+  if(hc_08_profile_check(hc_08, hc_08_cmd_set_aint(hc_08, profile->aint)) != hc_08_status_ok){
+    return hc_08_status_error;
+  }
+  if(hc_08_profile_check(hc_08, hc_08_cmd_set_cint_min_max(hc_08, profile->cint_min, profile->cint_max)) != hc_08_status_ok){
+    return hc_08_status_error;
+  }
+  if(hc_08_profile_check(hc_08, hc_08_cmd_set_ctout(hc_08, profile->ctout)) != hc_08_status_ok){
+    return hc_08_status_error;
+  }
+  hc_08_cmd_set_rf_power(hc_08, profile->rfpm);
+  if(hc_08_profile_check(hc_08, hc_08_status_ok) != hc_08_status_ok){
+    return hc_08_status_error;
+  }
+  hc_08_cmd_set_mode(hc_08, profile->mode);
+  if(hc_08_profile_check(hc_08, hc_08_status_ok) != hc_08_status_ok){
+    return hc_08_status_error;
+  }
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Returns one of the predefined profiles
+  * @param  profile Takes one of the following values:
+  *           hc_08_profile_low_latency,
+  *           hc_08_profile_throughput,
+  *           hc_08_profile_balanced,
+  *           hc_08_profile_battery
+  * @retval pointer to the profile values, NULL for an unknown profile
+  */
+const hc_08_profile_ST *hc_08_profile_get(hc_08_profile profile){
+  if((unsigned int)profile >= HC_08_PROFILE_SIZE){
+    return NULL;
+  }
+  return &hc_08_profile_table[profile];
+}
+
+/**
+  * @brief  Checking that all values of a profile are accepted by the module and consistent
+  *         with each other: cint_min <= cint_max and the connection timeout is longer than
+  *         two of the longest connection intervals
+  * @param  *profile pointer to the profile
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error
+  */
+hc_08_status hc_08_profile_validate(const hc_08_profile_ST *profile){
+  if(profile->aint < HC_08_AINT_MIN || profile->aint > HC_08_AINT_MAX ||
+      profile->cint_min < HC_08_CINT_MIN || profile->cint_max > HC_08_CINT_MAX ||
+      profile->cint_min > profile->cint_max ||
+      profile->ctout < HC_08_CTOUT_MIN || profile->ctout > HC_08_CTOUT_MAX ||
+      (uint32_t)profile->ctout * 4 <= profile->cint_max ||
+      (unsigned int)profile->rfpm >= HC_08_RFPM_SIZE ||
+      (unsigned int)profile->mode >= HC_08_MODE_SIZE){
+    return hc_08_status_error;
+  }
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Reading the current profile values back from the module. The values are also
+  *         recorded in hc_08->param
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  *profile pointer to the profile to fill
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if one of the answers could not be parsed
+  */
+hc_08_status hc_08_profile_read(hc_08_ST *hc_08, hc_08_profile_ST *profile){
+  hc_08_cmd_ask_aint(hc_08);
+  hc_08_read_answer(hc_08);
+  if(hc_08_parse_aint(hc_08, hc_08->uart.rx_size) != hc_08_status_ok){
+    return hc_08_status_error;
+  }
+  hc_08_cmd_ask_cint_min_max(hc_08);
+  hc_08_read_answer(hc_08);
+  if(hc_08_parse_cint(hc_08, hc_08->uart.rx_size) != hc_08_status_ok){
+    return hc_08_status_error;
+  }
+  hc_08_cmd_ask_ctout(hc_08);
+  hc_08_read_answer(hc_08);
+  if(hc_08_parse_ctout(hc_08, hc_08->uart.rx_size) != hc_08_status_ok){
+    return hc_08_status_error;
+  }
+  hc_08_cmd_ask_rf_power(hc_08);
+  hc_08_read_answer(hc_08);
+  if(hc_08_parse_rfpm(hc_08, hc_08->uart.rx_size) != hc_08_status_ok){
+    return hc_08_status_error;
+  }
+  hc_08_cmd_ask_mode(hc_08);
+  hc_08_read_answer(hc_08);
+  if(hc_08_parse_mode(hc_08, hc_08->uart.rx_size) != hc_08_status_ok){
+    return hc_08_status_error;
+  }
+
+  profile->aint = hc_08->param.aint;
+  profile->cint_min = hc_08->param.cint_min;
+  profile->cint_max = hc_08->param.cint_max;
+  profile->ctout = hc_08->param.ctout;
+  profile->rfpm = hc_08->param.rfpm;
+  profile->mode = hc_08->param.mode;
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Applying a profile as one group. Nothing is sent if the profile is not valid.
+  *         If the module rejects one of the values, the values read before the change are
+  *         written back so the module is not left with a mix of two profiles
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  *profile pointer to the profile (hc_08_profile_get(...) or a custom one)
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error
+  */
+hc_08_status hc_08_profile_apply(hc_08_ST *hc_08, const hc_08_profile_ST *profile){
+  hc_08_profile_ST previous;
+
+  if(hc_08_profile_validate(profile) != hc_08_status_ok){
+    return hc_08_status_error;
+  }
+  if(hc_08_profile_read(hc_08, &previous) != hc_08_status_ok){
+    return hc_08_status_error;
+  }
+  if(hc_08_profile_write(hc_08, profile) != hc_08_status_ok){
+    if(hc_08_profile_validate(&previous) == hc_08_status_ok){
+      hc_08_profile_write(hc_08, &previous);
+    }
+    return hc_08_status_error;
+  }
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Reading the values back from the module and comparing them with a profile
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  *profile pointer to the expected profile
+  * @retval hc_08_status:
+  *             hc_08_status_ok if every value matches
+  *             hc_08_status_error
+  */
+hc_08_status hc_08_profile_verify(hc_08_ST *hc_08, const hc_08_profile_ST *profile){
+  hc_08_profile_ST actual;
+
+  if(hc_08_profile_read(hc_08, &actual) != hc_08_status_ok){
+    return hc_08_status_error;
+  }
+  if(actual.aint != profile->aint || actual.cint_min != profile->cint_min ||
+      actual.cint_max != profile->cint_max || actual.ctout != profile->ctout ||
+      actual.rfpm != profile->rfpm || actual.mode != profile->mode){
+    return hc_08_status_error;
+  }
+  return hc_08_status_ok;
+}
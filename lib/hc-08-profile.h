@@ -0,0 +1,36 @@
+#ifndef HC_08_PROFILE_H
+#define HC_08_PROFILE_H
+
+#include "hc-08.h"
+
+typedef enum{
+  hc_08_profile_low_latency,
+  hc_08_profile_throughput,
+  hc_08_profile_balanced,
+  hc_08_profile_battery
+}hc_08_profile;
+
+static const char * const hc_08_profile_c[] = {
+  [hc_08_profile_low_latency] = "low latency",
+  [hc_08_profile_throughput] = "max throughput",
+  [hc_08_profile_balanced] = "balanced",
+  [hc_08_profile_battery] = "battery"
+};
+#define HC_08_PROFILE_SIZE 0x04
+
+typedef struct{
+  uint16_t aint;
+  uint16_t cint_min;
+  uint16_t cint_max;
+  uint16_t ctout;
+  hc_08_rfpm rfpm;
+  hc_08_mode mode;
+}hc_08_profile_ST;
+
+const hc_08_profile_ST *hc_08_profile_get(hc_08_profile profile);
+hc_08_status hc_08_profile_validate(const hc_08_profile_ST *profile);
+hc_08_status hc_08_profile_read(hc_08_ST *hc_08, hc_08_profile_ST *profile);
+hc_08_status hc_08_profile_apply(hc_08_ST *hc_08, const hc_08_profile_ST *profile);
+hc_08_status hc_08_profile_verify(hc_08_ST *hc_08, const hc_08_profile_ST *profile);
+
+#endif /* HC_08_PROFILE_H */
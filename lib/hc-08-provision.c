@@ -0,0 +1,183 @@
+#include "hc-08-provision.h"
+#include <string.h>
+
+/**
+  * @brief  Sending a set command that was already written to the transfer buffer
+  *         and checking the answer of the module
+  * @param  *hc_08 pointer to the HC-08 module structure
+  */
+static hc_08_status hc_08_provision_check(hc_08_ST *hc_08){
+  hc_08_read_answer(hc_08);
+  return hc_08_check_set(hc_08);
+}
+
+/**
+  * @brief  Sending a query that was already written to the transfer buffer and parsing the answer
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  parse parser of the answer
+  */
+static hc_08_status hc_08_provision_ask(hc_08_ST *hc_08, hc_08_status (*parse)(hc_08_ST *hc_08, uint16_t size)){
+  hc_08_read_answer(hc_08);
+  return parse(hc_08, hc_08->uart.rx_size);
+}
+
+/**
+  * @brief  Recording the step that failed
+  * @retval hc_08_status_error
+  */
+static hc_08_status hc_08_provision_fail(hc_08_provision_step *failed, hc_08_provision_step step){
+  if(failed != NULL){
+    *failed = step;
+  }
+  return hc_08_status_error;
+}
+
+/**
+  * @brief  Length of the name of a unit
+  * @retval 0 if the name is not terminated within the array
+  */
+static size_t hc_08_provision_name_length(const hc_08_provision_ST *unit){
+  const char *end = memchr(unit->name, '\0', sizeof(unit->name));
+
+  return end == NULL ? 0 : (size_t)(end - unit->name);
+}
+
+/**
+  * @brief  Checking the settings of a unit before anything is sent: the name is 1 to
+  *         HC_08_MAX_NAME_LENGHT printable characters without ',' and the enums are in range
+  * @param  *unit pointer to the unit settings
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error
+  */
+hc_08_status hc_08_provision_validate(const hc_08_provision_ST *unit){
+  size_t length = hc_08_provision_name_length(unit);
+
+  if(length == 0 || length > HC_08_MAX_NAME_LENGHT ||
+      (unsigned int)unit->role > hc_08_role_slave ||
+      (unsigned int)unit->baud >= HC_08_BAUD_SIZE ||
+      (unsigned int)unit->parity >= HC_08_PARITY_SIZE){
+    return hc_08_status_error;
+  }
+  for(size_t i = 0; i < length; i++){
+    if(unit->name[i] <= ' ' || unit->name[i] > '~' || unit->name[i] == ','){
+      return hc_08_status_error;
+    }
+  }
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Writing the settings of a unit. The baud rate is written last: on a real module
+  *         the host UART has to follow it (e.g. hc_08_posix_configure(...)) before
+  *         hc_08_provision_verify(...). Stops at the first rejected value
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  *unit pointer to the unit settings
+  * @param  *failed the step that was rejected, may be NULL
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error
+  */
+hc_08_status hc_08_provision_apply(hc_08_ST *hc_08, const hc_08_provision_ST *unit, hc_08_provision_step *failed){
+  hc_08_provision_fail(failed, hc_08_provision_step_none);
+  if(hc_08_provision_validate(unit) != hc_08_status_ok){
+    return hc_08_status_error;
+  }
+
+  hc_08_cmd_set_role(hc_08, unit->role);
+  if(hc_08_provision_check(hc_08) != hc_08_status_ok){
+    return hc_08_provision_fail(failed, hc_08_provision_step_role);
+  }
+  if(hc_08_cmd_set_name(hc_08, (char *)unit->name) != hc_08_status_ok ||
+      hc_08_provision_check(hc_08) != hc_08_status_ok){
+    return hc_08_provision_fail(failed, hc_08_provision_step_name);
+  }
+  hc_08_cmd_set_address(hc_08, (uint8_t *)unit->addres);
+  if(hc_08_provision_check(hc_08) != hc_08_status_ok){
+    return hc_08_provision_fail(failed, hc_08_provision_step_address);
+  }
+  hc_08_cmd_set_luuid(hc_08, unit->luuid);
+  if(hc_08_provision_check(hc_08) != hc_08_status_ok){
+    return hc_08_provision_fail(failed, hc_08_provision_step_luuid);
+  }
+  hc_08_cmd_set_suuid(hc_08, unit->suuid);
+  if(hc_08_provision_check(hc_08) != hc_08_status_ok){
+    return hc_08_provision_fail(failed, hc_08_provision_step_suuid);
+  }
+  hc_08_cmd_set_tuuid(hc_08, unit->tuuid);
+  if(hc_08_provision_check(hc_08) != hc_08_status_ok){
+    return hc_08_provision_fail(failed, hc_08_provision_step_tuuid);
+  }
+  hc_08_cmd_set_uart_baud_parity(hc_08, unit->baud, unit->parity);
+  if(hc_08_provision_check(hc_08) != hc_08_status_ok){
+    return hc_08_provision_fail(failed, hc_08_provision_step_baud);
+  }
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Reading the settings back through the parsers and comparing them with the unit.
+  *         The values read are also recorded in hc_08->param
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  *unit pointer to the expected unit settings
+  * @param  *failed the first step whose value could not be read or differs, may be NULL
+  * @retval hc_08_status:
+  *             hc_08_status_ok if every value matches
+  *             hc_08_status_error
+  */
+hc_08_status hc_08_provision_verify(hc_08_ST *hc_08, const hc_08_provision_ST *unit, hc_08_provision_step *failed){
+  size_t length = hc_08_provision_name_length(unit);
+
+  hc_08_provision_fail(failed, hc_08_provision_step_none);
+
+  hc_08_cmd_ask_role(hc_08);
+  if(hc_08_provision_ask(hc_08, hc_08_parse_role) != hc_08_status_ok || hc_08->param.role != unit->role){
+    return hc_08_provision_fail(failed, hc_08_provision_step_role);
+  }
+  hc_08_cmd_ask_name(hc_08);
+  if(hc_08_provision_ask(hc_08, hc_08_parse_name) != hc_08_status_ok ||
+      hc_08->param.name_lenght != length || memcmp(hc_08->param.name, unit->name, length) != 0){
+    return hc_08_provision_fail(failed, hc_08_provision_step_name);
+  }
+  hc_08_cmd_ask_address(hc_08);
+  if(hc_08_provision_ask(hc_08, hc_08_parse_address) != hc_08_status_ok ||
+      memcmp(hc_08->param.addres, unit->addres, sizeof(unit->addres)) != 0){
+    return hc_08_provision_fail(failed, hc_08_provision_step_address);
+  }
+  hc_08_cmd_ask_luuid(hc_08);
+  if(hc_08_provision_ask(hc_08, hc_08_parse_luuid) != hc_08_status_ok || hc_08->param.luuid != unit->luuid){
+    return hc_08_provision_fail(failed, hc_08_provision_step_luuid);
+  }
+  hc_08_cmd_ask_suuid(hc_08);
+  if(hc_08_provision_ask(hc_08, hc_08_parse_suuid) != hc_08_status_ok || hc_08->param.suuid != unit->suuid){
+    return hc_08_provision_fail(failed, hc_08_provision_step_suuid);
+  }
+  hc_08_cmd_ask_tuuid(hc_08);
+  if(hc_08_provision_ask(hc_08, hc_08_parse_tuuid) != hc_08_status_ok || hc_08->param.tuuid != unit->tuuid){
+    return hc_08_provision_fail(failed, hc_08_provision_step_tuuid);
+  }
+  hc_08_cmd_ask_uart_baud_parity(hc_08);
+  if(hc_08_provision_ask(hc_08, hc_08_parse_baud_and_parity) != hc_08_status_ok ||
+      hc_08->param.baud != unit->baud || hc_08->param.parity != unit->parity){
+    return hc_08_provision_fail(failed, hc_08_provision_step_baud);
+  }
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Reading an address written as 12 hex digits, optionally with ',' ':' or '-'
+  *         between the bytes ("3CE4B089DC03", "3C:E4:B0:89:DC:03")
+  * @param  *text NUL terminated text
+  * @param  *addres array of 6 bytes for the result
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error
+  */
+hc_08_status hc_08_provision_parse_addres(const char *text, uint8_t *addres){
+  size_t length = strlen(text);
+
+  if(length > HC_08_ADDRES_LENGHT + 5 || hc_08_decode_addres(text, (uint16_t)length, addres) != hc_08_decode_ok){
+    return hc_08_status_error;
+  }
+  return hc_08_status_ok;
+}
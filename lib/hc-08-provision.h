@@ -0,0 +1,48 @@
+#ifndef HC_08_PROVISION_H
+#define HC_08_PROVISION_H
+
+#include "hc-08.h"
+
+typedef enum{
+  hc_08_provision_step_none,
+  hc_08_provision_step_role,
+  hc_08_provision_step_name,
+  hc_08_provision_step_address,
+  hc_08_provision_step_luuid,
+  hc_08_provision_step_suuid,
+  hc_08_provision_step_tuuid,
+  hc_08_provision_step_baud
+}hc_08_provision_step;
+
+static const char * const hc_08_provision_step_c[] = {
+  [hc_08_provision_step_none] = "none",
+  [hc_08_provision_step_role] = "role",
+  [hc_08_provision_step_name] = "name",
+  [hc_08_provision_step_address] = "address",
+  [hc_08_provision_step_luuid] = "luuid",
+  [hc_08_provision_step_suuid] = "suuid",
+  [hc_08_provision_step_tuuid] = "tuuid",
+  [hc_08_provision_step_baud] = "baud"
+};
+#define HC_08_PROVISION_STEP_SIZE 0x08
+
+/*
+ * Settings written to one unit on the production line
+ */
+typedef struct{
+  char name[HC_08_MAX_NAME_LENGHT + 1];
+  uint8_t addres[6];
+  hc_08_role role;
+  hc_08_baud baud;
+  hc_08_parity_bit parity;
+  uint16_t luuid;
+  uint16_t suuid;
+  uint16_t tuuid;
+}hc_08_provision_ST;
+
+hc_08_status hc_08_provision_validate(const hc_08_provision_ST *unit);
+hc_08_status hc_08_provision_apply(hc_08_ST *hc_08, const hc_08_provision_ST *unit, hc_08_provision_step *failed);
+hc_08_status hc_08_provision_verify(hc_08_ST *hc_08, const hc_08_provision_ST *unit, hc_08_provision_step *failed);
+hc_08_status hc_08_provision_parse_addres(const char *text, uint8_t *addres);
+
+#endif /* HC_08_PROVISION_H */
@@ -0,0 +1,113 @@
+#include "hc-08-ready.h"
+#include <string.h>
+
+/**
+  * @brief  Recording the end of a boot
+  * @param  *ready pointer to the probe structure
+  * @param  now current tick
+  */
+static void hc_08_ready_done(hc_08_ready_ST *ready, uint32_t now){
+  uint32_t time = now - ready->start_tick;
+
+  ready->state = hc_08_ready_state_ready;
+  ready->metrics.boot_time = time;
+  ready->metrics.history[ready->metrics.boots % HC_08_READY_HISTORY] = time;
+  if(ready->metrics.boots == 0 || time < ready->metrics.boot_time_min){
+    ready->metrics.boot_time_min = time;
+  }
+  if(time > ready->metrics.boot_time_max){
+    ready->metrics.boot_time_max = time;
+  }
+  if(ready->metrics.boots == 0){
+    ready->metrics.boot_time_avg = time;
+  }else{
+    ready->metrics.boot_time_avg = (ready->metrics.boot_time_avg * 3 + time) / 4;
+  }
+  ready->metrics.boots++;
+}
+
+/**
+  * @brief  Initialization of the readiness probe
+  * @param  *ready pointer to the probe structure
+  * @param  *hc_08 pointer to the HC-08 module structure. A tick source must be registered
+  *           with hc_08_reg_tick_cbfunc(...)
+  */
+void hc_08_ready_init(hc_08_ready_ST *ready, hc_08_ST *hc_08){
+  memset(ready, 0, sizeof(*ready));
+  ready->hc_08 = hc_08;
+  ready->cfg.interval_min = HC_08_READY_INTERVAL_MIN;
+  ready->cfg.interval_max = HC_08_READY_INTERVAL_MAX;
+  ready->cfg.timeout = HC_08_READY_TIMEOUT;
+  ready->state = hc_08_ready_state_ready;
+}
+
+/**
+  * @brief  Starting to probe a boot. Call it when the supply is switched on or after the
+  *         OK of AT+RESET was read
+  * @param  *ready pointer to the probe structure
+  */
+void hc_08_ready_start(hc_08_ready_ST *ready){
+  hc_08_ST *hc_08 = ready->hc_08;
+
+  ready->state = hc_08_ready_state_probing;
+  ready->start_tick = hc_08_get_tick(hc_08);
+  ready->probe_tick = ready->start_tick + ready->metrics.boot_time_avg / 2;
+  ready->interval = ready->cfg.interval_min;
+  ready->metrics.probes = 0;
+  ready->metrics.boot_output = 0;
+  hc_08->uart.rx_size = 0;
+  ready->last_rx_bytes = hc_08->stats.rx_bytes;
+}
+
+/**
+  * @brief  Processing of the probe, called from the init sequence or the main loop
+  * @param  *ready pointer to the probe structure
+  * @retval hc_08_ready_state:
+  *             hc_08_ready_state_probing, call again later
+  *             hc_08_ready_state_ready, the module answered OK (metrics.boot_time is updated)
+  *             hc_08_ready_state_timeout, no OK within cfg.timeout
+  */
+hc_08_ready_state hc_08_ready_process(hc_08_ready_ST *ready){
+  hc_08_ST *hc_08 = ready->hc_08;
+  uint32_t now;
+
+  if(ready->state != hc_08_ready_state_probing){
+    return ready->state;
+  }
+
+  if(hc_08->uart.rx_ctx != NULL && ready->metrics.probes > 0){
+    hc_08_read_answer(hc_08);
+  }
+  now = hc_08_get_tick(hc_08);
+  if(hc_08->stats.rx_bytes != ready->last_rx_bytes){
+    ready->last_rx_bytes = hc_08->stats.rx_bytes;
+    if(hc_08_check_set(hc_08) == hc_08_status_ok){
+      hc_08_ready_done(ready, now);
+      return ready->state;
+    }
+    // alive but not ready yet: ask again right away with short intervals
+    ready->metrics.boot_output++;
+    hc_08->uart.rx_size = 0;
+    ready->probe_tick = now;
+    ready->interval = ready->cfg.interval_min;
+  }
+
+  if(now - ready->start_tick >= ready->cfg.timeout){
+    ready->state = hc_08_ready_state_timeout;
+    ready->metrics.timeouts++;
+    return ready->state;
+  }
+  if((int32_t)(now - ready->probe_tick) >= 0){
+    hc_08_cmd_at(hc_08);
+    ready->metrics.probes++;
+    ready->probe_tick = now + ready->interval;
+    // short intervals around the usual boot time, slower once it has passed
+    if(now - ready->start_tick >= ready->metrics.boot_time_avg + ready->metrics.boot_time_avg / 2){
+      ready->interval += ready->interval / 2;
+      if(ready->interval > ready->cfg.interval_max){
+        ready->interval = ready->cfg.interval_max;
+      }
+    }
+  }
+  return ready->state;
+}
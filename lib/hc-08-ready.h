@@ -0,0 +1,59 @@
+#ifndef HC_08_READY_H
+#define HC_08_READY_H
+
+#include "hc-08.h"
+
+#define HC_08_READY_INTERVAL_MIN    10     // ms between the first probes
+#define HC_08_READY_INTERVAL_MAX    100    // ms, probes slow down to this interval
+#define HC_08_READY_TIMEOUT         3000   // ms until the boot is declared failed
+#define HC_08_READY_HISTORY         8      // boot times kept
+
+typedef enum{
+  hc_08_ready_state_probing,
+  hc_08_ready_state_ready,
+  hc_08_ready_state_timeout
+}hc_08_ready_state;
+
+/*
+ * Boot readiness probe. Started right after power-up or after the OK of AT+RESET, it sends
+ * AT at growing intervals from hc_08_ready_process(...) and never waits itself, so it can
+ * run between other init steps. Answers are taken from the receive function when it takes a
+ * context (it should return at once, or within the probe interval) or from
+ * hc_08_rx_complete(...) of an interrupt/DMA reception. Any bytes that are not OK (boot
+ * output, a garbled answer) show the module is alive and trigger the next probe at once.
+ * Probing starts at half the average of the previous boot times and keeps the shortest
+ * interval until 1.5 times that average has passed.
+ */
+typedef struct{
+  hc_08_ST *hc_08;
+
+  struct{
+    uint32_t interval_min;
+    uint32_t interval_max;
+    uint32_t timeout;
+  }cfg;
+
+  hc_08_ready_state state;
+  uint32_t start_tick;
+  uint32_t probe_tick;
+  uint32_t interval;
+  uint32_t last_rx_bytes;
+
+  struct{
+    uint32_t boots;
+    uint32_t timeouts;
+    uint32_t probes;           // AT commands sent during the last boot
+    uint32_t boot_output;      // non-OK answers seen during the last boot
+    uint32_t boot_time;        // ms, last boot
+    uint32_t boot_time_min;
+    uint32_t boot_time_max;
+    uint32_t boot_time_avg;
+    uint32_t history[HC_08_READY_HISTORY];
+  }metrics;
+}hc_08_ready_ST;
+
+void hc_08_ready_init(hc_08_ready_ST *ready, hc_08_ST *hc_08);
+void hc_08_ready_start(hc_08_ready_ST *ready);
+hc_08_ready_state hc_08_ready_process(hc_08_ready_ST *ready);
+
+#endif /* HC_08_READY_H */
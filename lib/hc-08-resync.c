@@ -0,0 +1,200 @@
+#include "hc-08-resync.h"
+#include <string.h>
+
+// baud rates tried after the current one, the common settings first
+static const hc_08_baud hc_08_resync_baud_order[HC_08_BAUD_SIZE] = {
+  hc_08_baud_9600bps, hc_08_baud_115200bps, hc_08_baud_57600bps, hc_08_baud_38400bps,
+  hc_08_baud_19200bps, hc_08_baud_4800bps, hc_08_baud_2400bps, hc_08_baud_1200bps
+};
+
+/**
+  * @brief  Reading and dropping whatever the module still sends, until a read comes back
+  *         empty or cfg.flush_reads reads were done
+  * @param  *resync pointer to the resync structure
+  */
+static void hc_08_resync_flush(hc_08_resync_ST *resync){
+  for(uint8_t i = 0; i < resync->cfg.flush_reads; i++){
+    hc_08_clear_buff_rx(resync->hc_08);
+    hc_08_read_answer(resync->hc_08);
+    if(hc_08_rx_received(resync->hc_08) == 0){
+      break;
+    }
+  }
+  hc_08_clear_buff_rx(resync->hc_08);
+}
+
+/**
+  * @brief  Sending AT until it is answered with OK
+  * @param  *resync pointer to the resync structure
+  * @param  probes number of attempts
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error
+  */
+static hc_08_status hc_08_resync_probe(hc_08_resync_ST *resync, uint8_t probes){
+  hc_08_ST *hc_08 = resync->hc_08;
+
+  for(uint8_t i = 0; i < probes; i++){
+    resync->metrics.probes++;
+    hc_08_cmd_at(hc_08);
+    hc_08_read_answer(hc_08);
+    if(hc_08_resync_valid(hc_08) == hc_08_status_ok && hc_08_check_set(hc_08) == hc_08_status_ok){
+      return hc_08_status_ok;
+    }
+    hc_08_resync_flush(resync);
+  }
+  return hc_08_status_error;
+}
+
+/**
+  * @brief  Trying the host UART at one setting
+  * @param  *resync pointer to the resync structure
+  * @retval hc_08_status:
+  *             hc_08_status_ok if AT was answered, the setting is kept in hc_08->param
+  *             hc_08_status_error
+  */
+static hc_08_status hc_08_resync_try_line(hc_08_resync_ST *resync, hc_08_baud baud, hc_08_parity_bit parity){
+  if(resync->set_line(resync->ctx, baud, parity) != hc_08_status_ok){
+    return hc_08_status_error;
+  }
+  hc_08_resync_flush(resync);
+  if(hc_08_resync_probe(resync, 1) != hc_08_status_ok){
+    return hc_08_status_error;
+  }
+  resync->hc_08->param.baud = baud;
+  resync->hc_08->param.parity = parity;
+  resync->hc_08->param_valid |= 1UL << hc_08_field_baud;
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Initialization of the resync
+  * @param  *resync pointer to the resync structure
+  * @param  *hc_08 pointer to the HC-08 module structure. hc_08->param.baud and parity must
+  *           hold the settings the host UART currently uses
+  * @param  set_line changes the baud rate and parity of the host UART, NULL if it cannot
+  *           (the recovery then stops after the flush and the AT probes)
+  * @param  *ctx user pointer passed to set_line
+  */
+void hc_08_resync_init(hc_08_resync_ST *resync, hc_08_ST *hc_08,
+                       hc_08_status (*set_line)(void *ctx, hc_08_baud baud, hc_08_parity_bit parity), void *ctx){
+  memset(resync, 0, sizeof(*resync));
+  resync->hc_08 = hc_08;
+  resync->set_line = set_line;
+  resync->ctx = ctx;
+  resync->cfg.flush_reads = HC_08_RESYNC_FLUSH_READS;
+  resync->cfg.probes = HC_08_RESYNC_PROBES;
+}
+
+/**
+  * @brief  Checking that the received answer is text and fits the command in buff_tx. When the
+  *         size of the answer is not known (rx_size is the whole buffer, as the receive function
+  *         of hc_08_reg_uart_cbfunc reports it) the answer ends at the first NUL
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if the answer is empty, has other bytes than printable
+  *             characters and line ends, or a command that is answered with OK got neither
+  *             OK nor ERROR
+  */
+hc_08_status hc_08_resync_valid(hc_08_ST *hc_08){
+  uint16_t size = hc_08->uart.rx_size < hc_08->uart.rx_capacity ? hc_08->uart.rx_size : hc_08_rx_received(hc_08);
+  hc_08_view cmd = {hc_08->uart.buff_tx, hc_08->uart.tx_capacity};
+  const char *end = memchr(cmd.data, '\0', cmd.size);
+  hc_08_view rx;
+
+  if(size == 0){
+    return hc_08_status_error;
+  }
+  if(end != NULL){
+    cmd.size = end - cmd.data;
+  }
+  for(uint16_t i = 0; i < size; i++){
+    unsigned char c = (unsigned char)hc_08->uart.buff_rx[i];
+
+    if((c < 0x20 || c > 0x7E) && c != '\r' && c != '\n'){
+      return hc_08_status_error;
+    }
+  }
+
+  // commands that only change something (AT, AT+RESET, AT+NAME=x, ...) are answered with OK
+  if(memchr(cmd.data, '?', cmd.size) != NULL || hc_08_view_search(&cmd, HC_08_COMMAND_RX) == cmd.data ||
+      hc_08_view_search(&cmd, HC_08_COMMAND_VERSION) == cmd.data){
+    return hc_08_status_ok;
+  }
+  rx = hc_08_view_rx(hc_08, size);
+  if(hc_08_view_search(&rx, HC_08_TEXT_OK) == NULL && hc_08_view_search(&rx, "ERROR") == NULL){
+    return hc_08_status_error;
+  }
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Checking the answer just read and recovering if the framing was lost. The command
+  *         must then be sent again
+  * @param  *resync pointer to the resync structure
+  * @retval hc_08_resync_result
+  */
+hc_08_resync_result hc_08_resync_check(hc_08_resync_ST *resync){
+  resync->metrics.checks++;
+  if(hc_08_resync_valid(resync->hc_08) == hc_08_status_ok){
+    return hc_08_resync_result_ok;
+  }
+  resync->metrics.desyncs++;
+  return hc_08_resync_recover(resync);
+}
+
+/**
+  * @brief  Recovering the framing: flushing the line, probing AT and, if the module still
+  *         does not answer, trying every baud rate and parity on the host side
+  * @param  *resync pointer to the resync structure
+  * @retval hc_08_resync_result
+  */
+hc_08_resync_result hc_08_resync_recover(hc_08_resync_ST *resync){
+  hc_08_ST *hc_08 = resync->hc_08;
+  uint32_t start = hc_08_get_tick(hc_08);
+  hc_08_baud baud = hc_08->param.baud;
+  hc_08_parity_bit parity = hc_08->param.parity;
+  hc_08_resync_result result = hc_08_resync_result_failed;
+
+  hc_08_resync_flush(resync);
+  if(hc_08_resync_probe(resync, resync->cfg.probes) == hc_08_status_ok){
+    result = hc_08_resync_result_flushed;
+  }else if(resync->set_line != NULL){
+    // the current baud rate with the other parities first, then the other baud rates
+    for(uint8_t i = 0; i <= HC_08_BAUD_SIZE && result == hc_08_resync_result_failed; i++){
+      hc_08_baud candidate = i == 0 ? baud : hc_08_resync_baud_order[i - 1];
+
+      if(i > 0 && candidate == baud){
+        continue;
+      }
+      for(uint8_t p = 0; p < HC_08_PARITY_SIZE; p++){
+        if(i == 0 && (hc_08_parity_bit)p == parity){
+          continue;
+        }
+        if(hc_08_resync_try_line(resync, candidate, (hc_08_parity_bit)p) == hc_08_status_ok){
+          result = hc_08_resync_result_baud;
+          break;
+        }
+      }
+    }
+    if(result == hc_08_resync_result_failed){
+      resync->set_line(resync->ctx, baud, parity);
+    }
+  }
+
+  resync->metrics.recovery = hc_08_get_tick(hc_08) - start;
+  if(result == hc_08_resync_result_failed){
+    resync->metrics.failed++;
+    return result;
+  }
+  if(resync->metrics.recovery > resync->metrics.recovery_max){
+    resync->metrics.recovery_max = resync->metrics.recovery;
+  }
+  if(result == hc_08_resync_result_flushed){
+    resync->metrics.flushed++;
+  }else{
+    resync->metrics.baud++;
+  }
+  return result;
+}
@@ -0,0 +1,53 @@
+#ifndef HC_08_RESYNC_H
+#define HC_08_RESYNC_H
+
+#include "hc-08.h"
+
+#define HC_08_RESYNC_FLUSH_READS   4   // reads that must come back empty before the line is quiet
+#define HC_08_RESYNC_PROBES        2   // AT probes at the current line settings
+
+typedef enum{
+  hc_08_resync_result_ok,        // the answer looked valid, nothing was done
+  hc_08_resync_result_flushed,   // recovered by flushing and probing
+  hc_08_resync_result_baud,      // recovered at other UART settings, see hc_08->param.baud/parity
+  hc_08_resync_result_failed
+}hc_08_resync_result;
+
+/*
+ * Recovery from a lost UART framing (noise, a partial answer, the module at another baud
+ * rate). hc_08_resync_check(...) is called after hc_08_read_answer(...) of an AT command:
+ * an answer with bytes that are not text, or one that does not fit the command in
+ * buff_tx (a set command must be answered with OK or ERROR), starts the recovery:
+ * the line is read until it is quiet, AT is probed, and if that fails the UART settings
+ * of the host are changed through set_line until AT is answered.
+ * Only for AT commands, i.e. while the module is not connected.
+ */
+typedef struct{
+  hc_08_ST *hc_08;
+  hc_08_status (*set_line)(void *ctx, hc_08_baud baud, hc_08_parity_bit parity);
+  void *ctx;
+
+  struct{
+    uint8_t flush_reads;
+    uint8_t probes;
+  }cfg;
+
+  struct{
+    uint32_t checks;
+    uint32_t desyncs;
+    uint32_t flushed;          // recovered without changing the line
+    uint32_t baud;             // recovered at other UART settings
+    uint32_t failed;
+    uint32_t probes;           // AT commands sent by the recovery
+    uint32_t recovery;         // ms, last recovery
+    uint32_t recovery_max;     // ms
+  }metrics;
+}hc_08_resync_ST;
+
+void hc_08_resync_init(hc_08_resync_ST *resync, hc_08_ST *hc_08,
+                       hc_08_status (*set_line)(void *ctx, hc_08_baud baud, hc_08_parity_bit parity), void *ctx);
+hc_08_status hc_08_resync_valid(hc_08_ST *hc_08);
+hc_08_resync_result hc_08_resync_check(hc_08_resync_ST *resync);
+hc_08_resync_result hc_08_resync_recover(hc_08_resync_ST *resync);
+
+#endif /* HC_08_RESYNC_H */
@@ -0,0 +1,249 @@
+#include "hc-08-rf-tune.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+  * @brief  Locking out a level that did not hold the link, twice as long as the last time
+  * @param  *tune pointer to the tuner structure
+  * @param  rfpm the level
+  * @param  now current tick
+  */
+static void hc_08_rf_tune_fail(hc_08_rf_tune_ST *tune, hc_08_rfpm rfpm, uint32_t now){
+  if(tune->lockout[rfpm] == 0){
+    tune->lockout[rfpm] = tune->cfg.lockout;
+  }else if(tune->lockout[rfpm] < tune->cfg.lockout_max / 2){
+    tune->lockout[rfpm] *= 2;
+  }else{
+    tune->lockout[rfpm] = tune->cfg.lockout_max;
+  }
+  tune->locked_until[rfpm] = now + tune->lockout[rfpm];
+}
+
+/**
+  * @brief  Closing the window and counting its time for the level in use
+  */
+static void hc_08_rf_tune_restart(hc_08_rf_tune_ST *tune, uint32_t now){
+  tune->metrics.level_time[tune->rfpm] += now - tune->window_tick;
+  tune->window_tick = now;
+  memset(&tune->window, 0, sizeof(tune->window));
+}
+
+/**
+  * @brief  Judging the window and choosing the level for the next ones
+  * @param  *tune pointer to the tuner structure
+  * @param  now current tick
+  */
+static void hc_08_rf_tune_evaluate(hc_08_rf_tune_ST *tune, uint32_t now){
+  uint64_t retx = tune->window.frames ? ((uint64_t)tune->window.retransmits * 1000) / tune->window.frames : 0;
+  hc_08_rf_tune_record_ST record = {
+    .tick = now,
+    .rfpm = tune->rfpm,
+    .frames = tune->window.frames,
+    .retx = retx > UINT16_MAX ? UINT16_MAX : (uint16_t)retx,
+    .rtt = tune->window.rtt_count ? tune->window.rtt_sum / tune->window.rtt_count : 0,
+    .disconnects = tune->window.disconnects,
+    .event = hc_08_rf_tune_event_none
+  };
+  uint8_t judged = record.frames >= tune->cfg.min_frames;
+  uint32_t rtt_best = tune->metrics.rtt_best;
+
+  if(record.rtt != 0 && (rtt_best == 0 || record.rtt < rtt_best)){
+    tune->metrics.rtt_best = record.rtt;
+  }
+
+  if(record.disconnects > 0 || tune->window.no_link){
+    record.event = record.disconnects > 0 ? hc_08_rf_tune_event_disconnect : hc_08_rf_tune_event_no_link;
+    tune->metrics.disconnects += record.disconnects;
+    if(record.rfpm != hc_08_rfpm_4dBm && (record.disconnects > 0 || !tune->held)){
+      hc_08_rf_tune_fail(tune, record.rfpm, now);
+    }
+    tune->target = hc_08_rfpm_4dBm;
+    tune->healthy = 0;
+  }else if(judged && (record.retx > tune->cfg.retx_high ||
+      (record.rtt != 0 && rtt_best != 0 && record.rtt * 100 > rtt_best * tune->cfg.rtt_high))){
+    if(record.rfpm != hc_08_rfpm_4dBm){
+      record.event = hc_08_rf_tune_event_up;
+      hc_08_rf_tune_fail(tune, record.rfpm, now);
+      tune->target = (hc_08_rfpm)(record.rfpm - 1);
+    }
+    tune->healthy = 0;
+  }else if(judged && record.retx <= tune->cfg.retx_low &&
+      (record.rtt == 0 || rtt_best == 0 || record.rtt * 100 <= rtt_best * tune->cfg.rtt_low)){
+    if(!tune->healthy){
+      tune->healthy = 1;
+      tune->healthy_since = tune->window_tick;
+    }
+    if(now - tune->healthy_since >= tune->cfg.down_hold && tune->target == record.rfpm &&
+        record.rfpm < tune->cfg.lowest && (int32_t)(now - tune->locked_until[record.rfpm + 1]) >= 0){
+      record.event = hc_08_rf_tune_event_down;
+      tune->target = (hc_08_rfpm)(record.rfpm + 1);
+      tune->healthy_since = now;
+    }
+  }else{
+    // between the thresholds, or too little traffic to judge: hold the level
+    tune->healthy = 0;
+  }
+
+  if(record.event == hc_08_rf_tune_event_down){
+    tune->metrics.downs++;
+  }else if(record.event != hc_08_rf_tune_event_none){
+    tune->metrics.ups++;
+  }
+  record.target = tune->target;
+  if(tune->history_size > 0){
+    tune->history[tune->history_count % tune->history_size] = record;
+  }
+  tune->history_count++;
+  hc_08_rf_tune_restart(tune, now);
+}
+
+/**
+  * @brief  Writing the chosen level to the module (only while not connected)
+  * @param  *tune pointer to the tuner structure
+  * @param  now current tick
+  */
+static void hc_08_rf_tune_apply(hc_08_rf_tune_ST *tune, uint32_t now){
+  tune->write_tick = now;
+  hc_08_clear_buff_rx(tune->hc_08);
+  hc_08_cmd_set_rf_power(tune->hc_08, tune->target);
+  hc_08_read_answer(tune->hc_08);
+  if(hc_08_check_set(tune->hc_08) != hc_08_status_ok){
+    tune->metrics.rejected++;
+    return;
+  }
+  hc_08_rf_tune_restart(tune, now);
+  tune->held = 0;
+  tune->down_tick = now;
+  tune->rfpm = tune->target;
+  tune->hc_08->param.rfpm = tune->target;
+  tune->metrics.writes++;
+}
+
+/**
+  * @brief  Initialization of the RF power tuner. The module is taken to be at the power in
+  *         hc_08->param.rfpm if it was read, at 4 dBm otherwise
+  * @param  *tune pointer to the tuner structure
+  * @param  *hc_08 pointer to the HC-08 module structure. A tick source must be registered
+  *           with hc_08_reg_tick_cbfunc(...)
+  * @param  release ends the connection so a new level can be written, NULL to wait for the
+  *           next disconnection
+  * @param  *ctx user pointer passed to release
+  * @param  *history array for the window records, NULL if not needed
+  * @param  history_size number of records in the array
+  */
+void hc_08_rf_tune_init(hc_08_rf_tune_ST *tune, hc_08_ST *hc_08, void (*release)(void *ctx), void *ctx,
+                        hc_08_rf_tune_record_ST *history, uint16_t history_size){
+  memset(tune, 0, sizeof(*tune));
+  tune->hc_08 = hc_08;
+  tune->release = release;
+  tune->ctx = ctx;
+  tune->history = history;
+  tune->history_size = history != NULL ? history_size : 0;
+
+  tune->cfg.period = HC_08_RF_TUNE_PERIOD;
+  tune->cfg.min_frames = HC_08_RF_TUNE_MIN_FRAMES;
+  tune->cfg.retx_high = HC_08_RF_TUNE_RETX_HIGH;
+  tune->cfg.retx_low = HC_08_RF_TUNE_RETX_LOW;
+  tune->cfg.rtt_high = HC_08_RF_TUNE_RTT_HIGH;
+  tune->cfg.rtt_low = HC_08_RF_TUNE_RTT_LOW;
+  tune->cfg.down_hold = HC_08_RF_TUNE_DOWN_HOLD;
+  tune->cfg.lockout = HC_08_RF_TUNE_LOCKOUT;
+  tune->cfg.lockout_max = HC_08_RF_TUNE_LOCKOUT_MAX;
+  tune->cfg.reconnect = HC_08_RF_TUNE_RECONNECT;
+  tune->cfg.lowest = hc_08_rfpm_m23dBm;
+
+  tune->rfpm = (hc_08->param_valid & (1UL << hc_08_field_rfpm)) ? hc_08->param.rfpm : hc_08_rfpm_4dBm;
+  tune->target = tune->rfpm;
+  tune->last_connect = hc_08->status_connect;
+  tune->window_tick = hc_08_get_tick(hc_08);
+  tune->down_tick = tune->window_tick;
+  tune->write_tick = tune->window_tick - tune->cfg.period;
+}
+
+/**
+  * @brief  Reporting what the application saw of the link since the last report
+  * @param  *tune pointer to the tuner structure
+  * @param  frames frames sent
+  * @param  retransmits frames that had to be sent again
+  * @param  rtt ms, round trip of a heartbeat, 0 if there was none
+  */
+void hc_08_rf_tune_report(hc_08_rf_tune_ST *tune, uint32_t frames, uint32_t retransmits, uint32_t rtt){
+  tune->window.frames += frames;
+  tune->window.retransmits += retransmits;
+  if(rtt != 0){
+    tune->window.rtt_sum += rtt;
+    tune->window.rtt_count++;
+  }
+}
+
+/**
+  * @brief  Processing of the tuner, called from the main loop. A disconnection is judged at
+  *         once, as is cfg.reconnect without connection at a level below 4 dBm, the other
+  *         windows every cfg.period. Blocks only to write AT+RFPM
+  * @param  *tune pointer to the tuner structure
+  */
+void hc_08_rf_tune_process(hc_08_rf_tune_ST *tune){
+  uint32_t now = hc_08_get_tick(tune->hc_08);
+  hc_08_status_connect connect = tune->hc_08->status_connect;
+
+  if(connect == hc_08_status_connected){
+    tune->held = 1;
+  }else if(tune->last_connect == hc_08_status_connected){
+    tune->down_tick = now;
+  }
+
+  if(tune->last_connect == hc_08_status_connected && connect != hc_08_status_connected && !tune->released){
+    tune->window.disconnects++;
+    hc_08_rf_tune_evaluate(tune, now);
+  }else if(connect != hc_08_status_connected && tune->rfpm != hc_08_rfpm_4dBm && tune->target == tune->rfpm &&
+      now - tune->down_tick >= tune->cfg.reconnect){
+    tune->window.no_link = 1;
+    hc_08_rf_tune_evaluate(tune, now);
+  }else if(now - tune->window_tick >= tune->cfg.period){
+    hc_08_rf_tune_evaluate(tune, now);
+  }
+  if(tune->last_connect == hc_08_status_connected && connect != hc_08_status_connected){
+    tune->released = 0;         // the release, if any, has ended this connection
+  }
+  tune->last_connect = connect;
+
+  if(tune->target == tune->rfpm){
+    return;
+  }
+  if(connect != hc_08_status_connected){
+    if(tune->metrics.rejected == 0 || now - tune->write_tick >= tune->cfg.period){
+      hc_08_rf_tune_apply(tune, now);
+    }
+  }else if(tune->release != NULL && !tune->released){
+    tune->released = 1;
+    tune->metrics.releases++;
+    tune->release(tune->ctx);
+  }
+}
+
+/**
+  * @brief  A record of the history
+  * @param  *tune pointer to the tuner structure
+  * @param  age 0 for the last window, 1 for the one before...
+  * @retval pointer to the record, NULL if it was overwritten or does not exist
+  */
+const hc_08_rf_tune_record_ST *hc_08_rf_tune_record(hc_08_rf_tune_ST *tune, uint32_t age){
+  if(age >= tune->history_count || age >= tune->history_size){
+    return NULL;
+  }
+  return &tune->history[(tune->history_count - 1 - age) % tune->history_size];
+}
+
+/**
+  * @brief  A record as one CSV line without line end: tick,rfpm,target,frames,retx,rtt,disconnects,event
+  * @param  *record the record
+  * @param  *buff output buffer
+  * @param  size buffer size
+  * @retval length of the line (snprintf)
+  */
+int hc_08_rf_tune_format(const hc_08_rf_tune_record_ST *record, char *buff, uint16_t size){
+  return snprintf(buff, size, "%lu,%s,%s,%lu,%u,%lu,%u,%s", (unsigned long)record->tick,
+                  hc_08_rfpm_c[record->rfpm], hc_08_rfpm_c[record->target], (unsigned long)record->frames,
+                  (unsigned int)record->retx, (unsigned long)record->rtt, (unsigned int)record->disconnects,
+                  hc_08_rf_tune_event_c[record->event]);
+}
@@ -0,0 +1,128 @@
+#ifndef HC_08_RF_TUNE_H
+#define HC_08_RF_TUNE_H
+
+#include "hc-08.h"
+
+#define HC_08_RF_TUNE_PERIOD        10000   // ms, one evaluation window
+#define HC_08_RF_TUNE_MIN_FRAMES    20      // frames a window needs to judge the link
+#define HC_08_RF_TUNE_RETX_HIGH     50      // retransmits per 1000 frames, step up above
+#define HC_08_RF_TUNE_RETX_LOW      5       // retransmits per 1000 frames, healthy below
+#define HC_08_RF_TUNE_RTT_HIGH      150     // % of the best RTT, step up above
+#define HC_08_RF_TUNE_RTT_LOW       120     // % of the best RTT, healthy below
+#define HC_08_RF_TUNE_DOWN_HOLD     60000   // ms of healthy windows before one step down
+#define HC_08_RF_TUNE_LOCKOUT       300000  // ms a level that failed is not tried again, doubles per failure
+#define HC_08_RF_TUNE_LOCKOUT_MAX   3600000 // ms
+#define HC_08_RF_TUNE_RECONNECT     30000   // ms without connection before going back to 4 dBm
+
+typedef enum{
+  hc_08_rf_tune_event_none,
+  hc_08_rf_tune_event_down,          // one step lower power after down_hold of healthy windows
+  hc_08_rf_tune_event_up,            // one step higher power, retransmits or RTT too high
+  hc_08_rf_tune_event_disconnect,    // back to the highest power after a disconnection
+  hc_08_rf_tune_event_no_link        // back to the highest power, no connection for cfg.reconnect
+}hc_08_rf_tune_event;
+
+static const char * const hc_08_rf_tune_event_c[] = {
+  [hc_08_rf_tune_event_none] = "none",
+  [hc_08_rf_tune_event_down] = "down",
+  [hc_08_rf_tune_event_up] = "up",
+  [hc_08_rf_tune_event_disconnect] = "disconnect",
+  [hc_08_rf_tune_event_no_link] = "no link"
+};
+
+/*
+ * One evaluation window, as kept in the history
+ */
+typedef struct{
+  uint32_t tick;                     // end of the window
+  hc_08_rfpm rfpm;                   // level used during the window
+  hc_08_rfpm target;                 // level chosen for the next windows
+  uint32_t frames;
+  uint16_t retx;                     // retransmits per 1000 frames
+  uint32_t rtt;                      // ms, average heartbeat RTT, 0 without heartbeats
+  uint16_t disconnects;
+  hc_08_rf_tune_event event;
+}hc_08_rf_tune_record_ST;
+
+/*
+ * RF power autotuning from the link quality. The application reports what it sees of the
+ * link (hc_08_rf_tune_report: frames sent, frames it had to send again, heartbeat RTT),
+ * and the tuner counts disconnections from hc_08->status_connect. Every cfg.period the
+ * window is judged: a disconnection goes straight back to 4 dBm, retransmits or RTT above
+ * the high thresholds step up one level, and only after cfg.down_hold of windows below the
+ * low thresholds the power is stepped down one level. A level left because it failed is
+ * locked out for cfg.lockout, doubled each time it fails again, so the tuner does not keep
+ * probing a level that does not hold. Without a connection for cfg.reconnect the power also
+ * goes back to 4 dBm, and the level is locked out if it never had a connection (the peer
+ * may not hear it at all). AT+RFPM is accepted only while not connected, so a
+ * new level is written at the next moment the module is not connected; the release
+ * callback, if given, is called once per new level while connected and may end the
+ * connection (e.g. through the KEY pin) to apply it sooner. That disconnection is not
+ * counted against the link. Every window is appended to the caller's history ring
+ * (oldest records overwritten).
+ * Needs a tick source (hc_08_reg_tick_cbfunc).
+ */
+typedef struct{
+  hc_08_ST *hc_08;
+  void (*release)(void *ctx);
+  void *ctx;
+  hc_08_rf_tune_record_ST *history;
+  uint16_t history_size;
+  uint32_t history_count;            // records written since the initialization
+
+  struct{
+    uint32_t period;
+    uint32_t min_frames;
+    uint16_t retx_high;
+    uint16_t retx_low;
+    uint16_t rtt_high;
+    uint16_t rtt_low;
+    uint32_t down_hold;
+    uint32_t lockout;
+    uint32_t lockout_max;
+    uint32_t reconnect;
+    hc_08_rfpm lowest;               // lowest power the tuner may choose
+  }cfg;
+
+  hc_08_rfpm rfpm;                   // level written to the module
+  hc_08_rfpm target;
+  uint32_t window_tick;
+  uint32_t write_tick;
+  uint32_t healthy_since;
+  uint32_t down_tick;                // connection lost or level written while not connected
+  uint8_t healthy;
+  uint8_t held;                      // the level in use had a connection
+  uint8_t released;                  // release was called during this connection
+  hc_08_status_connect last_connect;
+  uint32_t locked_until[HC_08_RFPM_SIZE];
+  uint32_t lockout[HC_08_RFPM_SIZE];
+
+  struct{
+    uint32_t frames;
+    uint32_t retransmits;
+    uint32_t rtt_sum;
+    uint32_t rtt_count;
+    uint16_t disconnects;
+    uint8_t no_link;
+  }window;
+
+  struct{
+    uint32_t rtt_best;               // ms, lowest window RTT seen
+    uint32_t level_time[HC_08_RFPM_SIZE];  // ms spent at each level
+    uint32_t downs;
+    uint32_t ups;
+    uint32_t disconnects;
+    uint32_t writes;                 // AT+RFPM accepted
+    uint32_t rejected;
+    uint32_t releases;
+  }metrics;
+}hc_08_rf_tune_ST;
+
+void hc_08_rf_tune_init(hc_08_rf_tune_ST *tune, hc_08_ST *hc_08, void (*release)(void *ctx), void *ctx,
+                        hc_08_rf_tune_record_ST *history, uint16_t history_size);
+void hc_08_rf_tune_report(hc_08_rf_tune_ST *tune, uint32_t frames, uint32_t retransmits, uint32_t rtt);
+void hc_08_rf_tune_process(hc_08_rf_tune_ST *tune);
+const hc_08_rf_tune_record_ST *hc_08_rf_tune_record(hc_08_rf_tune_ST *tune, uint32_t age);
+int hc_08_rf_tune_format(const hc_08_rf_tune_record_ST *record, char *buff, uint16_t size);
+
+#endif /* HC_08_RF_TUNE_H */
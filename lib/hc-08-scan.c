@@ -0,0 +1,341 @@
+#include "hc-08-scan.h"
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define HC_08_SCAN_X86
+#include <immintrin.h>
+#endif
+
+#define HC_08_SCAN_NONE   -1
+#define HC_08_SCAN_WAIT   -2     // a marker may start here, the rest is not received yet
+
+/**
+  * @brief  Next position where the first two bytes of a marker appear, one byte at a time.
+  *         The last byte of the data is a candidate when it starts a marker
+  * @param  *scan pointer to the scanner structure
+  * @param  *data the data
+  * @param  size data size
+  * @param  from first position to look at
+  * @param  limit positions from limit on are not looked at
+  * @retval the position, limit (or from if it is beyond) if there is none
+  */
+static uint32_t hc_08_scan_next_scalar(const hc_08_scan_ST *scan, const uint8_t *data, uint32_t size,
+                                       uint32_t from, uint32_t limit){
+  for(; from < limit; from++){
+    uint8_t bits = scan->first_map[data[from]];
+
+    if(bits != 0 && ((bits & scan->pair_any) != 0 || from + 1 >= size ||
+        (bits & scan->second_map[data[from + 1]]) != 0)){
+      return from;
+    }
+  }
+  return from;
+}
+
+#ifdef HC_08_SCAN_X86
+/**
+  * @brief  hc_08_scan_next_scalar(...) 16 positions per step
+  */
+__attribute__((target("sse2")))
+static uint32_t hc_08_scan_next_sse2(const hc_08_scan_ST *scan, const uint8_t *data, uint32_t size,
+                                     uint32_t from, uint32_t limit){
+  __m128i first[HC_08_SCAN_MARKERS], second[HC_08_SCAN_MARKERS];
+
+  for(uint8_t i = 0; i < scan->pair_count; i++){
+    first[i] = _mm_set1_epi8((char)scan->pair_first[i]);
+    second[i] = _mm_set1_epi8((char)scan->pair_second[i]);
+  }
+  while(from < limit && size - from > 16){
+    __m128i a = _mm_loadu_si128((const __m128i *)(data + from));
+    __m128i b = _mm_loadu_si128((const __m128i *)(data + from + 1));
+    __m128i hit = _mm_setzero_si128();
+    uint32_t mask;
+
+    for(uint8_t i = 0; i < scan->pair_count; i++){
+      __m128i eq = _mm_cmpeq_epi8(a, first[i]);
+
+      if(!(scan->pair_any & (1 << i))){
+        eq = _mm_and_si128(eq, _mm_cmpeq_epi8(b, second[i]));
+      }
+      hit = _mm_or_si128(hit, eq);
+    }
+    mask = (uint32_t)_mm_movemask_epi8(hit);
+    if(mask != 0){
+      from += (uint32_t)__builtin_ctz(mask);
+      return from < limit ? from : limit;
+    }
+    from += 16;
+  }
+  return hc_08_scan_next_scalar(scan, data, size, from, limit);
+}
+
+/**
+  * @brief  hc_08_scan_next_scalar(...) 64 positions per step, in two registers
+  */
+__attribute__((target("avx2")))
+static uint32_t hc_08_scan_next_avx2(const hc_08_scan_ST *scan, const uint8_t *data, uint32_t size,
+                                     uint32_t from, uint32_t limit){
+  __m256i first[HC_08_SCAN_MARKERS], second[HC_08_SCAN_MARKERS];
+
+  for(uint8_t i = 0; i < scan->pair_count; i++){
+    first[i] = _mm256_set1_epi8((char)scan->pair_first[i]);
+    second[i] = _mm256_set1_epi8((char)scan->pair_second[i]);
+  }
+  while(from < limit && size - from > 64){
+    __m256i a0 = _mm256_loadu_si256((const __m256i *)(data + from));
+    __m256i b0 = _mm256_loadu_si256((const __m256i *)(data + from + 1));
+    __m256i a1 = _mm256_loadu_si256((const __m256i *)(data + from + 32));
+    __m256i b1 = _mm256_loadu_si256((const __m256i *)(data + from + 33));
+    __m256i hit0 = _mm256_setzero_si256();
+    __m256i hit1 = _mm256_setzero_si256();
+    uint64_t mask;
+
+    for(uint8_t i = 0; i < scan->pair_count; i++){
+      __m256i eq0 = _mm256_cmpeq_epi8(a0, first[i]);
+      __m256i eq1 = _mm256_cmpeq_epi8(a1, first[i]);
+
+      if(!(scan->pair_any & (1 << i))){
+        eq0 = _mm256_and_si256(eq0, _mm256_cmpeq_epi8(b0, second[i]));
+        eq1 = _mm256_and_si256(eq1, _mm256_cmpeq_epi8(b1, second[i]));
+      }
+      hit0 = _mm256_or_si256(hit0, eq0);
+      hit1 = _mm256_or_si256(hit1, eq1);
+    }
+    mask = (uint32_t)_mm256_movemask_epi8(hit0) | ((uint64_t)(uint32_t)_mm256_movemask_epi8(hit1) << 32);
+    if(mask != 0){
+      from += (uint32_t)__builtin_ctzll(mask);
+      return from < limit ? from : limit;
+    }
+    from += 64;
+  }
+  return hc_08_scan_next_scalar(scan, data, size, from, limit);
+}
+#endif
+
+/**
+  * @brief  Checking if the CPU can run a kernel
+  * @param  kernel the kernel
+  * @retval 1 if it can
+  */
+static uint8_t hc_08_scan_supported(hc_08_scan_kernel kernel){
+  switch(kernel){
+    case hc_08_scan_kernel_scalar:
+      return 1;
+#ifdef HC_08_SCAN_X86
+    case hc_08_scan_kernel_sse2:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("sse2") != 0;
+    case hc_08_scan_kernel_avx2:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2") != 0;
+#endif
+    default:
+      return 0;
+  }
+}
+
+/**
+  * @brief  Marker at a position
+  * @param  *scan pointer to the scanner structure
+  * @param  *data data from the position on
+  * @param  size bytes from the position on
+  * @param  final 1 if no more data will follow
+  * @retval index of the marker, HC_08_SCAN_NONE or HC_08_SCAN_WAIT if a marker added before
+  *         the first one that matches may still match with more data
+  */
+static int16_t hc_08_scan_match(const hc_08_scan_ST *scan, const uint8_t *data, uint32_t size, uint8_t final){
+  for(uint8_t i = 0; i < scan->marker_count; i++){
+    if(scan->marker[i].size <= size){
+      if(memcmp(data, scan->marker[i].data, scan->marker[i].size) == 0){
+        return i;
+      }
+    }else if(!final && memcmp(data, scan->marker[i].data, size) == 0){
+      return HC_08_SCAN_WAIT;
+    }
+  }
+  return HC_08_SCAN_NONE;
+}
+
+static void hc_08_scan_span(hc_08_scan_ST *scan, const uint8_t *data, uint32_t size){
+  if(size > 0){
+    scan->metrics.spans++;
+    scan->span(scan->ctx, (const char *)data, size);
+  }
+}
+
+/**
+  * @brief  Scanning a block of data
+  * @param  *scan pointer to the scanner structure
+  * @param  *data the data
+  * @param  size data size
+  * @param  from first position, the data before it was handled already
+  * @param  limit markers are looked for at the positions before limit, and spans end at
+  *           limit at the latest
+  * @param  final 1 if no more data will follow
+  * @retval position up to which the data was handled: limit, the end of a marker that
+  *         crosses limit, or the position of a marker that needs more data
+  */
+static uint32_t hc_08_scan_block(hc_08_scan_ST *scan, const uint8_t *data, uint32_t size,
+                                 uint32_t from, uint32_t limit, uint8_t final){
+  uint32_t start = from;
+  uint32_t pos = from;
+
+  while((pos = scan->next(scan, data, size, pos, limit)) < limit){
+    int16_t index = hc_08_scan_match(scan, data + pos, size - pos, final);
+
+    scan->metrics.candidates++;
+    if(index == HC_08_SCAN_WAIT){
+      hc_08_scan_span(scan, data + start, pos - start);
+      return pos;
+    }
+    if(index == HC_08_SCAN_NONE){
+      pos++;
+      continue;
+    }
+    hc_08_scan_span(scan, data + start, pos - start);
+    scan->metrics.markers++;
+    scan->found(scan->ctx, scan->marker[index].id);
+    pos += scan->marker[index].size;
+    start = pos;
+  }
+  if(start < limit){
+    hc_08_scan_span(scan, data + start, limit - start);
+    start = limit;
+  }
+  return start;
+}
+
+/**
+  * @brief  Initialization of the scanner, without markers. The best kernel of the CPU is chosen
+  * @param  *scan pointer to the scanner structure
+  * @param  span receives the data between the markers
+  * @param  found receives the id of each marker
+  * @param  *ctx user pointer passed to span and found
+  */
+void hc_08_scan_init(hc_08_scan_ST *scan, void (*span)(void *ctx, const char *data, uint32_t size),
+                     void (*found)(void *ctx, uint8_t id), void *ctx){
+  memset(scan, 0, sizeof(*scan));
+  scan->span = span;
+  scan->found = found;
+  scan->ctx = ctx;
+  for(int8_t kernel = HC_08_SCAN_KERNEL_SIZE - 1; kernel >= 0; kernel--){
+    if(hc_08_scan_set_kernel(scan, (hc_08_scan_kernel)kernel) == hc_08_status_ok){
+      break;
+    }
+  }
+}
+
+/**
+  * @brief  Adding a marker. Markers are added before the first data
+  * @param  *scan pointer to the scanner structure
+  * @param  *marker the marker bytes
+  * @param  size marker size, 1~HC_08_SCAN_MARKER_MAX
+  * @param  id value passed to found
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if there are HC_08_SCAN_MARKERS already or the size is out of range
+  */
+hc_08_status hc_08_scan_add(hc_08_scan_ST *scan, const char *marker, uint8_t size, uint8_t id){
+  uint8_t first, second, any, pair;
+
+  if(scan->marker_count >= HC_08_SCAN_MARKERS || size == 0 || size > HC_08_SCAN_MARKER_MAX){
+    return hc_08_status_error;
+  }
+  memcpy(scan->marker[scan->marker_count].data, marker, size);
+  scan->marker[scan->marker_count].size = size;
+  scan->marker[scan->marker_count].id = id;
+  scan->marker_count++;
+
+  first = (uint8_t)marker[0];
+  second = size > 1 ? (uint8_t)marker[1] : 0;
+  any = size == 1;
+  for(pair = 0; pair < scan->pair_count; pair++){
+    if(scan->pair_first[pair] == first && scan->pair_second[pair] == second &&
+        ((scan->pair_any >> pair) & 1) == any){
+      return hc_08_status_ok;
+    }
+  }
+  scan->pair_first[pair] = first;
+  scan->pair_second[pair] = second;
+  scan->pair_count++;
+  scan->first_map[first] |= 1 << pair;
+  if(any){
+    scan->pair_any |= 1 << pair;
+  }else{
+    scan->second_map[second] |= 1 << pair;
+  }
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Choosing the kernel
+  * @param  *scan pointer to the scanner structure
+  * @param  kernel Takes one of the following values:
+  *           hc_08_scan_kernel_scalar,
+  *           hc_08_scan_kernel_sse2,
+  *           hc_08_scan_kernel_avx2
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if the kernel was not built in or the CPU does not have it
+  */
+hc_08_status hc_08_scan_set_kernel(hc_08_scan_ST *scan, hc_08_scan_kernel kernel){
+  if(!hc_08_scan_supported(kernel)){
+    return hc_08_status_error;
+  }
+  scan->kernel = kernel;
+  scan->next = hc_08_scan_next_scalar;
+#ifdef HC_08_SCAN_X86
+  if(kernel == hc_08_scan_kernel_sse2){
+    scan->next = hc_08_scan_next_sse2;
+  }else if(kernel == hc_08_scan_kernel_avx2){
+    scan->next = hc_08_scan_next_avx2;
+  }
+#endif
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Scanning the next chunk of the stream
+  * @param  *scan pointer to the scanner structure
+  * @param  *data the chunk
+  * @param  size chunk size
+  */
+void hc_08_scan_feed(hc_08_scan_ST *scan, const char *data, uint32_t size){
+  const uint8_t *bytes = (const uint8_t *)data;
+  uint32_t pos = 0;
+  uint32_t end;
+
+  scan->metrics.bytes += size;
+  if(scan->hold_size > 0){
+    // the kept bytes and the start of the chunk, enough for any marker starting in the kept bytes
+    uint8_t bridge[2 * HC_08_SCAN_MARKER_MAX];
+    uint32_t head = size < HC_08_SCAN_MARKER_MAX ? size : HC_08_SCAN_MARKER_MAX;
+    uint32_t bridge_size = scan->hold_size + head;
+
+    memcpy(bridge, scan->hold, scan->hold_size);
+    memcpy(bridge + scan->hold_size, bytes, head);
+    if(head == size){
+      end = hc_08_scan_block(scan, bridge, bridge_size, 0, bridge_size, 0);
+      scan->hold_size = (uint8_t)(bridge_size - end);
+      memcpy(scan->hold, bridge + end, scan->hold_size);
+      return;
+    }
+    end = hc_08_scan_block(scan, bridge, bridge_size, 0, scan->hold_size, 0);
+    pos = end - scan->hold_size;
+    scan->hold_size = 0;
+  }
+  end = hc_08_scan_block(scan, bytes, size, pos, size, 0);
+  scan->hold_size = (uint8_t)(size - end);
+  memcpy(scan->hold, bytes + end, scan->hold_size);
+}
+
+/**
+  * @brief  End of the stream: the kept bytes are scanned without waiting for more data
+  * @param  *scan pointer to the scanner structure
+  */
+void hc_08_scan_flush(hc_08_scan_ST *scan){
+  uint8_t size = scan->hold_size;
+
+  scan->hold_size = 0;
+  hc_08_scan_block(scan, scan->hold, size, 0, size, 1);
+}
@@ -0,0 +1,78 @@
+#ifndef HC_08_SCAN_H
+#define HC_08_SCAN_H
+
+#include "hc-08.h"
+
+#define HC_08_SCAN_MARKERS      8
+#define HC_08_SCAN_MARKER_MAX   16
+
+typedef enum{
+  hc_08_scan_kernel_scalar,
+  hc_08_scan_kernel_sse2,
+  hc_08_scan_kernel_avx2
+}hc_08_scan_kernel;
+
+static const char * const hc_08_scan_kernel_c[] = {
+  [hc_08_scan_kernel_scalar] = "scalar",
+  [hc_08_scan_kernel_sse2] = "sse2",
+  [hc_08_scan_kernel_avx2] = "avx2"
+};
+#define HC_08_SCAN_KERNEL_SIZE 0x03
+
+typedef struct hc_08_scan_ST hc_08_scan_ST;
+
+/*
+ * Marker scanner for received streams: finds markers (module status strings, frame
+ * delimiters...) in chunks of any size and hands the bytes between them to span(...) and
+ * each marker to found(...), in stream order. The span data is valid only during the call.
+ * A marker split across two chunks is found as well: a chunk end that may be the start of
+ * a marker is kept until the next chunk (at most HC_08_SCAN_MARKER_MAX - 1 bytes) or
+ * hc_08_scan_flush(...). Where markers overlap, the leftmost wins, and at the same
+ * position the first one added. The result does not depend on how the stream is cut
+ * into chunks.
+ * The kernel looks for positions where the first two bytes of a marker appear, 16 (SSE2)
+ * or 64 (AVX2) positions per step, and only those positions are compared byte by byte.
+ * The best kernel the CPU has is chosen at the initialization.
+ * One scanner per stream; scanners of different streams can run in different threads.
+ */
+struct hc_08_scan_ST{
+  void (*span)(void *ctx, const char *data, uint32_t size);
+  void (*found)(void *ctx, uint8_t id);
+  void *ctx;
+  uint32_t (*next)(const hc_08_scan_ST *scan, const uint8_t *data, uint32_t size, uint32_t from, uint32_t limit);
+  hc_08_scan_kernel kernel;
+
+  struct{
+    uint8_t data[HC_08_SCAN_MARKER_MAX];
+    uint8_t size;
+    uint8_t id;
+  }marker[HC_08_SCAN_MARKERS];
+  uint8_t marker_count;
+
+  // first two bytes of the markers, without repeats
+  uint8_t pair_first[HC_08_SCAN_MARKERS];
+  uint8_t pair_second[HC_08_SCAN_MARKERS];
+  uint8_t pair_any;                  // bit per pair: one-byte marker, any second byte
+  uint8_t pair_count;
+  uint8_t first_map[256];            // bit per pair starting with the byte
+  uint8_t second_map[256];           // bit per pair with the byte in the second place
+
+  uint8_t hold[HC_08_SCAN_MARKER_MAX];
+  uint8_t hold_size;
+
+  struct{
+    uint64_t bytes;
+    uint64_t spans;
+    uint64_t markers;
+    uint64_t candidates;             // positions compared byte by byte
+  }metrics;
+};
+
+void hc_08_scan_init(hc_08_scan_ST *scan, void (*span)(void *ctx, const char *data, uint32_t size),
+                     void (*found)(void *ctx, uint8_t id), void *ctx);
+hc_08_status hc_08_scan_add(hc_08_scan_ST *scan, const char *marker, uint8_t size, uint8_t id);
+hc_08_status hc_08_scan_set_kernel(hc_08_scan_ST *scan, hc_08_scan_kernel kernel);
+void hc_08_scan_feed(hc_08_scan_ST *scan, const char *data, uint32_t size);
+void hc_08_scan_flush(hc_08_scan_ST *scan);
+
+#endif /* HC_08_SCAN_H */
@@ -0,0 +1,280 @@
+#include "hc-08-sched.h"
+#include <string.h>
+
+/**
+  * @brief  Estimated number of samples waiting on a slave since its last visit
+  * @param  *slave pointer to the slave entry
+  * @param  now current tick
+  */
+static uint32_t hc_08_sched_backlog(hc_08_sched_slave_ST *slave, uint32_t now){
+  return (uint32_t)(((uint64_t)slave->rate * (uint32_t)(now - slave->last_visit)) / 1000000UL);
+}
+
+/**
+  * @brief  Time before a slave whose last connects failed is tried again: connect_timeout
+  *         doubled for each failure in a row, up to max_age
+  * @param  *sched pointer to the scheduler structure
+  * @param  *slave pointer to the slave entry
+  */
+static uint32_t hc_08_sched_backoff(hc_08_sched_ST *sched, hc_08_sched_slave_ST *slave){
+  uint8_t shift = slave->retry > HC_08_SCHED_BACKOFF_MAX ? HC_08_SCHED_BACKOFF_MAX : slave->retry;
+  uint64_t backoff = (uint64_t)sched->cfg.connect_timeout << shift;
+
+  return backoff < sched->cfg.max_age ? (uint32_t)backoff : sched->cfg.max_age;
+}
+
+/**
+  * @brief  Choosing the next slave to visit. Slaves that were never tried, that exceeded
+  *         max_age or whose retry backoff ran out go first, otherwise the slave with the best
+  *         ratio of expected backlog to the time needed to reconnect and drain it is taken.
+  *         A slave waiting for its backoff gets no slot at all
+  * @param  *sched pointer to the scheduler structure
+  * @param  now current tick
+  * @retval index of the slave, HC_08_SCHED_NONE if every slave is waiting for its backoff
+  */
+static uint8_t hc_08_sched_pick(hc_08_sched_ST *sched, uint32_t now){
+  uint8_t best = HC_08_SCHED_NONE;
+  uint64_t best_score = 0;
+  uint32_t best_age = 0;
+
+  for(uint8_t i = 0; i < sched->slave_count; i++){
+    hc_08_sched_slave_ST *slave = &sched->slave[i];
+    uint32_t age = now - slave->last_visit;
+    uint64_t score;
+
+    if(age >= sched->cfg.max_age || (slave->visits == 0 && slave->connect_fails == 0)){
+      score = UINT64_MAX;
+    }else if(slave->retry > 0){
+      if(age < hc_08_sched_backoff(sched, slave)){
+        continue;
+      }
+      score = UINT64_MAX;
+    }else{
+      uint64_t backlog = hc_08_sched_backlog(slave, now);
+      uint64_t cost = (uint64_t)slave->reconnect_cost * 1000 + backlog * slave->sample_cost + 1;
+      score = backlog * 1000000ULL / cost;
+    }
+
+    if(best == HC_08_SCHED_NONE || score > best_score || (score == best_score && age > best_age)){
+      best = i;
+      best_score = score;
+      best_age = age;
+    }
+  }
+  return best;
+}
+
+/**
+  * @brief  Closing the statistics of the current visit and moving to the disconnect state
+  * @param  *sched pointer to the scheduler structure
+  * @param  now current tick
+  */
+static void hc_08_sched_leave(hc_08_sched_ST *sched, uint32_t now){
+  hc_08_sched_slave_ST *slave = &sched->slave[sched->current];
+  uint32_t elapsed = now - slave->last_visit;
+  uint32_t polled = sched->last_sample_tick - sched->state_tick;
+
+  if(slave->visits > 0 && elapsed > 0){
+    uint32_t rate = (uint32_t)(((uint64_t)sched->visit_samples * 1000000UL) / elapsed);
+    slave->rate = (slave->rate * 3 + rate) / 4;
+  }
+  if(sched->visit_samples > 0){
+    uint32_t cost = (uint32_t)(((uint64_t)polled * 1000) / sched->visit_samples);
+    slave->sample_cost = slave->sample_cost ? (slave->sample_cost * 3 + cost) / 4 : cost;
+  }
+  slave->visits++;
+  slave->retry = 0;
+  slave->last_visit = now;
+  sched->stats.visits++;
+
+  sched->cb.disconnect(sched->hc_08, slave->addres, sched->cb.ctx);
+  sched->state = hc_08_sched_state_disconnecting;
+  sched->state_tick = now;
+}
+
+/**
+  * @brief  Initialization of the multi-slave polling scheduler for a module in master role
+  * @param  *sched pointer to the scheduler structure
+  * @param  *hc_08 pointer to the HC-08 module structure. A tick source must be registered
+  *           with hc_08_reg_tick_cbfunc(...)
+  * @param  connect starts a connection to the slave with the given address. Completion is
+  *           reported through hc_08_status_connect_set(...)
+  * @param  poll pulls pending data from the connected slave, returns the number of samples read
+  * @param  disconnect drops the current connection. Completion is reported through
+  *           hc_08_status_connect_set(...)
+  * @param  *ctx user pointer passed to the callbacks
+  */
+void hc_08_sched_init(hc_08_sched_ST *sched, hc_08_ST *hc_08,
+                      hc_08_status (*connect)(hc_08_ST *hc_08, const uint8_t *addres, void *ctx),
+                      uint16_t (*poll)(hc_08_ST *hc_08, const uint8_t *addres, void *ctx),
+                      void (*disconnect)(hc_08_ST *hc_08, const uint8_t *addres, void *ctx),
+                      void *ctx){
+  memset(sched, 0, sizeof(*sched));
+  sched->hc_08 = hc_08;
+  sched->cb.connect = connect;
+  sched->cb.poll = poll;
+  sched->cb.disconnect = disconnect;
+  sched->cb.ctx = ctx;
+
+  sched->cfg.connect_timeout = HC_08_SCHED_CONNECT_TIMEOUT;
+  sched->cfg.dwell_min = HC_08_SCHED_DWELL_MIN;
+  sched->cfg.dwell_max = HC_08_SCHED_DWELL_MAX;
+  sched->cfg.idle_gap = HC_08_SCHED_IDLE_GAP;
+  sched->cfg.max_age = HC_08_SCHED_MAX_AGE;
+
+  sched->state = hc_08_sched_state_select;
+  sched->stats.window_start = hc_08_get_tick(hc_08);
+  hc_08_status_connect_set(hc_08, hc_08_status_not_connected);
+}
+
+/**
+  * @brief  Adding a slave to the polling list
+  * @param  *sched pointer to the scheduler structure
+  * @param  *addres pointer to the slave address (array of 6 bytes)
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if the list is full
+  */
+hc_08_status hc_08_sched_add_slave(hc_08_sched_ST *sched, const uint8_t *addres){
+  if(sched->slave_count >= HC_08_SCHED_MAX_SLAVES){
+    return hc_08_status_error;
+  }
+
+  hc_08_sched_slave_ST *slave = &sched->slave[sched->slave_count];
+  memset(slave, 0, sizeof(*slave));
+  memcpy(slave->addres, addres, sizeof(slave->addres));
+  sched->slave_count++;
+
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Removing a slave from the polling list. Must not be called while that slave
+  *         is being visited
+  * @param  *sched pointer to the scheduler structure
+  * @param  *addres pointer to the slave address (array of 6 bytes)
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if the slave is unknown or busy
+  */
+hc_08_status hc_08_sched_remove_slave(hc_08_sched_ST *sched, const uint8_t *addres){
+  for(uint8_t i = 0; i < sched->slave_count; i++){
+    if(memcmp(sched->slave[i].addres, addres, sizeof(sched->slave[i].addres)) == 0){
+      if(i == sched->current && sched->state != hc_08_sched_state_select){
+        return hc_08_status_error;
+      }
+      sched->slave_count--;
+      memmove(&sched->slave[i], &sched->slave[i + 1], (sched->slave_count - i) * sizeof(sched->slave[0]));
+      return hc_08_status_ok;
+    }
+  }
+  return hc_08_status_error;
+}
+
+/**
+  * @brief  Scheduler step. Must be called periodically from the main loop. While every slave
+  *         is waiting for its retry backoff nothing is called until the earliest one runs out
+  * @param  *sched pointer to the scheduler structure
+  */
+void hc_08_sched_process(hc_08_sched_ST *sched){
+  uint32_t now = hc_08_get_tick(sched->hc_08);
+  hc_08_sched_slave_ST *slave;
+  uint8_t current;
+
+  if(now - sched->stats.window_start >= HC_08_SCHED_RATE_WINDOW){
+    sched->stats.samples_per_sec = (uint32_t)(((uint64_t)sched->stats.window_samples * 1000) / (now - sched->stats.window_start));
+    sched->stats.window_samples = 0;
+    sched->stats.window_start = now;
+  }
+
+  if(sched->slave_count == 0){
+    return;
+  }
+
+  switch(sched->state){
+    case hc_08_sched_state_select:
+      current = hc_08_sched_pick(sched, now);
+      if(current == HC_08_SCHED_NONE){
+        sched->stats.idle_passes++;
+        break;
+      }
+      sched->current = current;
+      slave = &sched->slave[sched->current];
+      sched->visit_tick = now;
+      sched->state_tick = now;
+      sched->visit_samples = 0;
+      if(sched->cb.connect(sched->hc_08, slave->addres, sched->cb.ctx) == hc_08_status_ok){
+        sched->state = hc_08_sched_state_connecting;
+      }else{
+        slave->connect_fails++;
+        slave->retry += slave->retry < UINT8_MAX;
+        slave->last_visit = now;
+        sched->stats.connect_fails++;
+      }
+      break;
+
+    case hc_08_sched_state_connecting:
+      slave = &sched->slave[sched->current];
+      if(sched->hc_08->status_connect == hc_08_status_connected){
+        uint32_t cost = now - sched->visit_tick;
+        uint32_t dwell;
+
+        slave->reconnect_cost = slave->reconnect_cost ? (slave->reconnect_cost * 3 + cost) / 4 : cost;
+        dwell = sched->cfg.idle_gap + (uint32_t)(((uint64_t)hc_08_sched_backlog(slave, now) * slave->sample_cost) / 1000);
+        if(dwell < sched->cfg.dwell_min){
+          dwell = sched->cfg.dwell_min;
+        }else if(dwell > sched->cfg.dwell_max){
+          dwell = sched->cfg.dwell_max;
+        }
+        sched->dwell = dwell;
+        sched->state = hc_08_sched_state_polling;
+        sched->state_tick = now;
+        sched->last_sample_tick = now;
+      }else if(now - sched->state_tick >= sched->cfg.connect_timeout){
+        slave->connect_fails++;
+        slave->retry += slave->retry < UINT8_MAX;
+        slave->last_visit = now;
+        sched->stats.connect_fails++;
+        sched->cb.disconnect(sched->hc_08, slave->addres, sched->cb.ctx);
+        sched->state = hc_08_sched_state_disconnecting;
+        sched->state_tick = now;
+      }
+      break;
+
+    case hc_08_sched_state_polling:
+      slave = &sched->slave[sched->current];
+      if(sched->hc_08->status_connect != hc_08_status_connected){
+        hc_08_sched_leave(sched, now);
+        break;
+      }
+      uint16_t samples = sched->cb.poll(sched->hc_08, slave->addres, sched->cb.ctx);
+      if(samples){
+        sched->visit_samples += samples;
+        sched->last_sample_tick = now;
+        slave->samples += samples;
+        sched->stats.samples += samples;
+        sched->stats.window_samples += samples;
+      }
+      if(now - sched->state_tick >= sched->dwell ||
+          now - sched->last_sample_tick >= sched->cfg.idle_gap){
+        hc_08_sched_leave(sched, now);
+      }
+      break;
+
+    case hc_08_sched_state_disconnecting:
+      if(sched->hc_08->status_connect == hc_08_status_not_connected ||
+          now - sched->state_tick >= sched->cfg.connect_timeout){
+        sched->state = hc_08_sched_state_select;
+      }
+      break;
+  }
+}
+
+/**
+  * @brief  Aggregate number of samples per second pulled from all slaves over the last
+  *         HC_08_SCHED_RATE_WINDOW
+  * @param  *sched pointer to the scheduler structure
+  */
+uint32_t hc_08_sched_samples_per_sec(hc_08_sched_ST *sched){
+  return sched->stats.samples_per_sec;
+}
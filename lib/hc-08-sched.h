@@ -0,0 +1,87 @@
+#ifndef HC_08_SCHED_H
+#define HC_08_SCHED_H
+
+#include "hc-08.h"
+
+#define HC_08_SCHED_MAX_SLAVES        16
+
+#define HC_08_SCHED_CONNECT_TIMEOUT   3000  // ms
+#define HC_08_SCHED_DWELL_MIN         50    // ms
+#define HC_08_SCHED_DWELL_MAX         2000  // ms
+#define HC_08_SCHED_IDLE_GAP          100   // ms without samples before leaving a slave
+#define HC_08_SCHED_MAX_AGE           30000 // ms, a slave is visited at least this often
+#define HC_08_SCHED_RATE_WINDOW       1000  // ms
+#define HC_08_SCHED_BACKOFF_MAX       4     // doublings of connect_timeout between retries of a failing slave
+
+#define HC_08_SCHED_NONE              0xFF  // no slave may be visited now
+
+typedef enum{
+  hc_08_sched_state_select,
+  hc_08_sched_state_connecting,
+  hc_08_sched_state_polling,
+  hc_08_sched_state_disconnecting
+}hc_08_sched_state;
+
+typedef struct{
+  uint8_t addres[6];
+  uint32_t last_visit;
+  uint32_t rate;            // samples per 1000 s produced by the slave (EWMA)
+  uint32_t reconnect_cost;  // ms from connect request to connected (EWMA)
+  uint32_t sample_cost;     // us spent per pulled sample (EWMA)
+  uint32_t samples;
+  uint16_t visits;
+  uint16_t connect_fails;
+  uint8_t retry;            // connects failed in a row, cleared by a visit
+}hc_08_sched_slave_ST;
+
+typedef struct{
+  hc_08_ST *hc_08;
+
+  hc_08_sched_slave_ST slave[HC_08_SCHED_MAX_SLAVES];
+  uint8_t slave_count;
+  uint8_t current;
+
+  hc_08_sched_state state;
+  uint32_t state_tick;
+  uint32_t visit_tick;
+  uint32_t last_sample_tick;
+  uint32_t dwell;
+  uint32_t visit_samples;
+
+  struct{
+    hc_08_status (*connect)(hc_08_ST *hc_08, const uint8_t *addres, void *ctx);
+    uint16_t (*poll)(hc_08_ST *hc_08, const uint8_t *addres, void *ctx);
+    void (*disconnect)(hc_08_ST *hc_08, const uint8_t *addres, void *ctx);
+    void *ctx;
+  }cb;
+
+  struct{
+    uint32_t connect_timeout;
+    uint32_t dwell_min;
+    uint32_t dwell_max;
+    uint32_t idle_gap;
+    uint32_t max_age;
+  }cfg;
+
+  struct{
+    uint32_t samples;
+    uint32_t visits;
+    uint32_t connect_fails;
+    uint32_t idle_passes;     // process calls with every slave waiting for its backoff
+    uint32_t window_start;
+    uint32_t window_samples;
+    uint32_t samples_per_sec;
+  }stats;
+}hc_08_sched_ST;
+
+void hc_08_sched_init(hc_08_sched_ST *sched, hc_08_ST *hc_08,
+                      hc_08_status (*connect)(hc_08_ST *hc_08, const uint8_t *addres, void *ctx),
+                      uint16_t (*poll)(hc_08_ST *hc_08, const uint8_t *addres, void *ctx),
+                      void (*disconnect)(hc_08_ST *hc_08, const uint8_t *addres, void *ctx),
+                      void *ctx);
+hc_08_status hc_08_sched_add_slave(hc_08_sched_ST *sched, const uint8_t *addres);
+hc_08_status hc_08_sched_remove_slave(hc_08_sched_ST *sched, const uint8_t *addres);
+void hc_08_sched_process(hc_08_sched_ST *sched);
+uint32_t hc_08_sched_samples_per_sec(hc_08_sched_ST *sched);
+
+#endif /* HC_08_SCHED_H */
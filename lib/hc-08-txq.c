@@ -0,0 +1,133 @@
+#include "hc-08-txq.h"
+#include <string.h>
+
+/*
+ * Every slot carries a sequence number. sequence == position: free for the producer that
+ * claims that position; sequence == position + 1: the message is written and can be
+ * drained. The drain sets it to position + number of slots, freeing the slot for the
+ * next round.
+ */
+
+/**
+  * @brief  Initialization of the transmit queue
+  * @param  *txq pointer to the queue structure
+  * @param  *hc_08 pointer to the HC-08 module structure, its UART is used only by the drain
+  * @param  *slots slots owned by the caller, valid as long as the queue is used
+  * @param  count number of slots, a power of two
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if count is not a power of two
+  */
+hc_08_status hc_08_txq_init(hc_08_txq_ST *txq, hc_08_ST *hc_08, hc_08_txq_slot_ST *slots, uint32_t count){
+  if(slots == NULL || count < 2 || (count & (count - 1)) != 0){
+    return hc_08_status_error;
+  }
+  memset(&txq->metrics, 0, sizeof(txq->metrics));
+  txq->hc_08 = hc_08;
+  txq->slots = slots;
+  txq->mask = count - 1;
+  txq->head = 0;
+  for(uint32_t i = 0; i < count; i++){
+    atomic_init(&slots[i].sequence, i);
+    slots[i].size = 0;
+  }
+  atomic_init(&txq->tail, 0);
+  atomic_init(&txq->full, 0);
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Queuing a message, from any thread. Never blocks
+  * @param  *txq pointer to the queue structure
+  * @param  *data message
+  * @param  size 1 to HC_08_TXQ_SLOT_SIZE bytes
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if the queue is full or the size is out of range
+  */
+hc_08_status hc_08_txq_push(hc_08_txq_ST *txq, const char *data, uint16_t size){
+  uint32_t position = (uint32_t)atomic_load_explicit(&txq->tail, memory_order_relaxed);
+  hc_08_txq_slot_ST *slot;
+
+  if(size == 0 || size > HC_08_TXQ_SLOT_SIZE){
+    return hc_08_status_error;
+  }
+  for(;;){
+    uint_fast32_t tail = position;
+    int32_t difference;
+
+    slot = &txq->slots[position & txq->mask];
+    difference = (int32_t)((uint32_t)atomic_load_explicit(&slot->sequence, memory_order_acquire) - position);
+    if(difference == 0){
+      if(atomic_compare_exchange_weak_explicit(&txq->tail, &tail, position + 1,
+                                               memory_order_relaxed, memory_order_relaxed)){
+        break;
+      }
+      position = (uint32_t)tail;
+    }else if(difference < 0){
+      // the slot still holds the message of the previous round
+      atomic_fetch_add_explicit(&txq->full, 1, memory_order_relaxed);
+      return hc_08_status_error;
+    }else{
+      position = (uint32_t)atomic_load_explicit(&txq->tail, memory_order_relaxed);
+    }
+  }
+
+  memcpy(slot->data, data, size);
+  slot->size = size;
+  atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Sending the waiting messages, from the I/O thread only. The messages that fit buff
+  *         are copied into it in order and sent with one hc_08_uart_tx(...) call
+  * @param  *txq pointer to the queue structure
+  * @param  *buff batch buffer, at least HC_08_TXQ_SLOT_SIZE bytes
+  * @param  size buffer size
+  * @retval number of bytes sent, 0 if nothing was waiting
+  */
+uint32_t hc_08_txq_drain(hc_08_txq_ST *txq, char *buff, uint32_t size){
+  uint32_t length = 0;
+  uint32_t messages = 0;
+
+  for(;;){
+    hc_08_txq_slot_ST *slot = &txq->slots[txq->head & txq->mask];
+
+    if((uint32_t)atomic_load_explicit(&slot->sequence, memory_order_acquire) != txq->head + 1 ||
+        slot->size > size - length){
+      break;
+    }
+    memcpy(buff + length, slot->data, slot->size);
+    length += slot->size;
+    messages++;
+    atomic_store_explicit(&slot->sequence, txq->head + txq->mask + 1, memory_order_release);
+    txq->head++;
+  }
+  if(messages == 0){
+    return 0;
+  }
+
+  // hc_08_uart_tx takes at most 0xFFFF bytes
+  for(uint32_t sent = 0; sent < length; sent += 0xFFFF){
+    uint32_t part = length - sent < 0xFFFF ? length - sent : 0xFFFF;
+
+    hc_08_uart_tx(txq->hc_08, buff + sent, (uint16_t)part);
+  }
+  txq->metrics.drains++;
+  txq->metrics.messages += messages;
+  txq->metrics.bytes += length;
+  if(messages > txq->metrics.batch_max){
+    txq->metrics.batch_max = messages;
+  }
+  return length;
+}
+
+/**
+  * @brief  Number of claimed slots that were not drained yet (including messages still
+  *         being written). Exact only in the I/O thread
+  * @param  *txq pointer to the queue structure
+  */
+uint32_t hc_08_txq_pending(hc_08_txq_ST *txq){
+  return (uint32_t)atomic_load_explicit(&txq->tail, memory_order_relaxed) - txq->head;
+}
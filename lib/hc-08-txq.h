@@ -0,0 +1,48 @@
+#ifndef HC_08_TXQ_H
+#define HC_08_TXQ_H
+
+#include "hc-08.h"
+#include <stdatomic.h>
+
+#ifndef HC_08_TXQ_SLOT_SIZE
+#define HC_08_TXQ_SLOT_SIZE   0x40   // longest message, a longer one must be split by the producer
+#endif
+
+typedef struct{
+  atomic_uint_fast32_t sequence;
+  uint16_t size;
+  char data[HC_08_TXQ_SLOT_SIZE];
+}hc_08_txq_slot_ST;
+
+/*
+ * Bounded lock-free transmit queue: any number of threads push messages, one I/O thread
+ * owns the UART of the module and drains them. A push claims a slot with one
+ * compare-and-swap and never waits for the other producers or for the UART; a message
+ * is sent whole and messages of one producer keep their order. The drain copies all
+ * waiting messages that fit its buffer and hands them to hc_08_uart_tx(...) at once, so
+ * a Linux port writes a whole batch with one syscall.
+ * The slots are owned by the caller, their number must be a power of two.
+ */
+typedef struct{
+  hc_08_ST *hc_08;
+  hc_08_txq_slot_ST *slots;
+  uint32_t mask;
+
+  _Alignas(64) atomic_uint_fast32_t tail;   // next slot to claim, shared by the producers
+  atomic_uint_fast32_t full;                // pushes refused because the queue was full
+
+  _Alignas(64) uint32_t head;               // next slot to drain, owned by the I/O thread
+  struct{
+    uint32_t drains;                        // hc_08_uart_tx calls
+    uint32_t messages;
+    uint32_t bytes;
+    uint32_t batch_max;                     // most messages in one call
+  }metrics;
+}hc_08_txq_ST;
+
+hc_08_status hc_08_txq_init(hc_08_txq_ST *txq, hc_08_ST *hc_08, hc_08_txq_slot_ST *slots, uint32_t count);
+hc_08_status hc_08_txq_push(hc_08_txq_ST *txq, const char *data, uint16_t size);
+uint32_t hc_08_txq_drain(hc_08_txq_ST *txq, char *buff, uint32_t size);
+uint32_t hc_08_txq_pending(hc_08_txq_ST *txq);
+
+#endif /* HC_08_TXQ_H */
@@ -2,6 +2,73 @@
 #include <string.h>
 #include <stdio.h>
 
+/**
+  * @brief  Pointing the buffers at the storage embedded in hc_08_ST. Everything that was in
+  *         the buffer fields before is overwritten, so the structure does not have to be zeroed.
+  *         A buffer that is left out of hc_08_ST (size 0) is set to NULL
+  * @param  *hc_08 pointer to the HC-08 module structure
+  */
+static void hc_08_default_buffers(hc_08_ST *hc_08){
+#if HC_08_BUFF_RX_SIZE > 0
+  hc_08->uart.buff_rx = hc_08->uart.storage_rx;
+  hc_08->uart.rx_capacity = HC_08_BUFF_RX_SIZE;
+#else
+  hc_08->uart.buff_rx = NULL;
+  hc_08->uart.rx_capacity = 0;
+#endif
+#if HC_08_BUFF_TX_SIZE > 0
+  hc_08->uart.buff_tx = hc_08->uart.storage_tx;
+  hc_08->uart.tx_capacity = HC_08_BUFF_TX_SIZE;
+#else
+  hc_08->uart.buff_tx = NULL;
+  hc_08->uart.tx_capacity = 0;
+#endif
+  hc_08->uart.rx_size = 0;
+}
+
+/**
+  * @brief  Giving the module receive and transmit buffers owned by the caller, e.g. a larger
+  *         receive buffer for AT+RX or a small one for a data-only module. Without this call
+  *         the buffers embedded in hc_08_ST are used. Registering the UART functions selects
+  *         the embedded buffers again, so this function is called after the registration.
+  *         The buffers must stay valid as long as the module structure is used, and the
+  *         structure must not be copied
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  *buff_rx receive buffer, NULL for the embedded one
+  * @param  rx_size size of buff_rx
+  * @param  *buff_tx transmit buffer, NULL for the embedded one
+  * @param  tx_size size of buff_tx, at least HC_08_BUFF_TX_MIN
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if a buffer is too small, or NULL while the embedded one is left out
+  */
+hc_08_status hc_08_init_buffers(hc_08_ST *hc_08, char *buff_rx, uint16_t rx_size, char *buff_tx, uint16_t tx_size){
+  if((buff_rx != NULL && rx_size == 0) || (buff_tx != NULL && tx_size < HC_08_BUFF_TX_MIN)){
+    return hc_08_status_error;
+  }
+#if HC_08_BUFF_RX_SIZE == 0
+  if(buff_rx == NULL){
+    return hc_08_status_error;
+  }
+#endif
+#if HC_08_BUFF_TX_SIZE < HC_08_BUFF_TX_MIN
+  if(buff_tx == NULL){
+    return hc_08_status_error;
+  }
+#endif
+
+  hc_08_default_buffers(hc_08);
+  if(buff_rx != NULL){
+    hc_08->uart.buff_rx = buff_rx;
+    hc_08->uart.rx_capacity = rx_size;
+  }
+  if(buff_tx != NULL){
+    hc_08->uart.buff_tx = buff_tx;
+    hc_08->uart.tx_capacity = tx_size;
+  }
+  return hc_08_status_ok;
+}
+
 /**
 * @brief Binding data transfer functions using UART to the structure of the BLE module
    * @param *hc_08 pointer to the HC-08 module structure
@@ -17,15 +84,100 @@ void hc_08_reg_uart_cbfunc(hc_08_ST *hc_08,
                             void (*uart_rx)(char *buff, uint16_t size)){
   hc_08->uart.tx = uart_tx;
   hc_08->uart.rx = uart_rx;
+  hc_08->uart.tx_ctx = NULL;
+  hc_08->uart.rx_ctx = NULL;
+  hc_08->uart.ctx = NULL;
+  hc_08_default_buffers(hc_08);
+}
+
+/**
+* @brief Binding data transfer functions that take a user context to the structure of the BLE module.
+*        Used when several modules share one pair of functions (one port driver, an emulator, etc.)
+   * @param *hc_08 pointer to the HC-08 module structure
+   * @param void (*uart_tx)(void *ctx, char *buff, uint16_t size) function to send data via UART
+   * @param uint16_t (*uart_rx)(void *ctx, char *buff, uint16_t size) function to receive data using UART.
+               Returns the number of bytes actually received
+   * @param *ctx user pointer passed to both functions
+  */
+void hc_08_reg_uart_cbfunc_ctx(hc_08_ST *hc_08,
+                            void (*uart_tx)(void *ctx, char *buff, uint16_t size), 
+                            uint16_t (*uart_rx)(void *ctx, char *buff, uint16_t size),
+                            void *ctx){
+  hc_08->uart.tx = NULL;
+  hc_08->uart.rx = NULL;
+  hc_08->uart.tx_ctx = uart_tx;
+  hc_08->uart.rx_ctx = uart_rx;
+  hc_08->uart.ctx = ctx;
+  hc_08_default_buffers(hc_08);
+}
+
+/**
+  * @brief  Sending data to the module through the registered UART function
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  *buff pointer to the buffer with the data to be transferred
+  * @param  size number of bytes of data to be transferred
+  */
+void hc_08_uart_tx(hc_08_ST *hc_08, char *buff, uint16_t size){
+  hc_08->stats.tx_bytes += size;
+  if(hc_08->uart.tx_ctx != NULL){
+    hc_08->uart.tx_ctx(hc_08->uart.ctx, buff, size);
+  }else{
+    hc_08->uart.tx(buff, size);
+  }
+}
+
+/**
+  * @brief  Binding the millisecond tick source used for timeouts and statistics
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  uint32_t (*get_tick)(void) function returning a free-running millisecond counter
+  *           (HAL_GetTick for STM32 HAL)
+  */
+void hc_08_reg_tick_cbfunc(hc_08_ST *hc_08, uint32_t (*get_tick)(void)){
+  hc_08->get_tick = get_tick;
+}
+
+/**
+  * @brief  Current value of the registered tick source
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @retval milliseconds, 0 if no tick source is registered
+  */
+uint32_t hc_08_get_tick(hc_08_ST *hc_08){
+  if(hc_08->get_tick == NULL){
+    return 0;
+  }
+  return hc_08->get_tick();
 }
 
 /**
-  * @brief  Reading the response from the HC-08 module
+  * @brief  Reading the response from the HC-08 module. A receive function registered with
+  *         hc_08_reg_uart_cbfunc(...) does not report a size: the buffer is cleared before
+  *         it is called, so the parsers stop at the end of the new answer (the first NUL)
+  *         and no earlier answer is left to be parsed again
   * @param  *hc_08 pointer to the HC-08 module structure
   */
 void hc_08_read_answer(hc_08_ST *hc_08){
-	hc_08->uart.rx(hc_08->uart.buff_rx, 
-						HC_08_BUFF_RX_SIZE);
+  if(hc_08->uart.rx_ctx != NULL){
+    hc_08->uart.rx_size = hc_08->uart.rx_ctx(hc_08->uart.ctx, hc_08->uart.buff_rx, 
+                                              hc_08->uart.rx_capacity);
+    hc_08->stats.rx_bytes += hc_08->uart.rx_size;
+  }else{
+    memset(hc_08->uart.buff_rx, 0, hc_08->uart.rx_capacity);
+    hc_08->uart.rx(hc_08->uart.buff_rx, 
+                    hc_08->uart.rx_capacity);
+    hc_08->uart.rx_size = hc_08->uart.rx_capacity;
+    hc_08->stats.rx_bytes += hc_08_rx_received(hc_08);
+  }
+}
+
+/**
+  * @brief  Recording the size of an answer received outside of hc_08_read_answer(...),
+  *         e.g. from the idle-line interrupt of a DMA reception (HAL_UARTEx_RxEventCallback)
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  size number of bytes written to hc_08->uart.buff_rx
+  */
+void hc_08_rx_complete(hc_08_ST *hc_08, uint16_t size){
+  hc_08->uart.rx_size = size < hc_08->uart.rx_capacity ? size : hc_08->uart.rx_capacity;
+  hc_08->stats.rx_bytes += hc_08->uart.rx_size;
 }
 
 /**
@@ -33,9 +185,9 @@ void hc_08_read_answer(hc_08_ST *hc_08){
   * @param  *hc_08 pointer to the HC-08 module structure
   */
 void hc_08_cmd_at(hc_08_ST *hc_08){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s", HC_08_COMMAND_AT);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s", HC_08_COMMAND_AT);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -43,9 +195,9 @@ void hc_08_cmd_at(hc_08_ST *hc_08){
   * @param  *hc_08 pointer to the HC-08 module structure
   */
 void hc_08_cmd_rx(hc_08_ST *hc_08){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s", HC_08_COMMAND_RX); 
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s", HC_08_COMMAND_RX); 
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -53,9 +205,10 @@ void hc_08_cmd_rx(hc_08_ST *hc_08){
   * @param  *hc_08 pointer to the HC-08 module structure
   */
 void hc_08_cmd_default(hc_08_ST *hc_08){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s", HC_08_COMMAND_DEFAULT);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s", HC_08_COMMAND_DEFAULT);
 
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08->param_valid = 0;
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -63,9 +216,9 @@ void hc_08_cmd_default(hc_08_ST *hc_08){
   * @param  *hc_08 pointer to the HC-08 module structure
   */
 void hc_08_cmd_reset(hc_08_ST *hc_08){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s", HC_08_COMMAND_RESET);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s", HC_08_COMMAND_RESET);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -73,9 +226,9 @@ void hc_08_cmd_reset(hc_08_ST *hc_08){
   * @param  *hc_08 pointer to the HC-08 module structure
   */
 void hc_08_cmd_version(hc_08_ST *hc_08){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s", HC_08_COMMAND_VERSION);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s", HC_08_COMMAND_VERSION);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -86,9 +239,10 @@ void hc_08_cmd_version(hc_08_ST *hc_08){
               hc_08_role_slave  
   */
 void hc_08_cmd_set_role(hc_08_ST *hc_08, hc_08_role role){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%s", HC_08_COMMAND_ROLE, hc_08_role_c[role]);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%s", HC_08_COMMAND_ROLE, hc_08_role_c[role]);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_param_invalidate(hc_08, hc_08_field_role);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -96,19 +250,31 @@ void hc_08_cmd_set_role(hc_08_ST *hc_08, hc_08_role role){
   * @param  *hc_08 pointer to the HC-08 module structure
   */
 void hc_08_cmd_ask_role(hc_08_ST *hc_08){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%s", HC_08_COMMAND_ROLE, HC_08_TEXT_QUERY);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%s", HC_08_COMMAND_ROLE, HC_08_TEXT_QUERY);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
-  * @brief  Specifying a new name for the module (no more than 12 characters)
+  * @brief  Specifying a new name for the module
   * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  *name the new name, 1 to HC_08_MAX_NAME_LENGHT characters
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if the name is empty or too long, nothing is sent
   */
-void hc_08_cmd_set_name(hc_08_ST *hc_08, char *name){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%s", HC_08_COMMAND_NAME, name);
+hc_08_status hc_08_cmd_set_name(hc_08_ST *hc_08, char *name){
+  const char *end = memchr(name, '\0', HC_08_MAX_NAME_LENGHT + 1);
+  uint8_t size;
+
+  if(end == NULL || end == name){
+    return hc_08_status_error;
+  }
+  size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%s", HC_08_COMMAND_NAME, name);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_param_invalidate(hc_08, hc_08_field_name);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
+  return hc_08_status_ok;
 }
 
 /**
@@ -116,9 +282,9 @@ void hc_08_cmd_set_name(hc_08_ST *hc_08, char *name){
   * @param  *hc_08 pointer to the HC-08 module structure
   */
 void hc_08_cmd_ask_name(hc_08_ST *hc_08){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%s", HC_08_COMMAND_NAME, HC_08_TEXT_QUERY);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%s", HC_08_COMMAND_NAME, HC_08_TEXT_QUERY);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -127,14 +293,12 @@ void hc_08_cmd_ask_name(hc_08_ST *hc_08){
   * @param  address вказівник на адресу (масив з 6 байт)
   */
 void hc_08_cmd_set_address(hc_08_ST *hc_08, uint8_t* address){
-  strcpy((hc_08->uart.buff_tx), HC_08_COMMAND_ADDR);
-  
-  for(uint8_t i = 0; i < sizeof(hc_08->param.addres); i++){
-    sprintf(&hc_08->uart.buff_tx[strlen(HC_08_COMMAND_ADDR) + i * 2], "%x", (unsigned int) address[i]);
-  }
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%02X%02X%02X%02X%02X%02X", HC_08_COMMAND_ADDR,
+                          (unsigned int) address[0], (unsigned int) address[1], (unsigned int) address[2],
+                          (unsigned int) address[3], (unsigned int) address[4], (unsigned int) address[5]);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, 
-                      strlen(HC_08_COMMAND_ADDR) + HC_08_ADDRES_LENGHT);
+  hc_08_param_invalidate(hc_08, hc_08_field_address);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -142,9 +306,9 @@ void hc_08_cmd_set_address(hc_08_ST *hc_08, uint8_t* address){
   * @param  *hc_08 pointer to the HC-08 module structure
   */
 void hc_08_cmd_ask_address(hc_08_ST *hc_08){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%s", HC_08_COMMAND_ADDR, HC_08_TEXT_QUERY);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%s", HC_08_COMMAND_ADDR, HC_08_TEXT_QUERY);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -157,9 +321,10 @@ void hc_08_cmd_ask_address(hc_08_ST *hc_08){
               hc_08_rfpm_m23dBm
   */
 void hc_08_cmd_set_rf_power(hc_08_ST *hc_08, hc_08_rfpm rfpm){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%s", HC_08_COMMAND_RFPM, hc_08_rfpm_param_c[rfpm]);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%s", HC_08_COMMAND_RFPM, hc_08_rfpm_param_c[rfpm]);
 
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_param_invalidate(hc_08, hc_08_field_rfpm);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -167,9 +332,9 @@ void hc_08_cmd_set_rf_power(hc_08_ST *hc_08, hc_08_rfpm rfpm){
   * @param  *hc_08 pointer to the HC-08 module structure
   */
 void hc_08_cmd_ask_rf_power(hc_08_ST *hc_08){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%s", HC_08_COMMAND_RFPM, HC_08_TEXT_QUERY);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%s", HC_08_COMMAND_RFPM, HC_08_TEXT_QUERY);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -186,9 +351,10 @@ void hc_08_cmd_ask_rf_power(hc_08_ST *hc_08){
                 hc_08_baud_115200bps
   */
 void hc_08_cmd_set_uart_baud(hc_08_ST *hc_08, hc_08_baud baud){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%s", HC_08_COMMAND_BAUD, hc_08_baud_c[baud]);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%s", HC_08_COMMAND_BAUD, hc_08_baud_c[baud]);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_param_invalidate(hc_08, hc_08_field_baud);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -209,11 +375,12 @@ void hc_08_cmd_set_uart_baud(hc_08_ST *hc_08, hc_08_baud baud){
                 hc_08_parity_bit_odd_parity
   */
 void hc_08_cmd_set_uart_baud_parity(hc_08_ST *hc_08, hc_08_baud baud, hc_08_parity_bit parity_bit){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%s%s%s", HC_08_COMMAND_BAUD, 
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%s%s%s", HC_08_COMMAND_BAUD, 
                           hc_08_baud_c[baud], HC_08_TEXT_COMMA, 
                           hc_08_parity_bit_c[parity_bit]);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_param_invalidate(hc_08, hc_08_field_baud);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -221,9 +388,9 @@ void hc_08_cmd_set_uart_baud_parity(hc_08_ST *hc_08, hc_08_baud baud, hc_08_pari
   * @param  *hc_08 pointer to the HC-08 module structure
   */
 void hc_08_cmd_ask_uart_baud_parity(hc_08_ST *hc_08){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%s", HC_08_COMMAND_BAUD, HC_08_TEXT_QUERY);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%s", HC_08_COMMAND_BAUD, HC_08_TEXT_QUERY);
 
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -234,9 +401,10 @@ void hc_08_cmd_ask_uart_baud_parity(hc_08_ST *hc_08){
               hc_08_cont_1
   */
 void hc_08_cmd_set_cont(hc_08_ST *hc_08, hc_08_cont cont){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%s", HC_08_COMMAND_CONT, hc_08_cont_c[cont]);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%s", HC_08_COMMAND_CONT, hc_08_cont_param_c[cont]);
 
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_param_invalidate(hc_08, hc_08_field_cont);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -244,19 +412,30 @@ void hc_08_cmd_set_cont(hc_08_ST *hc_08, hc_08_cont cont){
   * @param  *hc_08 pointer to the HC-08 module structure
   */
 void hc_08_cmd_ask_rfpm(hc_08_ST *hc_08){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%s", HC_08_COMMAND_CONT, HC_08_TEXT_QUERY);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%s", HC_08_COMMAND_CONT, HC_08_TEXT_QUERY);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
   * @brief  Change the broadcast data
   * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  *avda broadcast data, 1 to HC_08_AVDA_MAX_LENGHT characters
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if the data is empty or too long, nothing is sent
   */
-void hc_08_cmd_set_avda(hc_08_ST *hc_08, char *avda){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%s", HC_08_COMMAND_AVDA, avda);
+hc_08_status hc_08_cmd_set_avda(hc_08_ST *hc_08, char *avda){
+  const char *end = memchr(avda, '\0', HC_08_AVDA_MAX_LENGHT + 1);
+  uint8_t size;
+
+  if(end == NULL || end == avda){
+    return hc_08_status_error;
+  }
+  size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%s", HC_08_COMMAND_AVDA, avda);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
+  return hc_08_status_ok;
 }
 
 /**
@@ -268,9 +447,10 @@ void hc_08_cmd_set_avda(hc_08_ST *hc_08, char *avda){
               hc_08_mode_level_2
   */
 void hc_08_cmd_set_mode(hc_08_ST *hc_08, hc_08_mode mode){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%s", HC_08_COMMAND_MODE, hc_08_mode_c[mode]);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%s", HC_08_COMMAND_MODE, hc_08_mode_c[mode]);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_param_invalidate(hc_08, hc_08_field_mode);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -278,9 +458,9 @@ void hc_08_cmd_set_mode(hc_08_ST *hc_08, hc_08_mode mode){
   * @param  *hc_08 pointer to the HC-08 module structure
   */
 void hc_08_cmd_ask_mode(hc_08_ST *hc_08){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%s", HC_08_COMMAND_MODE, HC_08_TEXT_QUERY);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%s", HC_08_COMMAND_MODE, HC_08_TEXT_QUERY);
 
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -293,9 +473,10 @@ void hc_08_cmd_ask_mode(hc_08_ST *hc_08){
   */
 hc_08_status hc_08_cmd_set_aint(hc_08_ST *hc_08, uint16_t value){
   if(value >= HC_08_AINT_MIN && value <= HC_08_AINT_MAX){
-    uint8_t size = sprintf(&hc_08->uart.buff_tx[strlen(HC_08_COMMAND_AINT)], "%s%d", HC_08_COMMAND_AINT, (unsigned int) value);
+    uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%d", HC_08_COMMAND_AINT, (unsigned int) value);
   
-    hc_08->uart.tx(hc_08->uart.buff_tx, size);
+    hc_08_param_invalidate(hc_08, hc_08_field_aint);
+    hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
   }else{
     return hc_08_status_error;
   }
@@ -307,9 +488,9 @@ hc_08_status hc_08_cmd_set_aint(hc_08_ST *hc_08, uint16_t value){
   * @param  *hc_08 pointer to the HC-08 module structure 
 */
 void hc_08_cmd_ask_aint(hc_08_ST *hc_08){
-  uint8_t size = sprintf(&hc_08->uart.buff_tx[strlen(HC_08_COMMAND_AINT)], "%s%s", HC_08_COMMAND_AINT, HC_08_TEXT_QUERY);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%s", HC_08_COMMAND_AINT, HC_08_TEXT_QUERY);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -322,9 +503,10 @@ void hc_08_cmd_ask_aint(hc_08_ST *hc_08){
   */
 hc_08_status hc_08_cmd_set_cint(hc_08_ST *hc_08, uint16_t time){
   if(time >= HC_08_CINT_MIN && time <= HC_08_CINT_MAX){
-    uint8_t size = sprintf(&hc_08->uart.buff_tx[strlen(HC_08_COMMAND_CINT)], "%s%d", HC_08_COMMAND_CINT, (unsigned int) time);
+    uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%d", HC_08_COMMAND_CINT, (unsigned int) time);
   
-    hc_08->uart.tx(hc_08->uart.buff_tx, size);
+    hc_08_param_invalidate(hc_08, hc_08_field_cint);
+    hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
   }else{
     return hc_08_status_error;
   }
@@ -342,18 +524,14 @@ hc_08_status hc_08_cmd_set_cint(hc_08_ST *hc_08, uint16_t time){
   *             hc_08_status_error
   */
 hc_08_status hc_08_cmd_set_cint_min_max(hc_08_ST *hc_08, uint16_t time_min, uint16_t time_max){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%d%s%d", HC_08_COMMAND_CINT, 
-                        (unsigned int) time_min, HC_08_TEXT_COMMA, (unsigned int)time_max);
-  
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
-  
   if(time_min >= HC_08_CINT_MIN && time_min <= HC_08_CINT_MAX &&
       time_max >= HC_08_CINT_MIN && time_max <= HC_08_CINT_MAX &&
       time_min <= time_max){
-    uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%d%s%d", HC_08_COMMAND_CINT, 
+    uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%d%s%d", HC_08_COMMAND_CINT, 
                         (unsigned int) time_min, HC_08_TEXT_COMMA, (unsigned int)time_max);
   
-    hc_08->uart.tx(hc_08->uart.buff_tx, size);
+    hc_08_param_invalidate(hc_08, hc_08_field_cint);
+    hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
   }else{
     return hc_08_status_error;
   }
@@ -366,9 +544,9 @@ hc_08_status hc_08_cmd_set_cint_min_max(hc_08_ST *hc_08, uint16_t time_min, uint
   * @param  *hc_08 pointer to the HC-08 module structure 
 */
 void hc_08_cmd_ask_cint_min_max(hc_08_ST *hc_08){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%s", HC_08_COMMAND_CINT, HC_08_TEXT_QUERY);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%s", HC_08_COMMAND_CINT, HC_08_TEXT_QUERY);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -380,9 +558,10 @@ void hc_08_cmd_ask_cint_min_max(hc_08_ST *hc_08){
   *             hc_08_status_error
   */
 hc_08_status hc_08_cmd_set_ctout(hc_08_ST *hc_08, uint16_t time){
-  if(time >= HC_08_CTOUT_MIN && time <= HC_08_CTOUT_MIN){
-    uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%d", HC_08_COMMAND_CTOUT, time);  
-    hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  if(time >= HC_08_CTOUT_MIN && time <= HC_08_CTOUT_MAX){
+    uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%d", HC_08_COMMAND_CTOUT, time);  
+    hc_08_param_invalidate(hc_08, hc_08_field_ctout);
+    hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
   }else{
     return hc_08_status_error;
   }
@@ -395,9 +574,9 @@ hc_08_status hc_08_cmd_set_ctout(hc_08_ST *hc_08, uint16_t time){
   * @param  *hc_08 pointer to the HC-08 module structure 
 */
 void hc_08_cmd_ask_ctout(hc_08_ST *hc_08){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%s", HC_08_COMMAND_CTOUT, HC_08_TEXT_QUERY);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%s", HC_08_COMMAND_CTOUT, HC_08_TEXT_QUERY);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -405,9 +584,9 @@ void hc_08_cmd_ask_ctout(hc_08_ST *hc_08){
   * @param  *hc_08 pointer to the HC-08 module structure
   */
 void hc_08_cmd_clear(hc_08_ST *hc_08){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s", HC_08_COMMAND_CLEAR);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s", HC_08_COMMAND_CLEAR);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -418,9 +597,10 @@ void hc_08_cmd_clear(hc_08_ST *hc_08){
   *           hc_08_led_off
   */
 void hc_08_cmd_set_led(hc_08_ST *hc_08, hc_08_led status){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%s", HC_08_COMMAND_LED, hc_08_led_c[status]);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%s", HC_08_COMMAND_LED, hc_08_led_c[status]);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_param_invalidate(hc_08, hc_08_field_led);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -428,9 +608,9 @@ void hc_08_cmd_set_led(hc_08_ST *hc_08, hc_08_led status){
   * @param  *hc_08 pointer to the HC-08 module structure 
 */
 void hc_08_cmd_ask_led(hc_08_ST *hc_08){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%s", HC_08_COMMAND_LED, HC_08_TEXT_QUERY);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%s", HC_08_COMMAND_LED, HC_08_TEXT_QUERY);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -439,9 +619,10 @@ void hc_08_cmd_ask_led(hc_08_ST *hc_08){
   * @param  value range of the Search UUID is 0~0xffff
   */
 void hc_08_cmd_set_luuid(hc_08_ST *hc_08, uint16_t value){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%d", HC_08_COMMAND_LUUID, value);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%04X", HC_08_COMMAND_LUUID, (unsigned int) value);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_param_invalidate(hc_08, hc_08_field_luuid);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -449,9 +630,9 @@ void hc_08_cmd_set_luuid(hc_08_ST *hc_08, uint16_t value){
   * @param  *hc_08 pointer to the HC-08 module structure 
 */
 void hc_08_cmd_ask_luuid(hc_08_ST *hc_08){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%s", HC_08_COMMAND_LUUID, HC_08_TEXT_QUERY);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%s", HC_08_COMMAND_LUUID, HC_08_TEXT_QUERY);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -460,9 +641,10 @@ void hc_08_cmd_ask_luuid(hc_08_ST *hc_08){
   * @param  value range of the Service UUID is 0~0xffff
   */
 void hc_08_cmd_set_suuid(hc_08_ST *hc_08, uint16_t value){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%d", HC_08_COMMAND_SUUID, value);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%04X", HC_08_COMMAND_SUUID, (unsigned int) value);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_param_invalidate(hc_08, hc_08_field_suuid);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -470,9 +652,9 @@ void hc_08_cmd_set_suuid(hc_08_ST *hc_08, uint16_t value){
   * @param  *hc_08 pointer to the HC-08 module structure 
 */
 void hc_08_cmd_ask_suuid(hc_08_ST *hc_08){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%s", HC_08_COMMAND_SUUID, HC_08_TEXT_QUERY);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%s", HC_08_COMMAND_SUUID, HC_08_TEXT_QUERY);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -481,9 +663,10 @@ void hc_08_cmd_ask_suuid(hc_08_ST *hc_08){
   * @param  value range of the Characteristic UUID is 0~0xffff
   */
 void hc_08_cmd_set_tuuid(hc_08_ST *hc_08, uint16_t value){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%d", HC_08_COMMAND_TUUID, value);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%04X", HC_08_COMMAND_TUUID, (unsigned int) value);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_param_invalidate(hc_08, hc_08_field_tuuid);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -491,9 +674,9 @@ void hc_08_cmd_set_tuuid(hc_08_ST *hc_08, uint16_t value){
   * @param  *hc_08 pointer to the HC-08 module structure 
 */
 void hc_08_cmd_ask_tuuid(hc_08_ST *hc_08){
-  uint8_t size = sprintf(hc_08->uart.buff_tx, "%s%s", HC_08_COMMAND_TUUID, HC_08_TEXT_QUERY);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%s", HC_08_COMMAND_TUUID, HC_08_TEXT_QUERY);
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
 }
 
 /**
@@ -506,9 +689,10 @@ void hc_08_cmd_ask_tuuid(hc_08_ST *hc_08){
   */
 hc_08_status hc_08_cmd_set_aust(hc_08_ST *hc_08, uint16_t value){
   if(value >= HC_08_AUST_MIN && value <= HC_08_AUST_MAX){
-    uint8_t size = sprintf(&hc_08->uart.buff_tx[strlen(HC_08_COMMAND_AINT)], "%s%d", HC_08_COMMAND_AINT, (unsigned int) value);
+    uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%d", HC_08_COMMAND_AUST, (unsigned int) value);
   
-    hc_08->uart.tx(hc_08->uart.buff_tx, size);
+    hc_08_param_invalidate(hc_08, hc_08_field_aust);
+    hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
   }else{
     return hc_08_status_error;
   }
@@ -521,9 +705,418 @@ hc_08_status hc_08_cmd_set_aust(hc_08_ST *hc_08, uint16_t value){
   * @param  *hc_08 pointer to the HC-08 module structure 
 */
 void hc_08_cmd_ask_aust(hc_08_ST *hc_08){
-  uint8_t size = sprintf(&hc_08->uart.buff_tx[strlen(HC_08_COMMAND_AINT)], "%s%s", HC_08_COMMAND_AINT, HC_08_TEXT_QUERY);
+  uint8_t size = snprintf(hc_08->uart.buff_tx, hc_08->uart.tx_capacity, "%s%s", HC_08_COMMAND_AUST, HC_08_TEXT_QUERY);
+  
+  hc_08_uart_tx(hc_08, hc_08->uart.buff_tx, size);
+}
+
+/**
+  * @brief  Length of the received answer that the parsers may look at: the smaller of the
+  *         size given by the caller and the size reported by the UART function, cut at the
+  *         first NUL byte left by a legacy receive function
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  size the size given by the caller
+  */
+static uint16_t hc_08_rx_length(hc_08_ST *hc_08, uint16_t size){
+  uint16_t length = hc_08->uart.rx_size;
+  const char *end;
+
+  if(size < length){
+    length = size;
+  }
+  if(length > hc_08->uart.rx_capacity){
+    length = hc_08->uart.rx_capacity;
+  }
+  end = memchr(hc_08->uart.buff_rx, '\0', length);
+  if(end != NULL){
+    length = end - hc_08->uart.buff_rx;
+  }
+  return length;
+}
+
+/**
+  * @brief  Number of bytes of the last answer, as the parsers see them. With a receive
+  *         function registered by hc_08_reg_uart_cbfunc(...) these are the bytes before
+  *         the first NUL, so 0 means that nothing was received
+  * @param  *hc_08 pointer to the HC-08 module structure
+  */
+uint16_t hc_08_rx_received(hc_08_ST *hc_08){
+  return hc_08_rx_length(hc_08, HC_08_RX_ALL);
+}
+
+/**
+  * @brief  Searching for a text inside a view without relying on a NUL terminator
+  * @param  *view pointer to the view
+  * @param  *text NUL terminated text to search for
+  * @retval pointer to the first match, NULL if not found
+  */
+const char *hc_08_view_search(const hc_08_view *view, const char *text){
+  uint16_t text_size = strlen(text);
+  const char *pos = view->data;
+  const char *end = view->data + view->size;
+
+  if(text_size == 0 || text_size > view->size){
+    return NULL;
+  }
+  while((pos = memchr(pos, text[0], (end - pos) - text_size + 1)) != NULL){
+    if(memcmp(pos, text, text_size) == 0){
+      return pos;
+    }
+    pos++;
+    if(end - pos < text_size){
+      break;
+    }
+  }
+  return NULL;
+}
+
+/**
+  * @brief  Cutting a view at the first CR or LF and dropping leading CR, LF and spaces
+  * @param  *view pointer to the view
+  */
+static void hc_08_view_line(hc_08_view *view){
+  while(view->size && (view->data[0] == '\r' || view->data[0] == '\n' || view->data[0] == ' ')){
+    view->data++;
+    view->size--;
+  }
+  for(uint16_t i = 0; i < view->size; i++){
+    if(view->data[i] == '\r' || view->data[i] == '\n'){
+      view->size = i;
+      break;
+    }
+  }
+}
+
+/**
+  * @brief  Splitting a view at the first occurrence of a character
+  * @param  *view pointer to the view, cut before the character
+  * @param  c separator
+  * @param  *rest pointer to the view that receives the part after the separator
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if the separator is missing
+  */
+static hc_08_status hc_08_view_split(hc_08_view *view, char c, hc_08_view *rest){
+  const char *pos = memchr(view->data, c, view->size);
+
+  if(pos == NULL){
+    return hc_08_status_error;
+  }
+  rest->data = pos + 1;
+  rest->size = view->size - (pos - view->data) - 1;
+  view->size = pos - view->data;
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  View of the answer that is currently in the receive buffer
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  size the size of received data. Actual is preferred, HC_08_RX_ALL takes everything received
+  */
+hc_08_view hc_08_view_rx(hc_08_ST *hc_08, uint16_t size){
+  hc_08_view view = {hc_08->uart.buff_rx, hc_08_rx_length(hc_08, size)};
   
-  hc_08->uart.tx(hc_08->uart.buff_tx, size);
+  return view;
+}
+
+/**
+  * @brief  View of the value in an answer like "KEY=value" or "KEY:value". If the answer has no
+  *         '=' or ':' the whole first line is the value
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  size the size of received data. Actual is preferred, HC_08_RX_ALL takes everything received
+  * @param  *value pointer to the view to fill
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if the value is empty
+  */
+hc_08_status hc_08_view_value(hc_08_ST *hc_08, uint16_t size, hc_08_view *value){
+  hc_08_view rest;
+
+  *value = hc_08_view_rx(hc_08, size);
+  hc_08_view_line(value);
+  if(hc_08_view_split(value, HC_08_TEXT_EQUEL[0], &rest) == hc_08_status_ok ||
+      hc_08_view_split(value, HC_08_TEXT_COLON[0], &rest) == hc_08_status_ok){
+    *value = rest;
+  }
+  return value->size ? hc_08_status_ok : hc_08_status_error;
+}
+
+/**
+  * @brief  View of one line of the answer to the AT+RX command ("Baud:115200,NONE", "PIN :000000")
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  size the size of received data. Actual is preferred, HC_08_RX_ALL takes everything received
+  * @param  *key name of the line: HC_08_TEXT_NAME, HC_08_TEXT_ROLE, HC_08_TEXT_BAUD, 
+  *           HC_08_TEXT_ADDR or HC_08_TEXT_PIN
+  * @param  *value pointer to the view to fill with the text after ':'
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if the line is missing or empty
+  */
+hc_08_status hc_08_view_field(hc_08_ST *hc_08, uint16_t size, const char *key, hc_08_view *value){
+  hc_08_view rx = hc_08_view_rx(hc_08, size);
+  const char *pos = hc_08_view_search(&rx, key);
+  hc_08_view line;
+
+  if(pos == NULL){
+    return hc_08_status_error;
+  }
+  line.data = pos + strlen(key);
+  line.size = rx.size - (line.data - rx.data);
+  hc_08_view_line(&line);
+  if(hc_08_view_split(&line, HC_08_TEXT_COLON[0], value) != hc_08_status_ok){
+    return hc_08_status_error;
+  }
+  hc_08_view_line(value);
+  return value->size ? hc_08_status_ok : hc_08_status_error;
+}
+
+/**
+  * @brief  View of the module name in the answer to the AT+NAME=? command
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  size the size of received data. Actual is preferred, HC_08_RX_ALL takes everything received
+  * @param  *name pointer to the view to fill
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if the name is empty or longer than HC_08_MAX_NAME_LENGHT
+  */
+hc_08_status hc_08_view_name(hc_08_ST *hc_08, uint16_t size, hc_08_view *name){
+  hc_08_view rest;
+
+  *name = hc_08_view_rx(hc_08, size);
+  hc_08_view_line(name);
+  hc_08_view_split(name, HC_08_TEXT_COLON[0], &rest);
+  if(name->size == 0 || name->size > HC_08_MAX_NAME_LENGHT){
+    return hc_08_status_error;
+  }
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Finding which entry of one of the string tables of hc-08.h is in a view.
+  *         An exact match wins, otherwise the longest entry contained in the view is taken
+  * @param  *view pointer to the view
+  * @param  table string table (hc_08_baud_c, hc_08_role_c, ...)
+  * @param  table_size number of entries (HC_08_BAUD_SIZE, HC_08_ROLE_SIZE, ...)
+  * @param  *index pointer to the found index
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if no entry matches
+  */
+hc_08_status hc_08_view_lookup(const hc_08_view *view, const char * const *table, uint8_t table_size, uint8_t *index){
+  uint16_t best_size = 0;
+
+  for(uint8_t i = 0; i < table_size; i++){
+    uint16_t entry_size = strlen(table[i]);
+
+    if(entry_size == view->size && memcmp(view->data, table[i], entry_size) == 0){
+      *index = i;
+      return hc_08_status_ok;
+    }
+    if(entry_size > best_size && hc_08_view_search(view, table[i]) != NULL){
+      best_size = entry_size;
+      *index = i;
+    }
+  }
+  return best_size ? hc_08_status_ok : hc_08_status_error;
+}
+
+/*
+ * Value + 1 of every hex digit, 0 for all other characters, so that a single load
+ * classifies and decodes a character
+ */
+static const uint8_t hc_08_digit[256] = {
+  ['0'] = 1, ['1'] = 2, ['2'] = 3, ['3'] = 4, ['4'] = 5,
+  ['5'] = 6, ['6'] = 7, ['7'] = 8, ['8'] = 9, ['9'] = 10,
+  ['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16,
+  ['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16
+};
+
+/**
+  * @brief  Common loop of the decimal and hex decoders. Errors are collected in flags
+  *         instead of leaving the loop, so the only branch per character is the loop itself
+  * @param  *data first character
+  * @param  size number of characters
+  * @param  base 10 or 16
+  * @param  *result pointer to the decoded value, written only on success
+  */
+static inline hc_08_decode hc_08_decode_digits(const char *data, uint16_t size, uint8_t base, uint16_t *result){
+  uint32_t value = 0;
+  uint8_t bad = 0;
+  uint8_t overflow = 0;
+
+  if(size == 0){
+    return hc_08_decode_empty;
+  }
+  for(uint16_t i = 0; i < size; i++){
+    uint8_t digit = hc_08_digit[(uint8_t)data[i]] - 1;
+
+    bad |= digit >= base;
+    value = value * base + (digit & 0x0f);
+    overflow |= value > 0xffff;
+    value &= 0x1ffff;
+  }
+  if(bad){
+    return hc_08_decode_bad_char;
+  }
+  if(overflow){
+    return hc_08_decode_overflow;
+  }
+  *result = (uint16_t)value;
+  return hc_08_decode_ok;
+}
+
+/**
+  * @brief  Decoding an unsigned decimal number of exactly size characters (no sign, no spaces)
+  * @param  *data first character, does not need to be NUL terminated
+  * @param  size number of characters
+  * @param  *result pointer to the decoded value, written only on success
+  * @retval hc_08_decode:
+  *             hc_08_decode_ok
+  *             hc_08_decode_empty if size is 0
+  *             hc_08_decode_bad_char if a character is not a digit
+  *             hc_08_decode_overflow if the value does not fit 16 bits
+  */
+hc_08_decode hc_08_decode_dec(const char *data, uint16_t size, uint16_t *result){
+  return hc_08_decode_digits(data, size, 10, result);
+}
+
+/**
+  * @brief  Decoding an unsigned hex number of exactly size characters, upper or lower case, no "0x"
+  * @param  *data first character, does not need to be NUL terminated
+  * @param  size number of characters
+  * @param  *result pointer to the decoded value, written only on success
+  * @retval hc_08_decode:
+  *             hc_08_decode_ok
+  *             hc_08_decode_empty if size is 0
+  *             hc_08_decode_bad_char if a character is not a hex digit
+  *             hc_08_decode_overflow if the value does not fit 16 bits
+  */
+hc_08_decode hc_08_decode_hex(const char *data, uint16_t size, uint16_t *result){
+  return hc_08_decode_digits(data, size, 16, result);
+}
+
+/**
+  * @brief  Decoding an address of fixed shape: six pairs of hex digits, either separated by
+  *         the same ',' ':' or '-' ("3C,E4,B0,89,DC,03", 17 characters) or not separated
+  *         ("3CE4B089DC03", 12 characters)
+  * @param  *data first character, does not need to be NUL terminated
+  * @param  size number of characters
+  * @param  *addres pointer to the result (array of 6 bytes), written only on success
+  * @retval hc_08_decode:
+  *             hc_08_decode_ok
+  *             hc_08_decode_empty if size is 0
+  *             hc_08_decode_bad_length if size is neither 12 nor 17
+  *             hc_08_decode_bad_char if a digit or a separator is wrong
+  */
+hc_08_decode hc_08_decode_addres(const char *data, uint16_t size, uint8_t *addres){
+  uint8_t value[6];
+  uint8_t stride;
+  uint8_t bad = 0;
+
+  if(size == 0){
+    return hc_08_decode_empty;
+  }
+  if(size == HC_08_ADDRES_LENGHT){
+    stride = 2;
+  }else if(size == HC_08_ADDRES_LENGHT + 5){
+    stride = 3;
+    bad |= data[2] != ',' && data[2] != ':' && data[2] != '-';
+    for(uint8_t i = 1; i < 5; i++){
+      bad |= data[i * 3 + 2] != data[2];
+    }
+  }else{
+    return hc_08_decode_bad_length;
+  }
+  for(uint8_t i = 0; i < 6; i++){
+    uint8_t high = hc_08_digit[(uint8_t)data[i * stride]] - 1;
+    uint8_t low = hc_08_digit[(uint8_t)data[i * stride + 1]] - 1;
+
+    bad |= (high | low) > 0x0f;
+    value[i] = (uint8_t)(high << 4) | (low & 0x0f);
+  }
+  if(bad){
+    return hc_08_decode_bad_char;
+  }
+  memcpy(addres, value, sizeof(value));
+  return hc_08_decode_ok;
+}
+
+/**
+  * @brief  Decoding an unsigned number that fills a whole view
+  * @param  *view pointer to the view
+  * @param  base 10 or 16
+  * @param  *result pointer to the decoded value
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if the view is empty, has other characters or does not fit 16 bits
+  */
+hc_08_status hc_08_view_number(const hc_08_view *view, uint8_t base, uint16_t *result){
+  hc_08_decode status = (base == 16) ? hc_08_decode_hex(view->data, view->size, result)
+                                     : hc_08_decode_dec(view->data, view->size, result);
+
+  return status == hc_08_decode_ok ? hc_08_status_ok : hc_08_status_error;
+}
+
+/**
+  * @brief  Copying the text of a view. Only needed when the text must outlive the receive buffer
+  * @param  *view pointer to the view
+  * @param  *buff destination, always NUL terminated if size > 0
+  * @param  size destination size
+  * @retval number of characters copied
+  */
+uint16_t hc_08_view_copy(const hc_08_view *view, char *buff, uint16_t size){
+  uint16_t count = view->size;
+
+  if(size == 0){
+    return 0;
+  }
+  if(count > size - 1){
+    count = size - 1;
+  }
+  memcpy(buff, view->data, count);
+  buff[count] = '\0';
+  return count;
+}
+
+/**
+  * @brief  Decoding "115200,NONE"
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  view view with the baud rate and parity
+  */
+static hc_08_status hc_08_view_baud_parity(hc_08_ST *hc_08, hc_08_view view){
+  hc_08_view parity;
+  uint8_t baud_index, parity_index;
+
+  if(hc_08_view_split(&view, HC_08_TEXT_COMMA[0], &parity) != hc_08_status_ok ||
+      hc_08_view_lookup(&view, hc_08_baud_c, HC_08_BAUD_SIZE, &baud_index) != hc_08_status_ok ||
+      hc_08_view_lookup(&parity, hc_08_parity_bit_c, HC_08_PARITY_SIZE, &parity_index) != hc_08_status_ok){
+    return hc_08_status_error;
+  }
+  hc_08->param.baud = (hc_08_baud)baud_index;
+  hc_08->param.parity = (hc_08_parity_bit)parity_index;
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Decoding a value of the answer in the range min..max
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  size the size of received data
+  * @param  base 10 or 16
+  * @param  min, max valid range
+  * @param  *result pointer to the parameter to write
+  */
+static hc_08_status hc_08_parse_number(hc_08_ST *hc_08, uint16_t size, uint8_t base,
+                                       uint16_t min, uint16_t max, uint16_t *result){
+  hc_08_view value;
+  uint16_t number;
+
+  if(hc_08_view_value(hc_08, size, &value) != hc_08_status_ok ||
+      hc_08_view_number(&value, base, &number) != hc_08_status_ok ||
+      number < min || number > max){
+    return hc_08_status_error;
+  }
+  *result = number;
+  return hc_08_status_ok;
 }
 
 /**
@@ -535,10 +1128,10 @@ void hc_08_cmd_ask_aust(hc_08_ST *hc_08){
   *             hc_08_status_error
 */
 hc_08_status hc_08_check_set(hc_08_ST *hc_08){
-  if(HC_08_BUFF_RX_SIZE >= sizeof(HC_08_TEXT_OK)){
-    if(strstr((const char *)(uint32_t)&hc_08->uart.buff_rx, (const char *)HC_08_TEXT_OK)){
-      return hc_08_status_ok;
-    }
+  hc_08_view rx = hc_08_view_rx(hc_08, HC_08_RX_ALL);
+  
+  if(hc_08_view_search(&rx, HC_08_TEXT_OK) != NULL){
+    return hc_08_status_ok;
   }
   return hc_08_status_error;
 }
@@ -557,123 +1150,114 @@ hc_08_status hc_08_check_set(hc_08_ST *hc_08){
   * www.hc01.com
   * www.hc01.com
   * @param  *hc_08 pointer to the HC-08 module structure
-  * @param  size the size of received data. Actual is preferred, but HC_08_BUFF_RX_SIZE is acceptable
+  * @param  size the size of received data. Actual is preferred, HC_08_RX_ALL takes everything received
   * @retval hc_08_status:
   *             hc_08_status_ok
   *             hc_08_status_error
 */
-hc_08_status hc_08_parse_base_param(hc_08_ST *hc_08, uint8_t size){
-  uint32_t possition_start = 0;
-  uint32_t possition_end = 0;
-/* if the size of the received data is larger than the size of the reception buffer,
-   something was overwritten*/
-  if(size <= HC_08_BUFF_RX_SIZE){
-    possition_start = strcspn((const char *)(hc_08->uart.buff_rx), (const char *)HC_08_TEXT_COLON) + strlen(HC_08_TEXT_COLON);
-
-    // name
-    if(possition_start != strlen(HC_08_TEXT_COLON)){
-      hc_08->param.name_lenght = strcspn(&hc_08->uart.buff_rx[possition_start], (const char *)HC_08_TEXT_CR);
-      possition_end = hc_08->param.name_lenght + possition_start;
-      strncpy(hc_08->param.name, (const char *)((uint32_t)&hc_08->uart.buff_rx + possition_start), hc_08->param.name_lenght);
-    }else{
-      return hc_08_status_error;
-    }
-    
-    //role
-    if(strstr((const char *)(hc_08->uart.buff_tx), (const char *)hc_08_role_c[hc_08_role_master])){
-       hc_08->param.role = hc_08_role_master;
-    }else if(strstr((const char *)((uint32_t)&hc_08->uart.buff_rx + possition_end), (const char *)hc_08_role_c[hc_08_role_slave])){
-       hc_08->param.role = hc_08_role_slave;
-    }else{
-      return hc_08_status_error;
-    }
-    possition_end = possition_end + strcspn((const char *)((uint32_t)&hc_08->uart.buff_rx + possition_end), (const char *)HC_08_TEXT_COLON);
-    
-    //baud
-    for(int i = 0; i < HC_08_BAUD_SIZE; i++){
-      if(strstr((const char *)((uint32_t)&hc_08->uart.buff_rx + possition_end), (const char *)hc_08_baud_c[i])){
-         hc_08->param.baud = i;
-         break;
-      }else if(i == HC_08_BAUD_SIZE - 1){
-        return hc_08_status_error;
-      }
-    }
-    possition_end = possition_end + strcspn((const char *)((uint32_t)&hc_08->uart.buff_rx + possition_end), (const char *)HC_08_TEXT_COMMA);
-    
-    // PARITY
-    for(int i = 0; i < HC_08_PARITY_SIZE; i++){
-      if(strstr((const char *)((uint32_t)&hc_08->uart.buff_rx + possition_end), (const char *)hc_08_parity_bit_c[i])){
-         hc_08->param.parity = i;
-         break;
-      }else if(i == HC_08_PARITY_SIZE - 1){
-        return hc_08_status_error;
-      }
-    }
-    
-    possition_end = possition_end + strcspn((const char *)((uint32_t)&hc_08->uart.buff_rx + possition_end), (const char *)HC_08_TEXT_COLON) + strlen(HC_08_TEXT_COLON);
-    
-    //Addr
-    for(uint8_t i = 0; i < sizeof(hc_08->param.addres); i++){
-      sscanf(&hc_08->uart.buff_rx[possition_end + i * 3], "%x", (int *)&hc_08->param.addres[i]);
-    }
-    possition_end = possition_end + strcspn((const char *)((uint32_t)&hc_08->uart.buff_rx + possition_end), (const char *)HC_08_TEXT_COLON) + strlen(HC_08_TEXT_COLON);
-    
-    //pin
-    for(uint8_t i = 0; i < sizeof(hc_08->param.addres); i++){
-      sscanf(&hc_08->uart.buff_rx[possition_end + i], "%d", (int *)&hc_08->param.pin[i]);
-    }
-    possition_end = possition_end + strcspn((const char *)((uint32_t)&hc_08->uart.buff_rx + possition_end), (const char *)HC_08_TEXT_CR) + sizeof(HC_08_TEXT_CR);
+hc_08_status hc_08_parse_base_param(hc_08_ST *hc_08, uint16_t size){
+  hc_08_view value;
+  
+  if(hc_08_parse_base_fields(hc_08, size) != HC_08_FIELD_BASE){
+    return hc_08_status_error;
   }
-   
-  if(possition_end > HC_08_BUFF_RX_SIZE){
+  
+  //pin
+  if(hc_08_view_field(hc_08, size, HC_08_TEXT_PIN, &value) != hc_08_status_ok ||
+      value.size != sizeof(hc_08->param.pin)){
     return hc_08_status_error;
   }
+  for(uint8_t i = 0; i < sizeof(hc_08->param.pin); i++){
+    if(value.data[i] < '0' || value.data[i] > '9'){
+      return hc_08_status_error;
+    }
+    hc_08->param.pin[i] = value.data[i] - '0';
+  }
 
   return hc_08_status_ok;
 }
 
+/**
+  * @brief  Parsing of the fields of the AT+RX answer one by one, so that a missing or broken
+  *         line does not lose the others
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  size the size of received data. Actual is preferred, HC_08_RX_ALL takes everything received
+  * @retval bits (1 << hc_08_field) of the fields written to hc_08->param, HC_08_FIELD_BASE if all
+*/
+uint32_t hc_08_parse_base_fields(hc_08_ST *hc_08, uint16_t size){
+  hc_08_view value;
+  uint8_t index;
+  uint32_t fields = 0;
+  
+  // name
+  if(hc_08_view_field(hc_08, size, HC_08_TEXT_NAME, &value) == hc_08_status_ok &&
+      value.size <= HC_08_MAX_NAME_LENGHT){
+    memcpy(hc_08->param.name, value.data, value.size);
+    hc_08->param.name_lenght = value.size;
+    fields |= 1UL << hc_08_field_name;
+  }
+  
+  //role
+  if(hc_08_view_field(hc_08, size, HC_08_TEXT_ROLE, &value) == hc_08_status_ok &&
+      hc_08_view_lookup(&value, hc_08_role_c, HC_08_ROLE_SIZE, &index) == hc_08_status_ok){
+    hc_08->param.role = (hc_08_role)index;
+    fields |= 1UL << hc_08_field_role;
+  }
+  
+  //baud, parity
+  if(hc_08_view_field(hc_08, size, HC_08_TEXT_BAUD, &value) == hc_08_status_ok &&
+      hc_08_view_baud_parity(hc_08, value) == hc_08_status_ok){
+    fields |= 1UL << hc_08_field_baud;
+  }
+  
+  //Addr
+  if(hc_08_view_field(hc_08, size, HC_08_TEXT_ADDR, &value) == hc_08_status_ok &&
+      hc_08_decode_addres(value.data, value.size, hc_08->param.addres) == hc_08_decode_ok){
+    fields |= 1UL << hc_08_field_address;
+  }
+
+  return fields;
+}
+
 /**
   * @brief  Parsing of the response to the AT+ROLE=? command is performed. The result will be 
   * recorded in the corresponding fields of the structure hc_08->param.role.
   * @param  *hc_08 pointer to the HC-08 module structure
-  * @param  size the size of received data. Actual is preferred, but HC_08_BUFF_RX_SIZE is acceptable
+  * @param  size the size of received data. Actual is preferred, HC_08_RX_ALL takes everything received
   * @retval hc_08_status:
   *             hc_08_status_ok
   *             hc_08_status_error
 */
-hc_08_status hc_08_parse_role(hc_08_ST *hc_08, uint8_t size){
-  uint32_t possition = strcspn((const char *)((uint32_t)&hc_08->uart.buff_rx), (const char *)HC_08_TEXT_COMMA);
+hc_08_status hc_08_parse_role(hc_08_ST *hc_08, uint16_t size){
+  hc_08_view value;
+  uint8_t index;
   
-  for(int i = 0; i < HC_08_ROLE_SIZE; i++){
-    if(strstr((const char *)(hc_08->uart.buff_rx), (const char *)hc_08_role_c[i])){
-       hc_08->param.role = i;
-       break;
-    }else if(i == HC_08_BAUD_SIZE - 1){
-      return hc_08_status_error;
-    }
+  if(hc_08_view_value(hc_08, size, &value) != hc_08_status_ok ||
+      hc_08_view_lookup(&value, hc_08_role_c, HC_08_ROLE_SIZE, &index) != hc_08_status_ok){
+    return hc_08_status_error;
   }
+  hc_08->param.role = (hc_08_role)index;
   return hc_08_status_ok;
 }
 
 /**
   * @brief  Parsing of the response to the AT+NAME=? command is performed. The result will be 
   * recorded in the corresponding fields of the structure hc_08->param.name.
+  * Use hc_08_view_name(...) to look at the name without copying it
   * @param  *hc_08 pointer to the HC-08 module structure
-  * @param  size the size of received data. Actual is preferred, but HC_08_BUFF_RX_SIZE is acceptable
+  * @param  size the size of received data. Actual is preferred, HC_08_RX_ALL takes everything received
   * @retval hc_08_status:
   *             hc_08_status_ok
   *             hc_08_status_error
 */
-hc_08_status hc_08_parse_name(hc_08_ST *hc_08, uint8_t size){
-  uint32_t possition = strcspn((const char *)((uint32_t)&hc_08->uart.buff_rx), (const char *)HC_08_TEXT_COLON);
-  
-  possition < size ? (hc_08->param.name_lenght = possition) : (hc_08->param.name_lenght = size);
+hc_08_status hc_08_parse_name(hc_08_ST *hc_08, uint16_t size){
+  hc_08_view name;
   
-  if(!possition){
+  if(hc_08_view_name(hc_08, size, &name) != hc_08_status_ok){
     return hc_08_status_error;
   }
-  
-  strncpy(hc_08->param.name, hc_08->uart.buff_rx, hc_08->param.name_lenght);
+  memcpy(hc_08->param.name, name.data, name.size);
+  hc_08->param.name_lenght = name.size;
   
   return hc_08_status_ok;
 }
@@ -682,19 +1266,18 @@ hc_08_status hc_08_parse_name(hc_08_ST *hc_08, uint8_t size){
   * @brief  Parsing of the response to the AT+ADDR=? command is performed. The result will be 
   * recorded in the corresponding fields of the structure hc_08->param.addres.
   * @param  *hc_08 pointer to the HC-08 module structure
-  * @param  size the size of received data. Actual is preferred, but HC_08_BUFF_RX_SIZE is acceptable
+  * @param  size the size of received data. Actual is preferred, HC_08_RX_ALL takes everything received
   * @retval hc_08_status:
   *             hc_08_status_ok
   *             hc_08_status_error
 */
-hc_08_status hc_08_parse_address(hc_08_ST *hc_08, uint8_t size){
-  uint32_t possition = strcspn((const char *)((uint32_t)&hc_08->uart.buff_rx), (const char *)HC_08_TEXT_COLON);
+hc_08_status hc_08_parse_address(hc_08_ST *hc_08, uint16_t size){
+  hc_08_view value;
   
-  if(possition - 1 <= (sizeof(hc_08->param.addres) * 3)){
-    for(uint8_t i = 0; i < sizeof(hc_08->param.addres); i++){
-      sscanf(&hc_08->uart.buff_rx[i * 3], "%x", (int *)&hc_08->param.addres[i]);
-    }
-  }else{
+  if(hc_08_view_value(hc_08, size, &value) != hc_08_status_ok){
+    return hc_08_status_error;
+  }
+  if(hc_08_decode_addres(value.data, value.size, hc_08->param.addres) != hc_08_decode_ok){
     return hc_08_status_error;
   }
   return hc_08_status_ok;
@@ -704,27 +1287,20 @@ hc_08_status hc_08_parse_address(hc_08_ST *hc_08, uint8_t size){
   * @brief  Parsing of the response to the AT+RFPM=? command is performed. The result will be 
   * recorded in the corresponding fields of the structure hc_08->param.rfpm.
   * @param  *hc_08 pointer to the HC-08 module structure
-  * @param  size the size of received data. Actual is preferred, but HC_08_BUFF_RX_SIZE is acceptable
+  * @param  size the size of received data. Actual is preferred, HC_08_RX_ALL takes everything received
   * @retval hc_08_status:
   *             hc_08_status_ok
   *             hc_08_status_error
 */
-hc_08_status hc_08_parse_rfpm(hc_08_ST *hc_08, uint8_t size){
-    uint32_t possition = strcspn((const char *)((uint32_t)&hc_08->uart.buff_rx), (const char *)HC_08_TEXT_EQUEL);
+hc_08_status hc_08_parse_rfpm(hc_08_ST *hc_08, uint16_t size){
+  hc_08_view value;
+  uint8_t index;
   
-  if(possition < size){
-    for(int i = 0; i < HC_08_RFPM_SIZE; i++){
-      if(strstr(&hc_08->uart.buff_rx[possition], (const char *)hc_08_rfpm_c[i])){
-         hc_08->param.rfpm = i;
-         break;
-      }else if(i == HC_08_RFPM_SIZE - 1){
-        return hc_08_status_error;
-      }
-    }
-  }else{
+  if(hc_08_view_value(hc_08, size, &value) != hc_08_status_ok ||
+      hc_08_view_lookup(&value, hc_08_rfpm_c, HC_08_RFPM_SIZE, &index) != hc_08_status_ok){
     return hc_08_status_error;
   }
-  
+  hc_08->param.rfpm = (hc_08_rfpm)index;
   return hc_08_status_ok;
 }
 
@@ -732,63 +1308,38 @@ hc_08_status hc_08_parse_rfpm(hc_08_ST *hc_08, uint8_t size){
   * @brief  Parsing of the response to the AT+BAUD=? command is performed. The result will be 
   * recorded in the corresponding fields of the structure hc_08->param.baud, hc_08->param.parity.
   * @param  *hc_08 pointer to the HC-08 module structure
-  * @param  size the size of received data. Actual is preferred, but HC_08_BUFF_RX_SIZE is acceptable
+  * @param  size the size of received data. Actual is preferred, HC_08_RX_ALL takes everything received
   * @retval hc_08_status:
   *             hc_08_status_ok
   *             hc_08_status_error
 */
-hc_08_status hc_08_parse_baud_and_parity(hc_08_ST *hc_08, uint8_t size){
-  uint32_t possition = strcspn((const char *)((uint32_t)&hc_08->uart.buff_rx), (const char *)HC_08_TEXT_EQUEL);
-  
-  if(possition < size){
-    for(int i = 0; i < HC_08_BAUD_SIZE; i++){
-      if(strstr(&hc_08->uart.buff_rx[possition], (const char *)hc_08_baud_c[i])){
-         hc_08->param.baud = i;
-         break;
-      }else if(i == HC_08_BAUD_SIZE - 1){
-        return hc_08_status_error;
-      }
-    }
-  }else{
-    return hc_08_status_error;
-  }
+hc_08_status hc_08_parse_baud_and_parity(hc_08_ST *hc_08, uint16_t size){
+  hc_08_view value;
   
-  possition = strcspn((const char *)((uint32_t)&hc_08->uart.buff_rx), (const char *)HC_08_TEXT_COMMA);
-  
-  if(possition < size){
-    for(int i = 0; i < HC_08_PARITY_SIZE; i++){
-      if(strstr(&hc_08->uart.buff_rx[possition], (const char *)hc_08_parity_bit_c[i])){
-         hc_08->param.parity = i;
-         break;
-      }else if(i == HC_08_PARITY_SIZE - 1){
-        return hc_08_status_error;
-      }
-    }
-  }else{
+  if(hc_08_view_value(hc_08, size, &value) != hc_08_status_ok){
     return hc_08_status_error;
   }
-  
-  return hc_08_status_ok;
+  return hc_08_view_baud_parity(hc_08, value);
 }
 
 /**
   * @brief  Parsing of the response to the AT+CONT=? command is performed. The result will be 
   * recorded in the corresponding fields of the structure hc_08->param.cont.
   * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  size the size of received data. Actual is preferred, HC_08_RX_ALL takes everything received
   * @retval hc_08_status:
   *             hc_08_status_ok
   *             hc_08_status_error
 */
-hc_08_status hc_08_parse_connect(hc_08_ST *hc_08){
-  for(int i = 0; i < HC_08_CONT_SIZE; i++){
-    if(strstr((const char *)(hc_08->uart.buff_rx), (const char *)hc_08_cont_c[i])){
-       hc_08->param.cont = i;
-       break;
-    }else if(i == HC_08_CONT_SIZE - 1){
-      return hc_08_status_error;
-    }
-  }
+hc_08_status hc_08_parse_connect(hc_08_ST *hc_08, uint16_t size){
+  hc_08_view value;
+  uint8_t index;
   
+  if(hc_08_view_value(hc_08, size, &value) != hc_08_status_ok ||
+      hc_08_view_lookup(&value, hc_08_cont_c, HC_08_CONT_SIZE, &index) != hc_08_status_ok){
+    return hc_08_status_error;
+  }
+  hc_08->param.cont = (hc_08_cont)index;
   return hc_08_status_ok;
 }
 
@@ -796,20 +1347,20 @@ hc_08_status hc_08_parse_connect(hc_08_ST *hc_08){
   * @brief  Parsing of the response to the AT+MODE=? command is performed. The result will be 
   * recorded in the corresponding fields of the structure hc_08->param.mode.
   * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  size the size of received data. Actual is preferred, HC_08_RX_ALL takes everything received
   * @retval hc_08_status:
   *             hc_08_status_ok
   *             hc_08_status_error
 */
-hc_08_status hc_08_parse_mode(hc_08_ST *hc_08){
-  for(int i = 0; i < HC_08_CONT_SIZE; i++){
-    if(strstr((const char *)(hc_08->uart.buff_rx), (const char *)hc_08_mode_c[i]) != NULL){
-       hc_08->param.mode = i;
-       break;
-    }else if(i == HC_08_MODE_SIZE - 1){
-      return hc_08_status_error;
-    }
+hc_08_status hc_08_parse_mode(hc_08_ST *hc_08, uint16_t size){
+  hc_08_view value;
+  uint8_t index;
+  
+  if(hc_08_view_value(hc_08, size, &value) != hc_08_status_ok ||
+      hc_08_view_lookup(&value, hc_08_mode_c, HC_08_MODE_SIZE, &index) != hc_08_status_ok){
+    return hc_08_status_error;
   }
-
+  hc_08->param.mode = (hc_08_mode)index;
   return hc_08_status_ok;
 }
 
@@ -817,43 +1368,27 @@ hc_08_status hc_08_parse_mode(hc_08_ST *hc_08){
   * @brief  Parsing of the response to the AT+CINT=? command is performed. The result will be 
   * recorded in the corresponding fields of the structure hc_08->param.cint_min, hc_08->param.cint_max.
   * @param  *hc_08 pointer to the HC-08 module structure
-  * @param  size the size of received data. Actual is preferred, but HC_08_BUFF_RX_SIZE is acceptable
+  * @param  size the size of received data. Actual is preferred, HC_08_RX_ALL takes everything received
   * @retval hc_08_status:
   *             hc_08_status_ok
   *             hc_08_status_error
 */
-hc_08_status hc_08_parse_cint(hc_08_ST *hc_08, uint8_t size){
-  uint16_t result = 0;
-  uint16_t possition = strcspn((const char *)(hc_08->uart.buff_rx), 
-                                      (const char *)HC_08_TEXT_EQUEL) + 
-                                      strlen(HC_08_TEXT_EQUEL);
+hc_08_status hc_08_parse_cint(hc_08_ST *hc_08, uint16_t size){
+  hc_08_view value, max;
+  uint16_t cint_min, cint_max;
   
-  // cint_min
-  if(possition < size){
-    sscanf(&hc_08->uart.buff_rx[possition], "%d", (int *)&result);
-    if (result >= HC_08_CINT_MIN && result <= HC_08_CINT_MAX){
-      hc_08->param.cint_min = result;
-    }else{
-      return hc_08_status_error;
-    }
-  }else{
+  if(hc_08_view_value(hc_08, size, &value) != hc_08_status_ok ||
+      hc_08_view_split(&value, HC_08_TEXT_COMMA[0], &max) != hc_08_status_ok ||
+      hc_08_view_number(&value, 10, &cint_min) != hc_08_status_ok ||
+      hc_08_view_number(&max, 10, &cint_max) != hc_08_status_ok){
     return hc_08_status_error;
   }
-
-  //cint_max
-  possition = strcspn((const char *)(hc_08->uart.buff_rx), 
-                                    (const char *)HC_08_TEXT_EQUEL) + 
-                                    strlen(HC_08_TEXT_EQUEL);
-  if(possition != size){
-    sscanf(&hc_08->uart.buff_rx[possition], "%d", (int *)&result);
-    if (result >= HC_08_CINT_MIN && result <= HC_08_CINT_MAX){
-      hc_08->param.cint_max = result;
-    }else{
-      return hc_08_status_error;
-    }
-  }else{
+  if(cint_min < HC_08_CINT_MIN || cint_min > HC_08_CINT_MAX ||
+      cint_max < HC_08_CINT_MIN || cint_max > HC_08_CINT_MAX){
     return hc_08_status_error;
   }
+  hc_08->param.cint_min = cint_min;
+  hc_08->param.cint_max = cint_max;
   return hc_08_status_ok;
 }
 
@@ -861,177 +1396,172 @@ hc_08_status hc_08_parse_cint(hc_08_ST *hc_08, uint8_t size){
   * @brief  Parsing of the response to the AT+AINT=? command is performed. The result will be 
   * recorded in the corresponding fields of the structure hc_08->param.aint.
   * @param  *hc_08 pointer to the HC-08 module structure
-  * @param  size the size of received data. Actual is preferred, but HC_08_BUFF_RX_SIZE is acceptable
+  * @param  size the size of received data. Actual is preferred, HC_08_RX_ALL takes everything received
   * @retval hc_08_status:
   *             hc_08_status_ok
   *             hc_08_status_error
 */
-hc_08_status hc_08_parse_aint(hc_08_ST *hc_08, uint8_t size){
-  uint16_t result = 0;
-  uint16_t possition = strcspn((const char *)(hc_08->uart.buff_rx), 
-                                      (const char *)HC_08_TEXT_EQUEL) + 
-                                      strlen(HC_08_TEXT_EQUEL);
-
-    if(possition < size){
-      sscanf(&hc_08->uart.buff_rx[possition], "%d", (int *)&result);
-      if (result >= HC_08_AINT_MIN && result <= HC_08_AINT_MAX){
-        hc_08->param.aint = result;
-      }else{
-        return hc_08_status_error;
-      }
-    }else{
-      return hc_08_status_error;
-    }
-  return hc_08_status_ok;
+hc_08_status hc_08_parse_aint(hc_08_ST *hc_08, uint16_t size){
+  return hc_08_parse_number(hc_08, size, 10, HC_08_AINT_MIN, HC_08_AINT_MAX, &hc_08->param.aint);
 }
 
 /**
   * @brief  Parsing of the response to the AT+CTOUT=? command is performed. The result will be 
   * recorded in the corresponding fields of the structure hc_08->param.ctout.
   * @param  *hc_08 pointer to the HC-08 module structure
-  * @param  size the size of received data. Actual is preferred, but HC_08_BUFF_RX_SIZE is acceptable
+  * @param  size the size of received data. Actual is preferred, HC_08_RX_ALL takes everything received
   * @retval hc_08_status:
   *             hc_08_status_ok
   *             hc_08_status_error
 */
-hc_08_status hc_08_parse_ctout(hc_08_ST *hc_08, uint8_t size){
-  uint16_t result = 0;
-  uint16_t possition = strcspn((const char *)(hc_08->uart.buff_rx), 
-                                      (const char *)HC_08_TEXT_EQUEL) + 
-                                      strlen(HC_08_TEXT_EQUEL);
-
-    if(possition < size){
-      sscanf(&hc_08->uart.buff_rx[possition], "%d", (int *)&result);
-      if (result >= HC_08_CTOUT_MIN && result <= HC_08_CTOUT_MAX){
-        hc_08->param.ctout = result;
-      }else{
-        return hc_08_status_error;
-      }
-    }else{
-      return hc_08_status_error;
-    }
-  return hc_08_status_ok;
+hc_08_status hc_08_parse_ctout(hc_08_ST *hc_08, uint16_t size){
+  return hc_08_parse_number(hc_08, size, 10, HC_08_CTOUT_MIN, HC_08_CTOUT_MAX, &hc_08->param.ctout);
 }
 
 /**
   * @brief  Parsing of the response to the AT+LUUID=? command is performed. The result will be 
   * recorded in the corresponding fields of the structure hc_08->param.luuid.
   * @param  *hc_08 pointer to the HC-08 module structure
-  * @param  size the size of received data. Actual is preferred, but HC_08_BUFF_RX_SIZE is acceptable
+  * @param  size the size of received data. Actual is preferred, HC_08_RX_ALL takes everything received
   * @retval hc_08_status:
   *             hc_08_status_ok
   *             hc_08_status_error
 */
-hc_08_status hc_08_parse_luuid(hc_08_ST *hc_08, uint8_t size){
-  uint16_t possition = strcspn((const char *)(hc_08->uart.buff_rx), 
-                                      (const char *)HC_08_TEXT_EQUEL) + 
-                                      strlen(HC_08_TEXT_EQUEL);
-
-    if(possition < size){
-      sscanf(&hc_08->uart.buff_rx[possition], "%x", (int *)&hc_08->param.luuid);
-    }else{
-      return hc_08_status_error;
-    }
-  return hc_08_status_ok;
+hc_08_status hc_08_parse_luuid(hc_08_ST *hc_08, uint16_t size){
+  return hc_08_parse_number(hc_08, size, 16, 0, 0xffff, &hc_08->param.luuid);
 }
 
 /**
   * @brief  Parsing of the response to the AT+SUUID=? command is performed. The result will be 
   * recorded in the corresponding fields of the structure hc_08->param.suuid.
   * @param  *hc_08 pointer to the HC-08 module structure
-  * @param  size the size of received data. Actual is preferred, but HC_08_BUFF_RX_SIZE is acceptable
+  * @param  size the size of received data. Actual is preferred, HC_08_RX_ALL takes everything received
   * @retval hc_08_status:
   *             hc_08_status_ok
   *             hc_08_status_error
 */
-hc_08_status hc_08_parse_suuid(hc_08_ST *hc_08, uint8_t size){
-  uint16_t possition = strcspn((const char *)(hc_08->uart.buff_rx), 
-                                      (const char *)HC_08_TEXT_EQUEL) + 
-                                      strlen(HC_08_TEXT_EQUEL);
-
-    if(possition < size){
-      sscanf(&hc_08->uart.buff_rx[possition], "%x", (int *)&hc_08->param.suuid);
-    }else{
-      return hc_08_status_error;
-    }
-  return hc_08_status_ok;
+hc_08_status hc_08_parse_suuid(hc_08_ST *hc_08, uint16_t size){
+  return hc_08_parse_number(hc_08, size, 16, 0, 0xffff, &hc_08->param.suuid);
 }
 
 /**
   * @brief  Parsing of the response to the AT+TUUID=? command is performed. The result will be 
   * recorded in the corresponding fields of the structure hc_08->param.tuuid.
   * @param  *hc_08 pointer to the HC-08 module structure
-  * @param  size the size of received data. Actual is preferred, but HC_08_BUFF_RX_SIZE is acceptable
+  * @param  size the size of received data. Actual is preferred, HC_08_RX_ALL takes everything received
   * @retval hc_08_status:
   *             hc_08_status_ok
   *             hc_08_status_error
 */
-hc_08_status hc_08_parse_tuuid(hc_08_ST *hc_08, uint8_t size){
-  uint16_t possition = strcspn((const char *)(hc_08->uart.buff_rx), 
-                                      (const char *)HC_08_TEXT_EQUEL) + 
-                                      strlen(HC_08_TEXT_EQUEL);
-
-    if(possition != size){
-      sscanf(&hc_08->uart.buff_rx[possition], "%x", (int *)&hc_08->param.tuuid);
-    }else{
-      return hc_08_status_error;
-    }
-  return hc_08_status_ok;
+hc_08_status hc_08_parse_tuuid(hc_08_ST *hc_08, uint16_t size){
+  return hc_08_parse_number(hc_08, size, 16, 0, 0xffff, &hc_08->param.tuuid);
 }
 
 /**
   * @brief  Parsing of the response to the AT+AUST=? command is performed. The result will be 
   * recorded in the corresponding fields of the structure hc_08->param.aust.
   * @param  *hc_08 pointer to the HC-08 module structure
-  * @param  size the size of received data. Actual is preferred, but HC_08_BUFF_RX_SIZE is acceptable
+  * @param  size the size of received data. Actual is preferred, HC_08_RX_ALL takes everything received
   * @retval hc_08_status:
   *             hc_08_status_ok
   *             hc_08_status_error
 */
-hc_08_status hc_08_parse_aust(hc_08_ST *hc_08, uint8_t size){
-  uint16_t result = 0;
-  uint16_t possition = strcspn((const char *)(hc_08->uart.buff_rx), 
-                                      (const char *)HC_08_TEXT_EQUEL) + 
-                                      strlen(HC_08_TEXT_EQUEL);
-
-  if(possition < size){
-    sscanf(&hc_08->uart.buff_rx[possition], "%d", (int *)&result);
-    if (result >= HC_08_AUST_MIN && result <= HC_08_AUST_MAX){
-      hc_08->param.aust = result;
-    }else{
-      return hc_08_status_error;
-    }
-  }else{
-    return hc_08_status_error;
-  }
-  return hc_08_status_ok;
+hc_08_status hc_08_parse_aust(hc_08_ST *hc_08, uint16_t size){
+  return hc_08_parse_number(hc_08, size, 10, HC_08_AUST_MIN, HC_08_AUST_MAX, &hc_08->param.aust);
 }
 
 /**
   * @brief  Parsing of the response to the AT+LED=? command is performed. The result will be 
   * recorded in the corresponding fields of the structure hc_08->param.led.
   * @param  *hc_08 pointer to the HC-08 module structure
-  * @param  size the size of received data. Actual is preferred, but HC_08_BUFF_RX_SIZE is acceptable
+  * @param  size the size of received data. Actual is preferred, HC_08_RX_ALL takes everything received
   * @retval hc_08_status:
   *             hc_08_status_ok
   *             hc_08_status_error
 */
-hc_08_status hc_08_parse_led(hc_08_ST *hc_08, uint8_t size){
-    uint32_t possition = strcspn((const char *)((uint32_t)&hc_08->uart.buff_rx), (const char *)HC_08_TEXT_EQUEL);
+hc_08_status hc_08_parse_led(hc_08_ST *hc_08, uint16_t size){
+  hc_08_view value;
+  uint8_t index;
   
-  if(possition < size){
-    for(int i = 0; i < HC_08_LED_SIZE; i++){
-      if(strstr(&hc_08->uart.buff_rx[possition], (const char *)hc_08_led_c[i])){
-         hc_08->param.led = i;
-         break;
-      }else if(i == HC_08_LED_SIZE - 1){
-        return hc_08_status_error;
-      }
+  if(hc_08_view_value(hc_08, size, &value) != hc_08_status_ok ||
+      hc_08_view_lookup(&value, hc_08_led_c, HC_08_LED_SIZE, &index) != hc_08_status_ok){
+    return hc_08_status_error;
+  }
+  hc_08->param.led = index;
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Length of the run of decimal digits at the start of data
+  */
+static uint16_t hc_08_digits(const char *data, uint16_t size){
+  uint16_t count = 0;
+
+  while(count < size && data[count] >= '0' && data[count] <= '9'){
+    count++;
+  }
+  return count;
+}
+
+/**
+  * @brief  Parsing of the response to the AT+VERSION command is performed. The result will be 
+  * recorded in the corresponding fields of the structure hc_08->param.version. 
+  * Example: HC-08V3.3,2020-10-16. The date is optional (0 if missing)
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  size the size of received data. Actual is preferred, HC_08_RX_ALL takes everything received
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error
+*/
+hc_08_status hc_08_parse_version(hc_08_ST *hc_08, uint16_t size){
+  hc_08_view rx = hc_08_view_rx(hc_08, size);
+  hc_08_version_ST version = {0};
+  const char *data = NULL;
+  const char *end = rx.data + rx.size;
+  uint16_t count;
+  uint16_t value;
+
+  // "V" followed by a digit, the module name before it may contain digits too
+  for(uint16_t i = 0; i + 1 < rx.size; i++){
+    if((rx.data[i] == 'V' || rx.data[i] == 'v') && rx.data[i + 1] >= '0' && rx.data[i + 1] <= '9'){
+      data = rx.data + i + 1;
+      break;
     }
-  }else{
+  }
+  if(data == NULL){
     return hc_08_status_error;
   }
-  
+
+  count = hc_08_digits(data, end - data);
+  if(hc_08_decode_dec(data, count, &value) != hc_08_decode_ok || value > 0xFF){
+    return hc_08_status_error;
+  }
+  version.major = value;
+  data += count;
+  if(data < end && *data == '.'){
+    data++;
+    count = hc_08_digits(data, end - data);
+    if(hc_08_decode_dec(data, count, &value) != hc_08_decode_ok || value > 0xFF){
+      return hc_08_status_error;
+    }
+    version.minor = value;
+    data += count;
+  }
+
+  // date YYYY-MM-DD
+  if(end - data >= 11 && *data == ',' &&
+      hc_08_decode_dec(data + 1, 4, &version.year) == hc_08_decode_ok && data[5] == '-' &&
+      hc_08_decode_dec(data + 6, 2, &value) == hc_08_decode_ok && data[8] == '-'){
+    version.month = value;
+    if(hc_08_decode_dec(data + 9, 2, &value) == hc_08_decode_ok){
+      version.day = value;
+    }else{
+      version.year = 0;
+      version.month = 0;
+    }
+  }
+
+  hc_08->param.version = version;
   return hc_08_status_ok;
 }
 
@@ -1063,9 +1593,7 @@ hc_08_status_connect hc_08_status_connect_get(hc_08_ST *hc_08, hc_08_status_conn
   * @param  *hc_08 pointer to the HC-08 module structure
 */  
 void hc_08_clear_buff_tx(hc_08_ST *hc_08){
-  for(int8_t i = 0; i < HC_08_BUFF_TX_SIZE; i++){
-    hc_08->uart.buff_tx[i] = 0;
-  }
+  memset(hc_08->uart.buff_tx, 0, hc_08->uart.tx_capacity);
 }
 
 /**
@@ -1073,7 +1601,102 @@ void hc_08_clear_buff_tx(hc_08_ST *hc_08){
   * @param  *hc_08 pointer to the HC-08 module structure
 */  
 void hc_08_clear_buff_rx(hc_08_ST *hc_08){
-  for(int8_t i = 0; i < HC_08_BUFF_RX_SIZE; i++){
-    hc_08->uart.buff_rx[i] = 0;
+  memset(hc_08->uart.buff_rx, 0, hc_08->uart.rx_capacity);
+  hc_08->uart.rx_size = 0;
+}
+
+/**
+  * @brief  Marking a field of hc_08->param as no longer matching the module. Called by every
+  *         set command for the field it writes; caches (hc-08-cache.h) read it again when asked
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  field the field written
+*/
+void hc_08_param_invalidate(hc_08_ST *hc_08, hc_08_field field){
+  hc_08->param_valid &= ~(1UL << field);
+}
+
+/*
+ * Query command and parser of every field
+ */
+static const struct{
+  void (*ask)(hc_08_ST *hc_08);
+  hc_08_status (*parse)(hc_08_ST *hc_08, uint16_t size);
+}hc_08_field_query[HC_08_FIELD_SIZE] = {
+  [hc_08_field_role] = {hc_08_cmd_ask_role, hc_08_parse_role},
+  [hc_08_field_name] = {hc_08_cmd_ask_name, hc_08_parse_name},
+  [hc_08_field_address] = {hc_08_cmd_ask_address, hc_08_parse_address},
+  [hc_08_field_rfpm] = {hc_08_cmd_ask_rf_power, hc_08_parse_rfpm},
+  [hc_08_field_baud] = {hc_08_cmd_ask_uart_baud_parity, hc_08_parse_baud_and_parity},
+  [hc_08_field_cont] = {hc_08_cmd_ask_rfpm, hc_08_parse_connect},
+  [hc_08_field_mode] = {hc_08_cmd_ask_mode, hc_08_parse_mode},
+  [hc_08_field_aint] = {hc_08_cmd_ask_aint, hc_08_parse_aint},
+  [hc_08_field_cint] = {hc_08_cmd_ask_cint_min_max, hc_08_parse_cint},
+  [hc_08_field_ctout] = {hc_08_cmd_ask_ctout, hc_08_parse_ctout},
+  [hc_08_field_luuid] = {hc_08_cmd_ask_luuid, hc_08_parse_luuid},
+  [hc_08_field_suuid] = {hc_08_cmd_ask_suuid, hc_08_parse_suuid},
+  [hc_08_field_tuuid] = {hc_08_cmd_ask_tuuid, hc_08_parse_tuuid},
+  [hc_08_field_aust] = {hc_08_cmd_ask_aust, hc_08_parse_aust},
+  [hc_08_field_led] = {hc_08_cmd_ask_led, hc_08_parse_led}
+};
+
+/**
+  * @brief  Asking the module for one field with its query command. On success the value is in
+  *         hc_08->param and the field is marked in hc_08->param_valid
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  field the field
+  * @retval hc_08_status:
+  *             hc_08_status_ok
+  *             hc_08_status_error if the answer could not be parsed (the field is marked invalid)
+*/
+hc_08_status hc_08_read_field(hc_08_ST *hc_08, hc_08_field field){
+  if((unsigned int)field >= HC_08_FIELD_SIZE){
+    return hc_08_status_error;
+  }
+  hc_08_param_invalidate(hc_08, field);
+  hc_08_field_query[field].ask(hc_08);
+  hc_08_read_answer(hc_08);
+  if(hc_08_field_query[field].parse(hc_08, hc_08->uart.rx_size) != hc_08_status_ok){
+    return hc_08_status_error;
+  }
+  hc_08->param_valid |= 1UL << field;
+  return hc_08_status_ok;
+}
+
+/**
+  * @brief  Reading several fields with as few commands as possible. When two or more of the
+  *         fields reported by AT+RX (name, role, baud, address) are asked for, one AT+RX
+  *         replaces their queries; every other field, and any AT+RX line that could not be
+  *         parsed, is asked with its own query. Fields already valid are read again, pass
+  *         fields & ~hc_08->param_valid to read only the missing ones
+  * @param  *hc_08 pointer to the HC-08 module structure
+  * @param  fields bits (1 << hc_08_field) of the fields to read, HC_08_FIELD_ALL for all
+  * @param  *round_trips number of commands sent, NULL if not needed
+  * @retval hc_08_status:
+  *             hc_08_status_ok if every field asked for is now valid
+  *             hc_08_status_error if some are not, see hc_08->param_valid
+*/
+hc_08_status hc_08_read_all(hc_08_ST *hc_08, uint32_t fields, uint8_t *round_trips){
+  uint8_t count = 0;
+  uint32_t base = fields & HC_08_FIELD_BASE;
+
+  fields &= HC_08_FIELD_ALL;
+  hc_08->param_valid &= ~fields;
+  // a single AT+RX field costs the same as its own query
+  if((base & (base - 1)) != 0){
+    hc_08_cmd_rx(hc_08);
+    hc_08_read_answer(hc_08);
+    count++;
+    hc_08->param_valid |= hc_08_parse_base_fields(hc_08, hc_08->uart.rx_size) & base;
+  }
+  for(uint8_t field = 0; field < HC_08_FIELD_SIZE; field++){
+    if((fields & (1UL << field)) && !(hc_08->param_valid & (1UL << field))){
+      hc_08_read_field(hc_08, (hc_08_field)field);
+      count++;
+    }
+  }
+
+  if(round_trips != NULL){
+    *round_trips = count;
   }
+  return (hc_08->param_valid & fields) == fields ? hc_08_status_ok : hc_08_status_error;
 }
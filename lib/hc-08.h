@@ -1,7 +1,21 @@
+#ifndef HC_08_H
+#define HC_08_H
+
 #include <stdint.h>
 
+/*
+ * Sizes of the buffers embedded in hc_08_ST. Define them on the compiler command line
+ * (-DHC_08_BUFF_RX_SIZE=0x100) to change them for the whole build, or to 0 to leave the
+ * embedded buffers out and give every module its own storage with hc_08_init_buffers(...)
+ */
+#ifndef HC_08_BUFF_RX_SIZE
 #define HC_08_BUFF_RX_SIZE   0x7f
+#endif
+#ifndef HC_08_BUFF_TX_SIZE
 #define HC_08_BUFF_TX_SIZE   0x64
+#endif
+#define HC_08_BUFF_TX_MIN    0x20      // longest command ("AT+BAUD=115200,NONE", "AT+NAME=" + 12)
+#define HC_08_RX_ALL         0xFFFF    // size for the parsers: everything that was received
 
 #define HC_08_COMMAND_AT            "AT"
 #define HC_08_COMMAND_ATPLUS        "AT+"
@@ -44,6 +58,7 @@
 
 #define HC_08_MAX_NAME_LENGHT         12
 #define HC_08_ADDRES_LENGHT         12
+#define HC_08_AVDA_MAX_LENGHT       12
 
 #define HC_08_AINT_MAX  (uint16_t) 16000
 #define HC_08_AINT_MIN  (uint16_t) 32
@@ -88,7 +103,7 @@ static const char * const hc_08_rfpm_c[] = {
   [hc_08_rfpm_m6dBm] = "-6dBm",
   [hc_08_rfpm_m23dBm] = "-23dBm"
 };
-#define HC_08_RFPM_SIZE 0x08
+#define HC_08_RFPM_SIZE 0x04
 
 typedef enum{
   hc_08_baud_1200bps,
@@ -180,6 +195,49 @@ typedef enum{
   hc_08_status_not_connected = 0x01
 }hc_08_status_connect;
 
+typedef enum{
+  hc_08_field_role,
+  hc_08_field_name,
+  hc_08_field_address,
+  hc_08_field_rfpm,
+  hc_08_field_baud,
+  hc_08_field_cont,
+  hc_08_field_mode,
+  hc_08_field_aint,
+  hc_08_field_cint,
+  hc_08_field_ctout,
+  hc_08_field_luuid,
+  hc_08_field_suuid,
+  hc_08_field_tuuid,
+  hc_08_field_aust,
+  hc_08_field_led
+}hc_08_field;
+#define HC_08_FIELD_SIZE 0x0F
+#define HC_08_FIELD_ALL  ((1UL << HC_08_FIELD_SIZE) - 1)
+#define HC_08_FIELD_BASE ((1UL << hc_08_field_role) | (1UL << hc_08_field_name) | \
+                          (1UL << hc_08_field_address) | (1UL << hc_08_field_baud))   // reported by AT+RX
+
+typedef struct{
+  const char *data;
+  uint16_t size;
+}hc_08_view;
+
+typedef struct{
+  uint8_t major;
+  uint8_t minor;
+  uint16_t year;         // firmware date, 0 if the answer has none
+  uint8_t month;
+  uint8_t day;
+}hc_08_version_ST;
+
+typedef enum{
+  hc_08_decode_ok,
+  hc_08_decode_empty,
+  hc_08_decode_bad_char,
+  hc_08_decode_overflow,
+  hc_08_decode_bad_length
+}hc_08_decode;
+
 typedef struct
 {
   struct{
@@ -202,23 +260,55 @@ typedef struct
     uint16_t tuuid;
     uint16_t aust;
     uint8_t led;
+    hc_08_version_ST version;
   }param;
   
   struct
   {
-    char buff_rx[HC_08_BUFF_RX_SIZE];
-    char buff_tx[HC_08_BUFF_TX_SIZE];
+    char *buff_rx;
+    char *buff_tx;
+    uint16_t rx_capacity;
+    uint16_t tx_capacity;
+#if HC_08_BUFF_RX_SIZE > 0
+    char storage_rx[HC_08_BUFF_RX_SIZE];
+#endif
+#if HC_08_BUFF_TX_SIZE > 0
+    char storage_tx[HC_08_BUFF_TX_SIZE];
+#endif
     void (*tx)  (char *buff, uint16_t size);
     void (*rx)  (char *buff, uint16_t size);
+    void (*tx_ctx)  (void *ctx, char *buff, uint16_t size);
+    uint16_t (*rx_ctx)  (void *ctx, char *buff, uint16_t size);
+    void *ctx;
+    uint16_t rx_size;
   }uart;
   
+  uint32_t param_valid;    // bit (1 << hc_08_field) set while param holds the module's value
+  
+  uint32_t (*get_tick)(void);
+  
+  struct{
+    uint32_t tx_bytes;
+    uint32_t rx_bytes;
+  }stats;
+  
   hc_08_status_connect status_connect;
 } hc_08_ST;
 
+hc_08_status hc_08_init_buffers(hc_08_ST *hc_08, char *buff_rx, uint16_t rx_size, char *buff_tx, uint16_t tx_size);
 void hc_08_reg_uart_cbfunc(hc_08_ST *hc_08,
                             void (*uart_tx)(char *buff, uint16_t size), 
                             void (*uart_rx)(char *buff, uint16_t size));
+void hc_08_reg_uart_cbfunc_ctx(hc_08_ST *hc_08,
+                            void (*uart_tx)(void *ctx, char *buff, uint16_t size), 
+                            uint16_t (*uart_rx)(void *ctx, char *buff, uint16_t size),
+                            void *ctx);
+void hc_08_uart_tx(hc_08_ST *hc_08, char *buff, uint16_t size);
+void hc_08_reg_tick_cbfunc(hc_08_ST *hc_08, uint32_t (*get_tick)(void));
+uint32_t hc_08_get_tick(hc_08_ST *hc_08);
 void hc_08_read_answer(hc_08_ST *hc_08);
+void hc_08_rx_complete(hc_08_ST *hc_08, uint16_t size);
+uint16_t hc_08_rx_received(hc_08_ST *hc_08);
 
 void hc_08_cmd_at(hc_08_ST *hc_08);
 void hc_08_cmd_rx(hc_08_ST *hc_08);
@@ -228,13 +318,13 @@ void hc_08_cmd_version(hc_08_ST *hc_08);
 void hc_08_cmd_clear(hc_08_ST *hc_08);
 
 void hc_08_cmd_set_role(hc_08_ST *hc_08, hc_08_role role);
-void hc_08_cmd_set_name(hc_08_ST *hc_08, char *name);
+hc_08_status hc_08_cmd_set_name(hc_08_ST *hc_08, char *name);
 void hc_08_cmd_set_address(hc_08_ST *hc_08, uint8_t *address);
 void hc_08_cmd_set_rf_power(hc_08_ST *hc_08, hc_08_rfpm rfpm_param);
 void hc_08_cmd_set_uart_baud(hc_08_ST *hc_08, hc_08_baud baud);
 void hc_08_cmd_set_uart_baud_parity(hc_08_ST *hc_08, hc_08_baud baud, hc_08_parity_bit parity_bit);
 void hc_08_cmd_set_cont(hc_08_ST *hc_08, hc_08_cont cont);
-void hc_08_cmd_set_avda(hc_08_ST *hc_08, char *avda);
+hc_08_status hc_08_cmd_set_avda(hc_08_ST *hc_08, char *avda);
 void hc_08_cmd_set_mode(hc_08_ST *hc_08, hc_08_mode mode);
 hc_08_status hc_08_cmd_set_aint(hc_08_ST *hc_08, uint16_t value);
 hc_08_status hc_08_cmd_set_cint(hc_08_ST *hc_08, uint16_t time);
@@ -263,24 +353,44 @@ void hc_08_cmd_ask_tuuid(hc_08_ST *hc_08);
 void hc_08_cmd_ask_aust(hc_08_ST *hc_08);
 
 hc_08_status hc_08_check_set(hc_08_ST *hc_08);
-hc_08_status hc_08_parse_base_param(hc_08_ST *hc_08, uint8_t size);
-hc_08_status hc_08_parse_role(hc_08_ST *hc_08, uint8_t size);
-hc_08_status hc_08_parse_name(hc_08_ST *hc_08, uint8_t size);
-hc_08_status hc_08_parse_address(hc_08_ST *hc_08, uint8_t size);
-hc_08_status hc_08_parse_rfpm(hc_08_ST *hc_08, uint8_t size);
-hc_08_status hc_08_parse_baud_and_parity(hc_08_ST *hc_08, uint8_t size);
-hc_08_status hc_08_parse_connect(hc_08_ST *hc_08);
-hc_08_status hc_08_parse_mode(hc_08_ST *hc_08);
-hc_08_status hc_08_parse_cint(hc_08_ST *hc_08, uint8_t size);
-hc_08_status hc_08_parse_aint(hc_08_ST *hc_08, uint8_t size);
-hc_08_status hc_08_parse_ctout(hc_08_ST *hc_08, uint8_t size);
-hc_08_status hc_08_parse_luuid(hc_08_ST *hc_08, uint8_t size);
-hc_08_status hc_08_parse_suuid(hc_08_ST *hc_08, uint8_t size);
-hc_08_status hc_08_parse_tuuid(hc_08_ST *hc_08, uint8_t size);
-hc_08_status hc_08_parse_aust(hc_08_ST *hc_08, uint8_t size);
-hc_08_status hc_08_parse_led(hc_08_ST *hc_08, uint8_t size);
+hc_08_status hc_08_parse_base_param(hc_08_ST *hc_08, uint16_t size);
+uint32_t hc_08_parse_base_fields(hc_08_ST *hc_08, uint16_t size);
+hc_08_status hc_08_parse_role(hc_08_ST *hc_08, uint16_t size);
+hc_08_status hc_08_parse_name(hc_08_ST *hc_08, uint16_t size);
+hc_08_status hc_08_parse_address(hc_08_ST *hc_08, uint16_t size);
+hc_08_status hc_08_parse_rfpm(hc_08_ST *hc_08, uint16_t size);
+hc_08_status hc_08_parse_baud_and_parity(hc_08_ST *hc_08, uint16_t size);
+hc_08_status hc_08_parse_connect(hc_08_ST *hc_08, uint16_t size);
+hc_08_status hc_08_parse_mode(hc_08_ST *hc_08, uint16_t size);
+hc_08_status hc_08_parse_cint(hc_08_ST *hc_08, uint16_t size);
+hc_08_status hc_08_parse_aint(hc_08_ST *hc_08, uint16_t size);
+hc_08_status hc_08_parse_ctout(hc_08_ST *hc_08, uint16_t size);
+hc_08_status hc_08_parse_luuid(hc_08_ST *hc_08, uint16_t size);
+hc_08_status hc_08_parse_suuid(hc_08_ST *hc_08, uint16_t size);
+hc_08_status hc_08_parse_tuuid(hc_08_ST *hc_08, uint16_t size);
+hc_08_status hc_08_parse_aust(hc_08_ST *hc_08, uint16_t size);
+hc_08_status hc_08_parse_led(hc_08_ST *hc_08, uint16_t size);
+hc_08_status hc_08_parse_version(hc_08_ST *hc_08, uint16_t size);
+
+hc_08_view hc_08_view_rx(hc_08_ST *hc_08, uint16_t size);
+hc_08_status hc_08_view_value(hc_08_ST *hc_08, uint16_t size, hc_08_view *value);
+hc_08_status hc_08_view_field(hc_08_ST *hc_08, uint16_t size, const char *key, hc_08_view *value);
+hc_08_status hc_08_view_name(hc_08_ST *hc_08, uint16_t size, hc_08_view *name);
+const char *hc_08_view_search(const hc_08_view *view, const char *text);
+hc_08_status hc_08_view_lookup(const hc_08_view *view, const char * const *table, uint8_t table_size, uint8_t *index);
+hc_08_status hc_08_view_number(const hc_08_view *view, uint8_t base, uint16_t *result);
+uint16_t hc_08_view_copy(const hc_08_view *view, char *buff, uint16_t size);
+
+hc_08_decode hc_08_decode_dec(const char *data, uint16_t size, uint16_t *result);
+hc_08_decode hc_08_decode_hex(const char *data, uint16_t size, uint16_t *result);
+hc_08_decode hc_08_decode_addres(const char *data, uint16_t size, uint8_t *addres);
 
 void hc_08_status_connect_set(hc_08_ST *hc_08, hc_08_status_connect status_connect);
 hc_08_status_connect hc_08_status_connect_get(hc_08_ST *hc_08, hc_08_status_connect status_connect);
 void hc_08_clear_buff_tx(hc_08_ST *hc_08);
 void hc_08_clear_buff_rx(hc_08_ST *hc_08);
+void hc_08_param_invalidate(hc_08_ST *hc_08, hc_08_field field);
+hc_08_status hc_08_read_field(hc_08_ST *hc_08, hc_08_field field);
+hc_08_status hc_08_read_all(hc_08_ST *hc_08, uint32_t fields, uint8_t *round_trips);
+
+#endif /* HC_08_H */
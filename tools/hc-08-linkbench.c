@@ -0,0 +1,258 @@
+/*
+ * End-to-end link benchmark between two modules (hc-08-link.h). The driver sends numbered,
+ * timestamped frames; an echo peer sends them back and the driver reports RTT percentiles,
+ * goodput and losses, a sink peer only counts and reports goodput and sequence gaps.
+ *
+ * Without -d/-p both modules are emulated and linked (hc-08-pair.h), on a virtual clock:
+ * -c sets the connection interval of the master, -b the UART baud rate of both modules and
+ * -l the packets lost on the air per million. On hardware one host runs the peer on the
+ * slave (-p port) and the other the driver on the master (-d port), after both connected;
+ * -b is then only the baud rate of the host UART. RF power (AT+RFPM) is set on the modules
+ * beforehand, the emulated link has no notion of it.
+ *
+ * gcc -O2 -I../lib hc-08-linkbench.c ../lib/hc-08.c ../lib/hc-08-emu.c ../lib/hc-08-pair.c ../lib/hc-08-link.c ../lib/hc-08-posix.c -o hc-08-linkbench
+ * ./hc-08-linkbench [-m echo|sink] [-n frames] [-s payload] [-w window] [-r rate B/s]
+ *                   [-c cint] [-b baud] [-l loss ppm] [-d port | -p port]
+ */
+#define _DEFAULT_SOURCE
+#include "hc-08.h"
+#include "hc-08-emu.h"
+#include "hc-08-pair.h"
+#include "hc-08-link.h"
+#include "hc-08-posix.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define LINK_MAX_FRAMES     1000000
+#define LINK_IDLE_STEP_US   1000    // clock step of the emulated run while nothing is in flight
+#define LINK_PORT_TIMEOUT   1       // ms, hc_08_read_answer(...) must not hold the driver back
+
+static hc_08_pair_ST pair;
+
+static uint32_t link_clock_pair(void){
+  return (uint32_t)pair.time_us;
+}
+
+static uint32_t link_clock_monotonic(void){
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)((uint64_t)now.tv_sec * 1000000ULL + (uint64_t)now.tv_nsec / 1000);
+}
+
+static int link_lookup(const char * const *table, int size, const char *value){
+  for(int i = 0; i < size; i++){
+    if(strcmp(table[i], value) == 0){
+      return i;
+    }
+  }
+  return -1;
+}
+
+static void link_usage(const char *program){
+  fprintf(stderr, "usage: %s [-m echo|sink] [-n frames] [-s payload] [-w window] [-r rate B/s]\n"
+                  "          [-c cint] [-b baud] [-l loss ppm] [-d port | -p port]\n", program);
+  exit(2);
+}
+
+static void link_report_driver(hc_08_link_driver_ST *driver){
+  if(driver->mode == hc_08_link_mode_sink){
+    printf("frames     %u sent\n", driver->metrics.sent);
+    printf("offered    %u B/s\n", hc_08_link_driver_throughput(driver));
+  }else{
+    uint32_t p50 = hc_08_link_driver_percentile(driver, 500);
+    uint32_t p90 = hc_08_link_driver_percentile(driver, 900);
+    uint32_t p99 = hc_08_link_driver_percentile(driver, 990);
+    uint32_t max = hc_08_link_driver_percentile(driver, 1000);
+
+    printf("frames     %u sent, %u received, %u lost, %u late\n", driver->metrics.sent,
+           driver->metrics.received, driver->metrics.lost, driver->metrics.late);
+    printf("goodput    %u B/s\n", hc_08_link_driver_throughput(driver));
+    printf("rtt        p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+           p50 / 1000.0, p90 / 1000.0, p99 / 1000.0, max / 1000.0);
+  }
+}
+
+static void link_report_peer(hc_08_link_peer_ST *peer){
+  printf("peer       %u frames, %u missing, %u bad bytes\n", peer->metrics.frames,
+         peer->metrics.missing, peer->rx.bad);
+  printf("peer rate  %u B/s\n", hc_08_link_peer_throughput(peer));
+}
+
+/**
+  * @brief  Both modules emulated: the clock moves straight to the next packet that comes out
+  *         of a UART, or by LINK_IDLE_STEP_US while the driver waits for a timeout or its rate.
+  *         After the driver is done the clock keeps moving until no packet is left in flight,
+  *         so the peer gets everything the modules did not drop
+  */
+static int link_run_pair(hc_08_link_driver_ST *driver, uint16_t cint, hc_08_baud baud, uint32_t loss_ppm){
+  static hc_08_ST master, slave;
+  hc_08_link_peer_ST peer;
+  hc_08_link_mode mode = driver->mode;
+
+  hc_08_pair_init(&pair, &master, &slave);
+  for(uint8_t i = 0; i < 2; i++){
+    pair.side[i].emu.param.baud = baud;
+  }
+  pair.side[0].emu.param.cint_min = cint;
+  pair.side[0].emu.param.cint_max = cint;
+  pair.loss_ppm = loss_ppm;
+  hc_08_pair_connect(&pair);
+
+  driver->hc_08 = &master;
+  driver->clock_us = link_clock_pair;
+  hc_08_link_peer_init(&peer, &slave, mode, link_clock_pair);
+
+  for(;;){
+    uint8_t running = hc_08_link_driver_process(driver);
+    uint64_t next;
+
+    hc_08_link_peer_process(&peer);
+    next = hc_08_pair_next_us(&pair);
+    if(next == HC_08_PAIR_NEVER){
+      if(!running){
+        break;
+      }
+      next = pair.time_us + LINK_IDLE_STEP_US;
+    }
+    hc_08_pair_advance(&pair, next);
+  }
+
+  printf("link       cint %u (%u us), %s bps, loss %u ppm\n", cint, hc_08_pair_interval_us(&pair),
+         hc_08_baud_c[baud], loss_ppm);
+  printf("model      rtt %.2f ms, goodput %u B/s (one way)\n",
+         hc_08_emu_data_rtt_us(&pair.side[0].emu, driver->cfg.payload + HC_08_LINK_OVERHEAD) / 1000.0,
+         hc_08_emu_throughput(&pair.side[0].emu));
+  link_report_driver(driver);
+  link_report_peer(&peer);
+  printf("air        %u retransmits, %u bytes dropped by the modules\n",
+         pair.flow[0].stats.retransmits + pair.flow[1].stats.retransmits,
+         pair.flow[0].stats.dropped + pair.flow[1].stats.dropped);
+  return 0;
+}
+
+static int link_open(hc_08_posix_ST *port, hc_08_ST *hc_08, const char *path, hc_08_baud baud){
+  if(hc_08_posix_open(port, path, baud, hc_08_parity_bit_no_parity) != hc_08_status_ok){
+    fprintf(stderr, "%s: cannot open\n", path);
+    return -1;
+  }
+  port->rx_timeout = LINK_PORT_TIMEOUT;
+  port->rx_idle = LINK_PORT_TIMEOUT;
+  hc_08_posix_attach(port, hc_08);
+  return 0;
+}
+
+int main(int argc, char **argv){
+  static hc_08_link_driver_ST driver;
+  hc_08_link_mode mode = hc_08_link_mode_echo;
+  const char *driver_port = NULL, *peer_port = NULL;
+  hc_08_baud baud = hc_08_baud_9600bps;
+  uint32_t frames = 1000, loss_ppm = 0, rate = 0;
+  uint32_t payload = 20, window = 8;
+  uint16_t cint = 12;
+  uint32_t *samples;
+  int opt, index, result;
+
+  while((opt = getopt(argc, argv, "m:n:s:w:r:c:b:l:d:p:")) != -1){
+    switch(opt){
+    case 'm':
+      if(strcmp(optarg, "echo") == 0){
+        mode = hc_08_link_mode_echo;
+      }else if(strcmp(optarg, "sink") == 0){
+        mode = hc_08_link_mode_sink;
+      }else{
+        link_usage(argv[0]);
+      }
+      break;
+    case 'n':
+      frames = (uint32_t)atoi(optarg);
+      break;
+    case 's':
+      payload = (uint32_t)atoi(optarg);
+      break;
+    case 'w':
+      window = (uint32_t)atoi(optarg);
+      break;
+    case 'r':
+      rate = (uint32_t)atoi(optarg);
+      break;
+    case 'c':
+      cint = (uint16_t)atoi(optarg);
+      break;
+    case 'b':
+      if((index = link_lookup(hc_08_baud_c, HC_08_BAUD_SIZE, optarg)) < 0){
+        link_usage(argv[0]);
+      }
+      baud = (hc_08_baud)index;
+      break;
+    case 'l':
+      loss_ppm = (uint32_t)atoi(optarg);
+      break;
+    case 'd':
+      driver_port = optarg;
+      break;
+    case 'p':
+      peer_port = optarg;
+      break;
+    default:
+      link_usage(argv[0]);
+    }
+  }
+  if(frames < 1 || frames > LINK_MAX_FRAMES || payload > HC_08_LINK_PAYLOAD_MAX ||
+      window < 1 || window > HC_08_LINK_WINDOW_MAX || cint < HC_08_CINT_MIN || cint > HC_08_CINT_MAX ||
+      (driver_port != NULL && peer_port != NULL)){
+    link_usage(argv[0]);
+  }
+
+  if(peer_port != NULL){
+    static hc_08_ST hc_08;
+    hc_08_posix_ST port;
+    hc_08_link_peer_ST peer;
+    uint32_t reported = 0;
+
+    if(link_open(&port, &hc_08, peer_port, baud) != 0){
+      return 1;
+    }
+    hc_08_link_peer_init(&peer, &hc_08, mode, link_clock_monotonic);
+    for(;;){
+      hc_08_link_peer_process(&peer);
+      if(peer.metrics.frames != reported && link_clock_monotonic() - peer.metrics.last_us > 1000000){
+        link_report_peer(&peer);
+        reported = peer.metrics.frames;
+      }
+    }
+  }
+
+  samples = malloc(frames * sizeof(samples[0]));
+  if(samples == NULL){
+    return 1;
+  }
+  hc_08_link_driver_init(&driver, NULL, mode, link_clock_monotonic, samples, frames);
+  driver.cfg.payload = (uint8_t)payload;
+  driver.cfg.window = (uint8_t)window;
+  driver.cfg.frames = frames;
+  driver.cfg.rate = rate;
+
+  if(driver_port != NULL){
+    static hc_08_ST hc_08;
+    hc_08_posix_ST port;
+
+    if(link_open(&port, &hc_08, driver_port, baud) != 0){
+      free(samples);
+      return 1;
+    }
+    driver.hc_08 = &hc_08;
+    while(hc_08_link_driver_process(&driver)){
+    }
+    link_report_driver(&driver);
+    hc_08_posix_close(&port);
+    result = driver.metrics.lost ? 1 : 0;
+  }else{
+    result = link_run_pair(&driver, cint, baud, loss_ppm);
+  }
+  free(samples);
+  return result;
+}
@@ -0,0 +1,342 @@
+/*
+ * Capacity planning for the HC-08 link. Every combination of the given advertising
+ * intervals, connection intervals, supervision timeouts and baud rates is simulated on a
+ * pair of emulated modules (hc-08-pair.h): the settings are written with the library's
+ * AT commands, the modules connect, and the link benchmark (hc-08-link.h) measures the
+ * latency (one frame at a time) and the goodput (-w frames in flight). -f adds a fade of
+ * the given length after the latency run to see whether the link survives it (ctout) and
+ * how long reconnecting takes (aint). The simulation runs on a virtual clock, points are
+ * spread over -j threads, and the results are printed as CSV.
+ *
+ * gcc -O2 -I../lib hc-08-plan.c ../lib/hc-08.c ../lib/hc-08-emu.c ../lib/hc-08-pair.c ../lib/hc-08-link.c -lpthread -o hc-08-plan
+ * ./hc-08-plan [-a aint,...] [-c cint[:cint_max],...] [-t ctout,...] [-b baud,...]
+ *              [-s payload] [-n frames] [-w window] [-l loss ppm] [-f fade ms] [-j workers]
+ */
+#define _DEFAULT_SOURCE
+#include "hc-08.h"
+#include "hc-08-emu.h"
+#include "hc-08-pair.h"
+#include "hc-08-link.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#define PLAN_MAX_VALUES     32
+#define PLAN_MAX_WORKERS    64
+#define PLAN_IDLE_STEP_US   1000    // clock step while nothing is in flight
+#define PLAN_FADE_DELAY_US  100000  // from the end of the latency run to the fade
+
+typedef struct{
+  uint16_t aint;
+  uint16_t cint_min;
+  uint16_t cint_max;
+  uint16_t ctout;
+  hc_08_baud baud;
+
+  hc_08_status status;
+  uint32_t connect_us;
+  uint32_t rtt_p50;
+  uint32_t rtt_p99;
+  uint32_t goodput;
+  uint32_t lost;
+  uint32_t timeouts;
+  uint32_t reconnect_us;
+}plan_point;
+
+typedef struct{
+  uint16_t value[PLAN_MAX_VALUES];
+  uint16_t max[PLAN_MAX_VALUES];   // cint_max of a min:max range
+  uint8_t count;
+}plan_list_ST;
+
+static plan_list_ST aints, cints, ctouts, bauds;
+
+static plan_point *points;
+static uint32_t point_count;
+static atomic_uint next_point;
+static uint8_t payload = 20, window = 4;
+static uint32_t frames = 200, loss_ppm, fade_ms;
+
+static _Thread_local hc_08_pair_ST *plan_pair;
+
+static uint32_t plan_clock(void){
+  return (uint32_t)plan_pair->time_us;
+}
+
+/**
+  * @brief  Writing a setting through the library, as an application would
+  */
+static hc_08_status plan_set(hc_08_ST *hc_08, hc_08_status status){
+  if(status != hc_08_status_ok){
+    return status;
+  }
+  hc_08_read_answer(hc_08);
+  return hc_08_check_set(hc_08);
+}
+
+/**
+  * @brief  One benchmark run: the clock moves straight to the next event of the link, or
+  *         by PLAN_IDLE_STEP_US while the driver waits for a timeout
+  */
+static void plan_run(hc_08_pair_ST *pair, hc_08_link_driver_ST *driver, hc_08_link_peer_ST *peer){
+  for(;;){
+    uint8_t running = hc_08_link_driver_process(driver);
+    uint64_t next;
+
+    hc_08_link_peer_process(peer);
+    next = hc_08_pair_next_us(pair);
+    if(next == HC_08_PAIR_NEVER){
+      if(!running){
+        return;
+      }
+      next = pair->time_us + PLAN_IDLE_STEP_US;
+    }
+    hc_08_pair_advance(pair, next);
+  }
+}
+
+static void plan_point_run(plan_point *point, uint32_t *samples){
+  static _Thread_local hc_08_ST master, slave;
+  static _Thread_local hc_08_pair_ST pair;
+  hc_08_link_driver_ST driver;
+  hc_08_link_peer_ST peer;
+  hc_08_status status;
+
+  plan_pair = &pair;
+  hc_08_pair_init(&pair, &master, &slave);
+  status = plan_set(&slave, hc_08_cmd_set_aint(&slave, point->aint));
+  if(status == hc_08_status_ok){
+    status = plan_set(&master, hc_08_cmd_set_cint_min_max(&master, point->cint_min, point->cint_max));
+  }
+  if(status == hc_08_status_ok){
+    status = plan_set(&master, hc_08_cmd_set_ctout(&master, point->ctout));
+  }
+  for(uint8_t i = 0; i < 2 && status == hc_08_status_ok; i++){
+    hc_08_ST *hc_08 = i == 0 ? &master : &slave;
+
+    hc_08_cmd_set_uart_baud(hc_08, point->baud);
+    status = plan_set(hc_08, hc_08_status_ok);
+  }
+  point->status = status;
+  if(status != hc_08_status_ok){
+    return;
+  }
+
+  pair.reconnect = 1;
+  pair.loss_ppm = loss_ppm;
+  hc_08_pair_connect(&pair);
+  point->connect_us = (uint32_t)pair.stats.connect_us;
+
+  hc_08_link_driver_init(&driver, &master, hc_08_link_mode_echo, plan_clock, samples, frames);
+  driver.cfg.payload = payload;
+  driver.cfg.window = 1;
+  driver.cfg.frames = frames;
+  hc_08_link_peer_init(&peer, &slave, hc_08_link_mode_echo, plan_clock);
+  plan_run(&pair, &driver, &peer);
+  point->rtt_p50 = hc_08_link_driver_percentile(&driver, 500);
+  point->rtt_p99 = hc_08_link_driver_percentile(&driver, 990);
+  point->lost = driver.metrics.lost;
+
+  if(fade_ms > 0){
+    hc_08_pair_fade(&pair, pair.time_us + PLAN_FADE_DELAY_US, fade_ms * 1000);
+  }
+  hc_08_link_driver_init(&driver, &master, hc_08_link_mode_echo, plan_clock, NULL, 0);
+  driver.cfg.payload = payload;
+  driver.cfg.window = window;
+  driver.cfg.frames = frames;
+  hc_08_link_peer_init(&peer, &slave, hc_08_link_mode_echo, plan_clock);
+  plan_run(&pair, &driver, &peer);
+  point->goodput = hc_08_link_driver_throughput(&driver);
+  point->lost += driver.metrics.lost;
+  point->timeouts = pair.stats.timeouts;
+  point->reconnect_us = (uint32_t)pair.stats.connect_us - point->connect_us;
+}
+
+static void *plan_worker(void *arg){
+  uint32_t *samples = malloc(frames * sizeof(samples[0]));
+  uint32_t index;
+
+  (void)arg;
+  if(samples == NULL){
+    return NULL;
+  }
+  while((index = atomic_fetch_add(&next_point, 1)) < point_count){
+    plan_point_run(&points[index], samples);
+  }
+  free(samples);
+  return NULL;
+}
+
+/**
+  * @brief  Parsing a comma separated list of numbers or min:max ranges
+  */
+static int plan_list(const char *arg, uint16_t min, uint16_t max, plan_list_ST *list){
+  char *end;
+
+  list->count = 0;
+  do{
+    unsigned long value = strtoul(arg, &end, 10), high = value;
+
+    if(*end == ':'){
+      high = strtoul(end + 1, &end, 10);
+    }
+    if(end == arg || value < min || high > max || high < value || list->count == PLAN_MAX_VALUES ||
+        (*end != ',' && *end != '\0')){
+      return -1;
+    }
+    list->value[list->count] = (uint16_t)value;
+    list->max[list->count++] = (uint16_t)high;
+    arg = end + 1;
+  }while(*end == ',');
+  return 0;
+}
+
+static int plan_baud_list(char *arg){
+  char *value = strtok(arg, ",");
+
+  bauds.count = 0;
+  while(value != NULL){
+    int baud = -1;
+
+    for(int i = 0; i < HC_08_BAUD_SIZE; i++){
+      if(strcmp(hc_08_baud_c[i], value) == 0){
+        baud = i;
+      }
+    }
+    if(baud < 0 || bauds.count == PLAN_MAX_VALUES){
+      return -1;
+    }
+    bauds.value[bauds.count++] = (uint16_t)baud;
+    value = strtok(NULL, ",");
+  }
+  return 0;
+}
+
+static void plan_usage(const char *program){
+  fprintf(stderr, "usage: %s [-a aint,...] [-c cint[:cint_max],...] [-t ctout,...] [-b baud,...]\n"
+                  "          [-s payload] [-n frames] [-w window] [-l loss ppm] [-f fade ms] [-j workers]\n", program);
+  exit(2);
+}
+
+int main(int argc, char **argv){
+  static pthread_t threads[PLAN_MAX_WORKERS];
+  uint32_t worker_count = (uint32_t)sysconf(_SC_NPROCESSORS_ONLN);
+  struct timespec start, stop;
+  double elapsed;
+  int opt;
+
+  aints.value[0] = 320;
+  aints.count = 1;
+  cints.value[0] = 6;
+  cints.max[0] = 12;
+  cints.count = 1;
+  ctouts.value[0] = 200;
+  ctouts.count = 1;
+  bauds.value[0] = hc_08_baud_9600bps;
+  bauds.count = 1;
+  while((opt = getopt(argc, argv, "a:c:t:b:s:n:w:l:f:j:")) != -1){
+    switch(opt){
+    case 'a':
+      if(plan_list(optarg, HC_08_AINT_MIN, HC_08_AINT_MAX, &aints) != 0){
+        plan_usage(argv[0]);
+      }
+      break;
+    case 'c':
+      if(plan_list(optarg, HC_08_CINT_MIN, HC_08_CINT_MAX, &cints) != 0){
+        plan_usage(argv[0]);
+      }
+      break;
+    case 't':
+      if(plan_list(optarg, HC_08_CTOUT_MIN, HC_08_CTOUT_MAX, &ctouts) != 0){
+        plan_usage(argv[0]);
+      }
+      break;
+    case 'b':
+      if(plan_baud_list(optarg) != 0){
+        plan_usage(argv[0]);
+      }
+      break;
+    case 's':
+      payload = (uint8_t)atoi(optarg);
+      break;
+    case 'n':
+      frames = (uint32_t)atoi(optarg);
+      break;
+    case 'w':
+      window = (uint8_t)atoi(optarg);
+      break;
+    case 'l':
+      loss_ppm = (uint32_t)atoi(optarg);
+      break;
+    case 'f':
+      fade_ms = (uint32_t)atoi(optarg);
+      break;
+    case 'j':
+      worker_count = (uint32_t)atoi(optarg);
+      break;
+    default:
+      plan_usage(argv[0]);
+    }
+  }
+  if(payload > HC_08_LINK_PAYLOAD_MAX || frames < 1 || window < 1 || window > HC_08_LINK_WINDOW_MAX){
+    plan_usage(argv[0]);
+  }
+  if(worker_count < 1){
+    worker_count = 1;
+  }
+  if(worker_count > PLAN_MAX_WORKERS){
+    worker_count = PLAN_MAX_WORKERS;
+  }
+
+  point_count = (uint32_t)aints.count * cints.count * ctouts.count * bauds.count;
+  points = calloc(point_count, sizeof(points[0]));
+  if(points == NULL){
+    return 1;
+  }
+  for(uint32_t i = 0; i < point_count; i++){
+    uint32_t rest = i;
+
+    points[i].baud = (hc_08_baud)bauds.value[rest % bauds.count];
+    rest /= bauds.count;
+    points[i].ctout = ctouts.value[rest % ctouts.count];
+    rest /= ctouts.count;
+    points[i].cint_min = cints.value[rest % cints.count];
+    points[i].cint_max = cints.max[rest % cints.count];
+    rest /= cints.count;
+    points[i].aint = aints.value[rest];
+  }
+  if(worker_count > point_count){
+    worker_count = point_count;
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for(uint32_t w = 0; w < worker_count; w++){
+    pthread_create(&threads[w], NULL, plan_worker, NULL);
+  }
+  for(uint32_t w = 0; w < worker_count; w++){
+    pthread_join(threads[w], NULL);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &stop);
+  elapsed = (stop.tv_sec - start.tv_sec) + (stop.tv_nsec - start.tv_nsec) / 1e9;
+
+  printf("aint,cint_min,cint_max,ctout,baud,connect_ms,rtt_p50_ms,rtt_p99_ms,goodput_Bps,lost,timeouts,reconnect_ms\n");
+  for(uint32_t i = 0; i < point_count; i++){
+    plan_point *point = &points[i];
+
+    if(point->status != hc_08_status_ok){
+      printf("%u,%u,%u,%u,%s,error\n", point->aint, point->cint_min, point->cint_max, point->ctout,
+             hc_08_baud_c[point->baud]);
+      continue;
+    }
+    printf("%u,%u,%u,%u,%s,%.1f,%.2f,%.2f,%u,%u,%u,%.1f\n", point->aint, point->cint_min, point->cint_max,
+           point->ctout, hc_08_baud_c[point->baud], point->connect_us / 1000.0, point->rtt_p50 / 1000.0,
+           point->rtt_p99 / 1000.0, point->goodput, point->lost, point->timeouts, point->reconnect_us / 1000.0);
+  }
+  fprintf(stderr, "%u points in %.2f s on %u threads\n", point_count, elapsed, worker_count);
+  free(points);
+  return 0;
+}
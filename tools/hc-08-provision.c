@@ -0,0 +1,414 @@
+/*
+ * Factory provisioning station. Reads a batch of units (name,address per CSV line), writes
+ * role, name, address, UUIDs and baud rate to each unit with hc-08-provision.h and reads
+ * everything back through the parsers. Every worker thread drives one fixture; a fixture
+ * that runs out of units steals from the others, so slow units (retries, dropped answers)
+ * do not leave cores idle at the end of a batch.
+ *
+ * The fixtures are emulated modules (hc-08-emu.h). The time the emulator accounts for
+ * each exchange (UART bytes + firmware latency) is slept, multiplied by -s, so the
+ * throughput is close to a station with real modules; -s 0 measures the host side only.
+ *
+ * gcc -O2 -I../lib hc-08-provision.c ../lib/hc-08.c ../lib/hc-08-emu.c ../lib/hc-08-provision.c -lpthread -o hc-08-provision
+ * ./hc-08-provision [-j workers] [-r Master|Slave] [-b baud] [-p NONE|EVEN|ODD] [-u luuid:suuid:tuuid]
+ *                   [-s time scale] [-f drop %] [-R retries] [-n units] [batch.csv]
+ */
+#define _DEFAULT_SOURCE
+#include "hc-08.h"
+#include "hc-08-emu.h"
+#include "hc-08-provision.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#define PROV_MAX_WORKERS    64
+#define PROV_RX_TIMEOUT_US  100000  // what a dropped answer costs a real station
+#define PROV_LINE_SIZE      128
+#define PROV_MAX_RETRIES    (UINT8_MAX - 1)  // attempts (retries + 1) must fit the uint8_t counter
+
+typedef struct{
+  hc_08_provision_ST unit;
+  uint32_t line;
+  uint8_t attempts;
+  hc_08_status status;
+  hc_08_provision_step failed;
+}prov_job;
+
+typedef struct{
+  pthread_mutex_t lock;
+  uint32_t head;
+  uint32_t tail;
+}prov_deque;
+
+typedef struct{
+  hc_08_ST hc_08;
+  hc_08_emu_ST emu;
+  uint64_t slept_us;
+  uint32_t rng;
+  uint8_t dropped;
+}prov_fixture;
+
+typedef struct{
+  pthread_t thread;
+  uint32_t index;
+  prov_deque deque;
+  prov_fixture fixture;
+  uint32_t done;
+  uint32_t failed;
+  uint32_t retries;
+  uint32_t steals;
+}prov_worker;
+
+static prov_job *jobs;
+static uint32_t job_count;
+static prov_worker workers[PROV_MAX_WORKERS];
+static uint32_t worker_count;
+
+static double time_scale = 1.0;
+static uint32_t drop_percent;
+static uint8_t max_retries = 2;
+
+/* --- emulated fixture ----------------------------------------------------------------- */
+
+static void prov_sleep(prov_fixture *fixture){
+  uint64_t wait = (uint64_t)((fixture->emu.time_us - fixture->slept_us) * time_scale);
+  struct timespec ts = {.tv_sec = wait / 1000000, .tv_nsec = (wait % 1000000) * 1000};
+
+  fixture->slept_us = fixture->emu.time_us;
+  if(wait > 0){
+    nanosleep(&ts, NULL);
+  }
+}
+
+static void prov_tx(void *ctx, char *buff, uint16_t size){
+  prov_fixture *fixture = (prov_fixture *)ctx;
+
+  fixture->rng = fixture->rng * 1103515245 + 12345;
+  fixture->dropped = (fixture->rng >> 16) % 100 < drop_percent;
+  if(fixture->dropped){
+    fixture->emu.time_us += PROV_RX_TIMEOUT_US;
+    return;
+  }
+  hc_08_emu_tx(&fixture->emu, buff, size);
+}
+
+static uint16_t prov_rx(void *ctx, char *buff, uint16_t size){
+  prov_fixture *fixture = (prov_fixture *)ctx;
+  uint16_t count = fixture->dropped ? 0 : hc_08_emu_rx(&fixture->emu, buff, size);
+
+  prov_sleep(fixture);
+  return count;
+}
+
+/* a new unit is put into the fixture */
+static void prov_insert(prov_fixture *fixture){
+  hc_08_emu_init(&fixture->emu);
+  fixture->slept_us = 0;
+}
+
+/* --- work-stealing pool --------------------------------------------------------------- */
+
+static int prov_pop(prov_worker *worker, uint32_t *job){
+  int found = 0;
+
+  pthread_mutex_lock(&worker->deque.lock);
+  if(worker->deque.head < worker->deque.tail){
+    *job = --worker->deque.tail;
+    found = 1;
+  }
+  pthread_mutex_unlock(&worker->deque.lock);
+  return found;
+}
+
+static int prov_steal(prov_worker *thief, uint32_t *job){
+  for(uint32_t i = 1; i < worker_count; i++){
+    prov_worker *victim = &workers[(thief->index + i) % worker_count];
+    int found = 0;
+
+    pthread_mutex_lock(&victim->deque.lock);
+    if(victim->deque.head < victim->deque.tail){
+      *job = victim->deque.head++;
+      found = 1;
+    }
+    pthread_mutex_unlock(&victim->deque.lock);
+    if(found){
+      thief->steals++;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static void prov_run_job(prov_worker *worker, prov_job *job){
+  prov_fixture *fixture = &worker->fixture;
+
+  prov_insert(fixture);
+  for(job->attempts = 0; job->attempts <= max_retries; job->attempts++){
+    if(job->attempts > 0){
+      worker->retries++;
+    }
+    job->status = hc_08_provision_apply(&fixture->hc_08, &job->unit, &job->failed);
+    if(job->status == hc_08_status_ok){
+      job->status = hc_08_provision_verify(&fixture->hc_08, &job->unit, &job->failed);
+    }
+    if(job->status == hc_08_status_ok){
+      break;
+    }
+  }
+  if(job->status == hc_08_status_ok){
+    worker->done++;
+  }else{
+    worker->failed++;
+  }
+}
+
+static void *prov_worker_thread(void *arg){
+  prov_worker *worker = (prov_worker *)arg;
+  uint32_t job;
+
+  while(prov_pop(worker, &job) || prov_steal(worker, &job)){
+    prov_run_job(worker, &jobs[job]);
+  }
+  return NULL;
+}
+
+/* --- batch spec ----------------------------------------------------------------------- */
+
+static int prov_lookup(const char * const *table, int table_size, const char *value){
+  for(int i = 0; i < table_size; i++){
+    if(strcmp(table[i], value) == 0){
+      return i;
+    }
+  }
+  return -1;
+}
+
+static char *prov_trim(char *text){
+  char *end;
+
+  while(*text == ' ' || *text == '\t'){
+    text++;
+  }
+  end = text + strlen(text);
+  while(end > text && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r' || end[-1] == '\n')){
+    *--end = '\0';
+  }
+  return text;
+}
+
+static void prov_add(const hc_08_provision_ST *unit, uint32_t line){
+  static uint32_t capacity;
+
+  if(job_count == capacity){
+    capacity = capacity ? capacity * 2 : 256;
+    jobs = realloc(jobs, capacity * sizeof(jobs[0]));
+    if(jobs == NULL){
+      perror("realloc");
+      exit(1);
+    }
+  }
+  memset(&jobs[job_count], 0, sizeof(jobs[0]));
+  jobs[job_count].unit = *unit;
+  jobs[job_count].line = line;
+  job_count++;
+}
+
+static int prov_read_csv(const char *path, const hc_08_provision_ST *defaults){
+  FILE *file = fopen(path, "r");
+  char text[PROV_LINE_SIZE];
+  uint32_t line = 0;
+  int errors = 0;
+
+  if(file == NULL){
+    perror(path);
+    return -1;
+  }
+  while(fgets(text, sizeof(text), file) != NULL){
+    hc_08_provision_ST unit = *defaults;
+    char *name = prov_trim(text);
+    char *addres = strchr(name, ',');
+
+    line++;
+    if(*name == '\0' || *name == '#'){
+      continue;
+    }
+    if(addres != NULL){
+      *addres++ = '\0';
+      addres = prov_trim(addres);
+    }
+    name = prov_trim(name);
+    if(line == 1 && strcmp(name, "name") == 0){
+      continue;
+    }
+    if(addres == NULL || strlen(name) > HC_08_MAX_NAME_LENGHT ||
+        hc_08_provision_parse_addres(addres, unit.addres) != hc_08_status_ok){
+      fprintf(stderr, "%s:%u: expected name,address\n", path, line);
+      errors++;
+      continue;
+    }
+    strcpy(unit.name, name);
+    if(hc_08_provision_validate(&unit) != hc_08_status_ok){
+      fprintf(stderr, "%s:%u: invalid name \"%s\"\n", path, line, name);
+      errors++;
+      continue;
+    }
+    prov_add(&unit, line);
+  }
+  fclose(file);
+  return errors ? -1 : 0;
+}
+
+static void prov_generate(uint32_t count, const hc_08_provision_ST *defaults){
+  for(uint32_t i = 0; i < count; i++){
+    hc_08_provision_ST unit = *defaults;
+    uint64_t addres = 0xA4C138000000ULL + i;
+
+    snprintf(unit.name, sizeof(unit.name), "HC08-%06u", i % 1000000);
+    for(uint8_t b = 0; b < 6; b++){
+      unit.addres[b] = (uint8_t)(addres >> (40 - 8 * b));
+    }
+    prov_add(&unit, i + 1);
+  }
+}
+
+static void prov_usage(const char *program){
+  fprintf(stderr, "usage: %s [-j workers] [-r Master|Slave] [-b baud] [-p NONE|EVEN|ODD] [-u luuid:suuid:tuuid]\n"
+                  "          [-s time scale] [-f drop %%] [-R retries] [-n units] [batch.csv]\n", program);
+  exit(2);
+}
+
+int main(int argc, char **argv){
+  hc_08_provision_ST defaults = {
+    .role = hc_08_role_slave, .baud = hc_08_baud_9600bps, .parity = hc_08_parity_bit_no_parity,
+    .luuid = 0xFFF0, .suuid = 0xFFE0, .tuuid = 0xFFE1
+  };
+  uint32_t generate = 0;
+  struct timespec start, stop;
+  uint32_t done = 0, failed = 0, retries = 0, steals = 0;
+  double elapsed;
+  int opt, index;
+
+  worker_count = (uint32_t)sysconf(_SC_NPROCESSORS_ONLN);
+  while((opt = getopt(argc, argv, "j:r:b:p:u:s:f:R:n:")) != -1){
+    switch(opt){
+    case 'j':
+      worker_count = (uint32_t)atoi(optarg);
+      break;
+    case 'r':
+      if((index = prov_lookup(hc_08_role_c, 2, optarg)) < 0){
+        prov_usage(argv[0]);
+      }
+      defaults.role = (hc_08_role)index;
+      break;
+    case 'b':
+      if((index = prov_lookup(hc_08_baud_c, HC_08_BAUD_SIZE, optarg)) < 0){
+        prov_usage(argv[0]);
+      }
+      defaults.baud = (hc_08_baud)index;
+      break;
+    case 'p':
+      if((index = prov_lookup(hc_08_parity_bit_c, HC_08_PARITY_SIZE, optarg)) < 0){
+        prov_usage(argv[0]);
+      }
+      defaults.parity = (hc_08_parity_bit)index;
+      break;
+    case 'u':{
+      unsigned int luuid, suuid, tuuid;
+
+      if(sscanf(optarg, "%x:%x:%x", &luuid, &suuid, &tuuid) != 3 ||
+          luuid > 0xffff || suuid > 0xffff || tuuid > 0xffff){
+        prov_usage(argv[0]);
+      }
+      defaults.luuid = (uint16_t)luuid;
+      defaults.suuid = (uint16_t)suuid;
+      defaults.tuuid = (uint16_t)tuuid;
+      break;
+    }
+    case 's':
+      time_scale = atof(optarg);
+      break;
+    case 'f':
+      drop_percent = (uint32_t)atoi(optarg);
+      break;
+    case 'R':{
+      int retries = atoi(optarg);
+
+      if(retries < 0 || retries > PROV_MAX_RETRIES){
+        prov_usage(argv[0]);
+      }
+      max_retries = (uint8_t)retries;
+      break;
+    }
+    case 'n':
+      generate = (uint32_t)atoi(optarg);
+      break;
+    default:
+      prov_usage(argv[0]);
+    }
+  }
+  if(worker_count < 1){
+    worker_count = 1;
+  }
+  if(worker_count > PROV_MAX_WORKERS){
+    worker_count = PROV_MAX_WORKERS;
+  }
+
+  if(optind < argc){
+    if(prov_read_csv(argv[optind], &defaults) != 0){
+      return 1;
+    }
+  }else if(generate > 0){
+    prov_generate(generate, &defaults);
+  }else{
+    prov_usage(argv[0]);
+  }
+  if(job_count == 0){
+    fprintf(stderr, "no units in the batch\n");
+    return 1;
+  }
+
+  /* contiguous slices, the pool evens out the differences */
+  for(uint32_t w = 0; w < worker_count; w++){
+    prov_worker *worker = &workers[w];
+
+    worker->index = w;
+    pthread_mutex_init(&worker->deque.lock, NULL);
+    worker->deque.head = (uint32_t)((uint64_t)job_count * w / worker_count);
+    worker->deque.tail = (uint32_t)((uint64_t)job_count * (w + 1) / worker_count);
+    worker->fixture.rng = 0x9E3779B9u * (w + 1);
+    hc_08_reg_uart_cbfunc_ctx(&worker->fixture.hc_08, prov_tx, prov_rx, &worker->fixture);
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for(uint32_t w = 0; w < worker_count; w++){
+    pthread_create(&workers[w].thread, NULL, prov_worker_thread, &workers[w]);
+  }
+  for(uint32_t w = 0; w < worker_count; w++){
+    pthread_join(workers[w].thread, NULL);
+    done += workers[w].done;
+    failed += workers[w].failed;
+    retries += workers[w].retries;
+    steals += workers[w].steals;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &stop);
+  elapsed = (stop.tv_sec - start.tv_sec) + (stop.tv_nsec - start.tv_nsec) / 1e9;
+
+  for(uint32_t i = 0; i < job_count; i++){
+    if(jobs[i].status != hc_08_status_ok){
+      fprintf(stderr, "line %u %s: failed at %s after %u attempts\n", jobs[i].line, jobs[i].unit.name,
+              hc_08_provision_step_c[jobs[i].failed], jobs[i].attempts);
+    }
+  }
+  printf("workers    %u\n", worker_count);
+  printf("units      %u (%u ok, %u failed)\n", job_count, done, failed);
+  printf("retries    %u\n", retries);
+  printf("steals     %u\n", steals);
+  printf("time       %.2f s\n", elapsed);
+  printf("units/min  %.0f\n", elapsed > 0 ? done * 60.0 / elapsed : 0.0);
+
+  free(jobs);
+  return failed ? 1 : 0;
+}